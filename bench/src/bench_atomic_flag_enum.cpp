@@ -0,0 +1,134 @@
+//          Copyright Emil Fresk 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <algorithm>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <benchmark/benchmark.h>
+#include <esl/helpers/atomic_flag_enum.hpp>
+#include <esl/helpers/flag_enum.hpp>
+
+//
+// Status flags shared by all benchmark threads, each thread sets and clears
+// its own flag and polls the others. The atomic word against a flag_enum
+// behind a mutex, run with 1 to 8 threads to see the contention. The thread
+// count is capped at the number of cores, with one core only the uncontended
+// single thread runs are measured.
+//
+
+enum class status
+{
+  s0,
+  s1,
+  s2,
+  s3,
+  s4,
+  s5,
+  s6,
+  s7
+};
+
+static esl::atomic_flag_enum< status > atomic_flags;
+
+static esl::flag_enum< status > locked_flags;
+static std::mutex locked_mutex;
+
+static void bench_atomic(benchmark::State& state)
+{
+  const auto own = static_cast< status >(state.thread_index() % 8);
+
+  for (auto _ : state)
+  {
+    atomic_flags.set(own);
+    benchmark::DoNotOptimize(atomic_flags.any(status::s0, status::s7));
+    atomic_flags.clear(own);
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+
+static void bench_mutex(benchmark::State& state)
+{
+  const auto own = static_cast< status >(state.thread_index() % 8);
+
+  for (auto _ : state)
+  {
+    {
+      std::lock_guard< std::mutex > lock(locked_mutex);
+      locked_flags.set(own);
+    }
+    {
+      std::lock_guard< std::mutex > lock(locked_mutex);
+      benchmark::DoNotOptimize(locked_flags.any(status::s0, status::s7));
+    }
+    {
+      std::lock_guard< std::mutex > lock(locked_mutex);
+      locked_flags.clear(own);
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+
+// Several flags in one operation, a single fetch_or / fetch_and
+static void bench_atomic_multi(benchmark::State& state)
+{
+  for (auto _ : state)
+  {
+    atomic_flags.set(status::s1, status::s3, status::s5);
+    atomic_flags.clear(status::s1, status::s3, status::s5);
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+
+// A try-lock on one flag, all threads contend for the same bit
+static void bench_test_and_set(benchmark::State& state)
+{
+  for (auto _ : state)
+  {
+    if (!atomic_flags.test_and_set(status::s6))
+      atomic_flags.clear(status::s6);
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+
+static unsigned num_cores()
+{
+  return std::max(1u, std::thread::hardware_concurrency());
+}
+
+// 1, 2, 4 and 8 threads, as far as there are cores to run them in parallel
+static void contention_threads(benchmark::internal::Benchmark* b)
+{
+  const auto max_threads = std::min(8u, num_cores());
+
+  for (unsigned t = 1; t <= max_threads; t *= 2)
+    b->Threads(int(t));
+
+  b->UseRealTime();
+}
+
+BENCHMARK(bench_atomic)->Apply(contention_threads);
+BENCHMARK(bench_mutex)->Apply(contention_threads);
+BENCHMARK(bench_atomic_multi)->Apply(contention_threads);
+BENCHMARK(bench_test_and_set)->Apply(contention_threads);
+
+int main(int argc, char* argv[])
+{
+  if (num_cores() < 2)
+    std::printf(
+        "Only one core available, the contended runs are skipped and the "
+        "results are the uncontended cost\n");
+
+  benchmark::Initialize(&argc, argv);
+
+  if (benchmark::ReportUnrecognizedArguments(argc, argv))
+    return 1;
+
+  benchmark::RunSpecifiedBenchmarks();
+}
@@ -0,0 +1,353 @@
+//          Copyright Emil Fresk 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <random>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <esl/math/batch.hpp>
+#include <esl/parallel/thread_pool.hpp>
+
+constexpr std::size_t num_points = 1 << 20;
+
+struct cloud
+{
+  std::vector< esl::vector3f > aos;
+  std::vector< float > x, y, z;
+
+  cloud() : aos(num_points), x(num_points), y(num_points), z(num_points)
+  {
+    std::mt19937 gen(1234);
+    std::uniform_real_distribution< float > dist(-10.0f, 10.0f);
+
+    for (std::size_t i = 0; i < num_points; ++i)
+    {
+      aos[i] = esl::vector3f(dist(gen), dist(gen), dist(gen));
+      x[i] = aos[i][0];
+      y[i] = aos[i][1];
+      z[i] = aos[i][2];
+    }
+  }
+
+  esl::batch::soa_view< float, 3 > view()
+  {
+    return {{{x.data(), y.data(), z.data()}}, num_points};
+  }
+};
+
+static esl::quaternionf rotation()
+{
+  esl::quaternionf q(1, 2, 3, 4);
+  q.normalize();
+  return q;
+}
+
+static void bench_rotate_loop(benchmark::State& state)
+{
+  cloud c;
+  const auto q = rotation();
+
+  for (auto _ : state)
+  {
+    for (auto& v : c.aos)
+      v = q.rotate(v);
+
+    benchmark::ClobberMemory();
+  }
+
+  state.SetItemsProcessed(state.iterations() * num_points);
+}
+
+static void bench_rotate_aos(benchmark::State& state)
+{
+  cloud c;
+  const auto q = rotation();
+
+  for (auto _ : state)
+  {
+    esl::batch::rotate(q, c.aos.data(), c.aos.data(), num_points);
+    benchmark::ClobberMemory();
+  }
+
+  state.SetItemsProcessed(state.iterations() * num_points);
+}
+
+static void bench_rotate_soa(benchmark::State& state)
+{
+  cloud c;
+  const auto q = rotation();
+
+  for (auto _ : state)
+  {
+    esl::batch::rotate(q, c.view(), c.view());
+    benchmark::ClobberMemory();
+  }
+
+  state.SetItemsProcessed(state.iterations() * num_points);
+}
+
+static void bench_rotate_soa_parallel(benchmark::State& state)
+{
+  static esl::thread_pool<> pool;
+  cloud c;
+  const auto q = rotation();
+
+  for (auto _ : state)
+  {
+    esl::batch::rotate(pool, q, c.view(), c.view());
+    benchmark::ClobberMemory();
+  }
+
+  state.SetItemsProcessed(state.iterations() * num_points);
+}
+
+static void bench_normalize_loop(benchmark::State& state)
+{
+  cloud c;
+
+  for (auto _ : state)
+  {
+    for (auto& v : c.aos)
+      v.normalize();
+
+    benchmark::ClobberMemory();
+  }
+
+  state.SetItemsProcessed(state.iterations() * num_points);
+}
+
+static void bench_normalize_soa(benchmark::State& state)
+{
+  cloud c;
+
+  for (auto _ : state)
+  {
+    esl::batch::normalize(c.view());
+    benchmark::ClobberMemory();
+  }
+
+  state.SetItemsProcessed(state.iterations() * num_points);
+}
+
+static void bench_normalize_soa_fast(benchmark::State& state)
+{
+  cloud c;
+
+  for (auto _ : state)
+  {
+    esl::batch::normalize< esl::precision::fast >(c.view());
+    benchmark::ClobberMemory();
+  }
+
+  state.SetItemsProcessed(state.iterations() * num_points);
+}
+
+static void bench_normalize_soa_parallel(benchmark::State& state)
+{
+  static esl::thread_pool<> pool;
+  cloud c;
+
+  for (auto _ : state)
+  {
+    esl::batch::normalize(pool, c.view());
+    benchmark::ClobberMemory();
+  }
+
+  state.SetItemsProcessed(state.iterations() * num_points);
+}
+
+//
+// Attitudes of many bodies, small enough to stay in cache as in a per tick
+// update
+//
+constexpr std::size_t num_bodies = 4096;
+
+struct bodies
+{
+  std::vector< esl::quaternionf > aos;
+  std::vector< esl::vector3f > rates;
+  std::vector< float > x, y, z, w, wx, wy, wz;
+
+  explicit bodies(unsigned seed = 1234)
+      : aos(num_bodies), rates(num_bodies), x(num_bodies), y(num_bodies),
+        z(num_bodies), w(num_bodies), wx(num_bodies), wy(num_bodies),
+        wz(num_bodies)
+  {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution< float > dist(-1.0f, 1.0f);
+
+    for (std::size_t i = 0; i < num_bodies; ++i)
+    {
+      aos[i] = esl::quaternionf(dist(gen), dist(gen), dist(gen), dist(gen));
+      aos[i].normalize();
+      rates[i] = esl::vector3f(dist(gen), dist(gen), dist(gen));
+
+      x[i] = aos[i].x();
+      y[i] = aos[i].y();
+      z[i] = aos[i].z();
+      w[i] = aos[i].w();
+      wx[i] = rates[i][0];
+      wy[i] = rates[i][1];
+      wz[i] = rates[i][2];
+    }
+  }
+
+  esl::batch::soa_view< float, 4 > view()
+  {
+    return {{{x.data(), y.data(), z.data(), w.data()}}, num_bodies};
+  }
+
+  esl::batch::soa_view< float, 3 > rate_view()
+  {
+    return {{{wx.data(), wy.data(), wz.data()}}, num_bodies};
+  }
+};
+
+constexpr float dt = 0.001f;
+
+static void bench_integrate_loop(benchmark::State& state)
+{
+  bodies b;
+
+  for (auto _ : state)
+  {
+    for (std::size_t i = 0; i < num_bodies; ++i)
+      b.aos[i].integrate(b.rates[i], dt);
+
+    benchmark::ClobberMemory();
+  }
+
+  state.SetItemsProcessed(state.iterations() * num_bodies);
+}
+
+static void bench_integrate_soa(benchmark::State& state)
+{
+  bodies b;
+
+  for (auto _ : state)
+  {
+    esl::batch::integrate< float >(b.view(), b.rate_view(), dt);
+    benchmark::ClobberMemory();
+  }
+
+  state.SetItemsProcessed(state.iterations() * num_bodies);
+}
+
+static void bench_slerp_loop(benchmark::State& state)
+{
+  bodies a(1), b(2), out;
+
+  for (auto _ : state)
+  {
+    for (std::size_t i = 0; i < num_bodies; ++i)
+      out.aos[i] = esl::slerp(a.aos[i], b.aos[i], 0.3f);
+
+    benchmark::ClobberMemory();
+  }
+
+  state.SetItemsProcessed(state.iterations() * num_bodies);
+}
+
+static void bench_slerp_soa(benchmark::State& state)
+{
+  bodies a(1), b(2), out;
+
+  for (auto _ : state)
+  {
+    esl::batch::slerp< float >(a.view(), b.view(), 0.3f, out.view());
+    benchmark::ClobberMemory();
+  }
+
+  state.SetItemsProcessed(state.iterations() * num_bodies);
+}
+
+static void bench_nlerp_loop(benchmark::State& state)
+{
+  bodies a(1), b(2), out;
+
+  for (auto _ : state)
+  {
+    for (std::size_t i = 0; i < num_bodies; ++i)
+      out.aos[i] = esl::nlerp(a.aos[i], b.aos[i], 0.3f);
+
+    benchmark::ClobberMemory();
+  }
+
+  state.SetItemsProcessed(state.iterations() * num_bodies);
+}
+
+static void bench_nlerp_soa(benchmark::State& state)
+{
+  bodies a(1), b(2), out;
+
+  for (auto _ : state)
+  {
+    esl::batch::nlerp< float >(a.view(), b.view(), 0.3f, out.view());
+    benchmark::ClobberMemory();
+  }
+
+  state.SetItemsProcessed(state.iterations() * num_bodies);
+}
+
+static void bench_to_quaternion_loop(benchmark::State& state)
+{
+  bodies b;
+  std::vector< esl::matrix3f > m(num_bodies);
+
+  for (std::size_t i = 0; i < num_bodies; ++i)
+    m[i] = esl::rotation_matrix(b.aos[i]);
+
+  for (auto _ : state)
+  {
+    for (std::size_t i = 0; i < num_bodies; ++i)
+      b.aos[i] = esl::to_quaternion(m[i]);
+
+    benchmark::ClobberMemory();
+  }
+
+  state.SetItemsProcessed(state.iterations() * num_bodies);
+}
+
+static void bench_to_quaternion_soa(benchmark::State& state)
+{
+  bodies b;
+  std::vector< float > m[9];
+
+  for (auto& c : m)
+    c.resize(num_bodies);
+
+  esl::batch::soa_view< float, 9 > mv{
+      {{m[0].data(), m[1].data(), m[2].data(), m[3].data(), m[4].data(),
+        m[5].data(), m[6].data(), m[7].data(), m[8].data()}},
+      num_bodies};
+
+  esl::batch::rotation_matrix< float >(b.view(), mv);
+
+  for (auto _ : state)
+  {
+    esl::batch::to_quaternion< float >(mv, b.view());
+    benchmark::ClobberMemory();
+  }
+
+  state.SetItemsProcessed(state.iterations() * num_bodies);
+}
+
+BENCHMARK(bench_rotate_loop);
+BENCHMARK(bench_rotate_aos);
+BENCHMARK(bench_rotate_soa);
+BENCHMARK(bench_rotate_soa_parallel)->UseRealTime();
+BENCHMARK(bench_normalize_loop);
+BENCHMARK(bench_normalize_soa);
+BENCHMARK(bench_normalize_soa_fast);
+BENCHMARK(bench_normalize_soa_parallel)->UseRealTime();
+BENCHMARK(bench_integrate_loop);
+BENCHMARK(bench_integrate_soa);
+BENCHMARK(bench_slerp_loop);
+BENCHMARK(bench_slerp_soa);
+BENCHMARK(bench_nlerp_loop);
+BENCHMARK(bench_nlerp_soa);
+BENCHMARK(bench_to_quaternion_loop);
+BENCHMARK(bench_to_quaternion_soa);
+
+BENCHMARK_MAIN();
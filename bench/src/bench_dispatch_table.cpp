@@ -0,0 +1,145 @@
+//          Copyright Emil Fresk 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <functional>
+#include <random>
+#include <unordered_map>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <esl/callable/dispatch_table.hpp>
+
+constexpr int num_ids = 8;
+
+template < int I >
+int handle(int v)
+{
+  return v * (I + 1) + I;
+}
+
+int handle_unknown(int v)
+{
+  return -v;
+}
+
+// Message IDs from a fixed seed, including some without a handler
+std::vector< int > make_ids()
+{
+  std::mt19937 gen(42);
+  std::uniform_int_distribution< int > dist(0, num_ids);
+  std::vector< int > ids(4096);
+
+  for (auto& id : ids)
+    id = dist(gen);
+
+  return ids;
+}
+
+static void bench_dispatch_table(benchmark::State& state)
+{
+  using table = esl::dispatch_table< int, int(int), num_ids >;
+
+  constexpr auto t =
+      table::make< handle_unknown, table::handler< 0, handle< 0 > >,
+                   table::handler< 1, handle< 1 > >,
+                   table::handler< 2, handle< 2 > >,
+                   table::handler< 3, handle< 3 > >,
+                   table::handler< 4, handle< 4 > >,
+                   table::handler< 5, handle< 5 > >,
+                   table::handler< 6, handle< 6 > >,
+                   table::handler< 7, handle< 7 > > >();
+
+  const auto ids = make_ids();
+
+  for (auto _ : state)
+  {
+    int acc = 0;
+
+    for (auto id : ids)
+      acc += t(id, acc);
+
+    benchmark::DoNotOptimize(acc);
+  }
+
+  state.SetItemsProcessed(state.iterations() * ids.size());
+}
+
+static void bench_unordered_map(benchmark::State& state)
+{
+  const std::unordered_map< int, std::function< int(int) > > t{
+      {0, handle< 0 >}, {1, handle< 1 >}, {2, handle< 2 >},
+      {3, handle< 3 >}, {4, handle< 4 >}, {5, handle< 5 >},
+      {6, handle< 6 >}, {7, handle< 7 >}};
+
+  const auto ids = make_ids();
+
+  for (auto _ : state)
+  {
+    int acc = 0;
+
+    for (auto id : ids)
+    {
+      const auto it = t.find(id);
+      acc += (it != t.end()) ? it->second(acc) : handle_unknown(acc);
+    }
+
+    benchmark::DoNotOptimize(acc);
+  }
+
+  state.SetItemsProcessed(state.iterations() * ids.size());
+}
+
+static void bench_switch(benchmark::State& state)
+{
+  const auto ids = make_ids();
+
+  for (auto _ : state)
+  {
+    int acc = 0;
+
+    for (auto id : ids)
+    {
+      switch (id)
+      {
+        case 0:
+          acc += handle< 0 >(acc);
+          break;
+        case 1:
+          acc += handle< 1 >(acc);
+          break;
+        case 2:
+          acc += handle< 2 >(acc);
+          break;
+        case 3:
+          acc += handle< 3 >(acc);
+          break;
+        case 4:
+          acc += handle< 4 >(acc);
+          break;
+        case 5:
+          acc += handle< 5 >(acc);
+          break;
+        case 6:
+          acc += handle< 6 >(acc);
+          break;
+        case 7:
+          acc += handle< 7 >(acc);
+          break;
+        default:
+          acc += handle_unknown(acc);
+          break;
+      }
+    }
+
+    benchmark::DoNotOptimize(acc);
+  }
+
+  state.SetItemsProcessed(state.iterations() * ids.size());
+}
+
+BENCHMARK(bench_dispatch_table);
+BENCHMARK(bench_unordered_map);
+BENCHMARK(bench_switch);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,102 @@
+//          Copyright Emil Fresk 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <random>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <esl/math/fixed.hpp>
+#include <esl/math/quaternion.hpp>
+#include <esl/math/vector.hpp>
+
+//
+// The same math with float and Q16.16 elements, to check on the development
+// machine both the floating point build and the fixed-point build for cores
+// without an FPU. On x86 the float path has hardware support and the fixed
+// path is emulated with integer instructions, so the absolute numbers only
+// say something about the x86 build, the ratio is a rough guide.
+//
+
+// Small enough to stay in cache, to measure the arithmetic
+constexpr std::size_t num_vectors = 1024;
+
+template < typename T >
+static std::vector< esl::vector< T, 3 > > make_vectors()
+{
+  std::mt19937 gen(1234);
+  std::uniform_real_distribution< float > dist(-10.0f, 10.0f);
+  std::vector< esl::vector< T, 3 > > v(num_vectors);
+
+  for (auto& e : v)
+    e = esl::vector< T, 3 >{dist(gen), dist(gen), dist(gen)};
+
+  return v;
+}
+
+template < typename T >
+static void bench_normalize(benchmark::State& state)
+{
+  const auto a = make_vectors< T >();
+  auto b = a;
+
+  for (auto _ : state)
+  {
+    for (std::size_t i = 0; i < num_vectors; ++i)
+    {
+      b[i] = a[i];
+      b[i].normalize();
+    }
+
+    benchmark::ClobberMemory();
+  }
+
+  state.SetItemsProcessed(state.iterations() * num_vectors);
+}
+
+template < typename T >
+static void bench_rotate(benchmark::State& state)
+{
+  const auto a = make_vectors< T >();
+  auto b = a;
+
+  const esl::quaternion< T > q{0.5f, 0.5f, -0.5f, 0.5f};
+
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(&q);
+
+    for (std::size_t i = 0; i < num_vectors; ++i)
+      b[i] = q.rotate(a[i]);
+
+    benchmark::ClobberMemory();
+  }
+
+  state.SetItemsProcessed(state.iterations() * num_vectors);
+}
+
+template < typename T >
+static void bench_sqrt(benchmark::State& state)
+{
+  const auto a = make_vectors< T >();
+  std::vector< T > b(num_vectors);
+
+  for (auto _ : state)
+  {
+    for (std::size_t i = 0; i < num_vectors; ++i)
+      b[i] = esl::sqrt(esl::abs(a[i][0]));
+
+    benchmark::ClobberMemory();
+  }
+
+  state.SetItemsProcessed(state.iterations() * num_vectors);
+}
+
+BENCHMARK_TEMPLATE(bench_normalize, float);
+BENCHMARK_TEMPLATE(bench_normalize, esl::q16_16);
+BENCHMARK_TEMPLATE(bench_rotate, float);
+BENCHMARK_TEMPLATE(bench_rotate, esl::q16_16);
+BENCHMARK_TEMPLATE(bench_sqrt, float);
+BENCHMARK_TEMPLATE(bench_sqrt, esl::q16_16);
+
+BENCHMARK_MAIN();
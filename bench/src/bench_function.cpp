@@ -0,0 +1,151 @@
+//          Copyright Emil Fresk 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <functional>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <esl/callable/function.hpp>
+#include <esl/callable/function_view.hpp>
+
+//
+// Reference implementation of the previous esl::function layout, where the
+// full vtable (call, destroy, copy, move) is stored inline in every object.
+//
+template < typename, std::size_t Size = sizeof(void*) >
+class inline_vtable_function;
+
+template < typename Ret, typename... Args, std::size_t Size >
+class inline_vtable_function< Ret(Args...), Size >
+{
+  struct vtable
+  {
+    Ret (*call)(const void*, Args...);
+    void (*destroy)(const void*);
+    void (*copy)(void*, const void*);
+    void (*move)(void*, void*);
+  };
+
+  vtable vtable_;
+  std::aligned_storage_t< Size, alignof(void*) > storage_;
+
+public:
+  template < typename F >
+  explicit inline_vtable_function(F fun)
+      : vtable_{[](const void* f, Args... args) -> Ret {
+                  return (*static_cast< const F* >(f))(args...);
+                },
+                [](const void* f) { static_cast< const F* >(f)->~F(); },
+                [](void* dst, const void* src) {
+                  new (dst) F(*static_cast< const F* >(src));
+                },
+                [](void* dst, void* src) {
+                  new (dst) F(std::move(*static_cast< F* >(src)));
+                }}
+  {
+    new (&storage_) F(std::move(fun));
+  }
+
+  inline_vtable_function(const inline_vtable_function& other)
+      : vtable_(other.vtable_)
+  {
+    vtable_.copy(&storage_, &other.storage_);
+  }
+
+  ~inline_vtable_function()
+  {
+    vtable_.destroy(&storage_);
+  }
+
+  Ret operator()(Args... args) const
+  {
+    return vtable_.call(&storage_, args...);
+  }
+};
+
+//
+// Callback tables with a few different callables, so the indirect calls are
+// not trivially predicted
+//
+constexpr std::size_t table_size = 1024;
+
+template < typename Fun >
+std::vector< Fun > make_table()
+{
+  std::vector< Fun > table;
+  table.reserve(table_size);
+
+  for (std::size_t i = 0; i < table_size; ++i)
+  {
+    switch (i % 4)
+    {
+      case 0:
+        table.emplace_back([](int v) { return v + 1; });
+        break;
+      case 1:
+        table.emplace_back([](int v) { return v * 3; });
+        break;
+      case 2:
+        table.emplace_back([](int v) { return v - 7; });
+        break;
+      default:
+        table.emplace_back([](int v) { return v ^ 0x55; });
+        break;
+    }
+  }
+
+  return table;
+}
+
+template < typename Fun >
+static void bench_call(benchmark::State& state)
+{
+  const auto table = make_table< Fun >();
+
+  for (auto _ : state)
+  {
+    int acc = 0;
+
+    for (const auto& f : table)
+      acc += f(acc);
+
+    benchmark::DoNotOptimize(acc);
+  }
+
+  state.SetItemsProcessed(state.iterations() * table_size);
+  state.counters["bytes_per_callable"] = sizeof(Fun);
+}
+
+using esl_function = esl::function< int(int) >;
+using esl_function_view = esl::function_view< int(int) >;
+using inline_function = inline_vtable_function< int(int) >;
+using std_function = std::function< int(int) >;
+
+BENCHMARK_TEMPLATE(bench_call, esl_function);
+BENCHMARK_TEMPLATE(bench_call, inline_function);
+BENCHMARK_TEMPLATE(bench_call, esl_function_view);
+BENCHMARK_TEMPLATE(bench_call, std_function);
+
+//
+// Copying callables, e.g. when building a callback table
+//
+template < typename Fun >
+static void bench_copy(benchmark::State& state)
+{
+  const auto table = make_table< Fun >();
+
+  for (auto _ : state)
+  {
+    auto copy = table;
+    benchmark::DoNotOptimize(copy.data());
+  }
+
+  state.SetItemsProcessed(state.iterations() * table_size);
+}
+
+BENCHMARK_TEMPLATE(bench_copy, esl_function);
+BENCHMARK_TEMPLATE(bench_copy, inline_function);
+BENCHMARK_TEMPLATE(bench_copy, std_function);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,118 @@
+//          Copyright Emil Fresk 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <benchmark/benchmark.h>
+#include <esl/callable/function.hpp>
+#include <esl/callable/function_view.hpp>
+
+struct accumulator
+{
+  int state = 0;
+
+  int add(int v)
+  {
+    state += v;
+    benchmark::ClobberMemory();
+    return state;
+  }
+};
+
+static int global_state = 0;
+
+int add_global(int v)
+{
+  global_state += v;
+  benchmark::ClobberMemory();
+  return global_state;
+}
+
+constexpr int calls_per_iteration = 1024;
+
+template < typename Fun >
+static void run(benchmark::State& state, const Fun& fun)
+{
+  for (auto _ : state)
+  {
+    int acc = 0;
+
+    for (int i = 0; i < calls_per_iteration; ++i)
+      acc += fun(i);
+
+    benchmark::DoNotOptimize(acc);
+  }
+
+  state.SetItemsProcessed(state.iterations() * calls_per_iteration);
+}
+
+// Method bound as a template parameter, signature deduced
+static void bench_function_view_deduced(benchmark::State& state)
+{
+  accumulator a;
+  const auto fun = ESL_FUNCTION_VIEW_METHOD(&accumulator::add, a);
+
+  run(state, fun);
+}
+
+// Function bound as a template parameter, signature deduced
+static void bench_function_view_deduced_function(benchmark::State& state)
+{
+  const auto fun = ESL_FUNCTION_VIEW_FUNCTION(add_global);
+
+  run(state, fun);
+}
+
+// Runtime function pointer stored in the function_view
+static void bench_function_view_runtime_fptr(benchmark::State& state)
+{
+  const auto fun = esl::function_view< int(int) >::from(add_global);
+
+  run(state, fun);
+}
+
+// Baseline, direct function call
+static void bench_direct_function_call(benchmark::State& state)
+{
+  run(state, [](int v) { return add_global(v); });
+}
+
+// Runtime member pointer stored in the function
+static void bench_function_runtime_mptr(benchmark::State& state)
+{
+  using fun_type = esl::function< int(int), 3 * sizeof(void*) >;
+
+  accumulator a;
+  const auto fun = fun_type::from(a, &accumulator::add);
+
+  run(state, fun);
+}
+
+// Member pointer bound as a template parameter in the function
+static void bench_function_static_mptr(benchmark::State& state)
+{
+  using fun_type = esl::function< int(int) >;
+
+  accumulator a;
+  const auto fun = fun_type::from< accumulator, &accumulator::add >(a);
+
+  run(state, fun);
+}
+
+// Baseline, direct method call
+static void bench_direct_call(benchmark::State& state)
+{
+  accumulator a;
+
+  run(state, [&a](int v) { return a.add(v); });
+}
+
+BENCHMARK(bench_function_view_deduced);
+BENCHMARK(bench_function_runtime_mptr);
+BENCHMARK(bench_function_static_mptr);
+BENCHMARK(bench_direct_call);
+BENCHMARK(bench_function_view_deduced_function);
+BENCHMARK(bench_function_view_runtime_fptr);
+BENCHMARK(bench_direct_function_call);
+
+BENCHMARK_MAIN();
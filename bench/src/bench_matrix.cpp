@@ -0,0 +1,272 @@
+//          Copyright Emil Fresk 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <cmath>
+#include <random>
+#include <benchmark/benchmark.h>
+#include <esl/math/matrix.hpp>
+
+//
+// Kalman filter step of a constant velocity model with 6 states (position
+// and velocity) and 3 position measurements:
+//
+//   Predict: P = F P F^T + Q
+//   Update:  S = H P H^T + R, K = P H^T S^-1, P = (I - K H) P
+//
+// The naive version is the same math written as run-time loops over plain
+// arrays, as the filter code looked before esl::matrix. Each iteration starts
+// from the same covariance, iterating the filter decays the uncorrelated
+// terms into denormals which would dominate the timing.
+//
+constexpr std::size_t ns = 6;
+constexpr std::size_t nm = 3;
+constexpr double dt = 0.01;
+
+using state_matrix = esl::matrix< double, ns, ns >;
+using meas_matrix = esl::matrix< double, nm, ns >;
+
+static state_matrix make_covariance()
+{
+  std::mt19937 gen(1234);
+  std::uniform_real_distribution< double > dist(-1.0, 1.0);
+  state_matrix b;
+
+  for (std::size_t i = 0; i < ns; ++i)
+    for (std::size_t j = 0; j < ns; ++j)
+      b(i, j) = dist(gen);
+
+  return b * b.transpose() + state_matrix::identity();
+}
+
+static state_matrix make_transition()
+{
+  auto f = state_matrix::identity();
+
+  for (std::size_t i = 0; i < nm; ++i)
+    f(i, i + nm) = dt;
+
+  return f;
+}
+
+static meas_matrix make_measurement()
+{
+  meas_matrix h;
+
+  for (std::size_t i = 0; i < nm; ++i)
+    h(i, i) = 1.0;
+
+  return h;
+}
+
+static void bench_filter_step_esl(benchmark::State& state)
+{
+  const auto p0 = make_covariance();
+  const auto f = make_transition();
+  const auto h = make_measurement();
+  const auto q = 1e-4 * state_matrix::identity();
+  const auto r = 1e-2 * esl::matrix< double, nm, nm >::identity();
+  const auto id = state_matrix::identity();
+
+  for (auto _ : state)
+  {
+    auto p = f * p0 * f.transpose() + q;
+
+    const auto pht = p * h.transpose();
+    esl::matrix< double, nm, nm > s_inv;
+    esl::inverse_spd(h * pht + r, s_inv);
+
+    const auto k = pht * s_inv;
+    p = (id - k * h) * p;
+
+    benchmark::DoNotOptimize(p.data());
+    benchmark::ClobberMemory();
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+
+//
+// Naive reference, row-major arrays and triple loops
+//
+static void mul(const double* a, const double* b, double* c, std::size_t n,
+                std::size_t m, std::size_t k)
+{
+  for (std::size_t i = 0; i < n; ++i)
+    for (std::size_t j = 0; j < k; ++j)
+    {
+      double s = 0;
+
+      for (std::size_t l = 0; l < m; ++l)
+        s += a[i * m + l] * b[l * k + j];
+
+      c[i * k + j] = s;
+    }
+}
+
+static void transpose(const double* a, double* t, std::size_t n, std::size_t m)
+{
+  for (std::size_t i = 0; i < n; ++i)
+    for (std::size_t j = 0; j < m; ++j)
+      t[j * n + i] = a[i * m + j];
+}
+
+static void inverse(const double* a, double* inv, std::size_t n)
+{
+  double m[ns * ns * 2];
+
+  for (std::size_t i = 0; i < n; ++i)
+    for (std::size_t j = 0; j < n; ++j)
+    {
+      m[i * 2 * n + j] = a[i * n + j];
+      m[i * 2 * n + n + j] = (i == j) ? 1.0 : 0.0;
+    }
+
+  for (std::size_t c = 0; c < n; ++c)
+  {
+    std::size_t p = c;
+
+    for (std::size_t r = c + 1; r < n; ++r)
+      if (std::abs(m[r * 2 * n + c]) > std::abs(m[p * 2 * n + c]))
+        p = r;
+
+    for (std::size_t j = 0; j < 2 * n; ++j)
+      std::swap(m[p * 2 * n + j], m[c * 2 * n + j]);
+
+    const double d = m[c * 2 * n + c];
+
+    for (std::size_t j = 0; j < 2 * n; ++j)
+      m[c * 2 * n + j] /= d;
+
+    for (std::size_t r = 0; r < n; ++r)
+    {
+      if (r == c)
+        continue;
+
+      const double e = m[r * 2 * n + c];
+
+      for (std::size_t j = 0; j < 2 * n; ++j)
+        m[r * 2 * n + j] -= e * m[c * 2 * n + j];
+    }
+  }
+
+  for (std::size_t i = 0; i < n; ++i)
+    for (std::size_t j = 0; j < n; ++j)
+      inv[i * n + j] = m[i * 2 * n + n + j];
+}
+
+static void bench_filter_step_naive(benchmark::State& state)
+{
+  const auto p0 = make_covariance();
+  const auto f0 = make_transition();
+  const auto h0 = make_measurement();
+
+  double p[ns * ns], p_init[ns * ns], f[ns * ns], ft[ns * ns];
+  double h[nm * ns], ht[ns * nm];
+  double tmp[ns * ns], pht[ns * nm], s[nm * nm], s_inv[nm * nm];
+  double k[ns * nm], kh[ns * ns];
+
+  for (std::size_t i = 0; i < ns * ns; ++i)
+  {
+    p_init[i] = p0.data()[i];
+    f[i] = f0.data()[i];
+  }
+
+  for (std::size_t i = 0; i < nm * ns; ++i)
+    h[i] = h0.data()[i];
+
+  transpose(f, ft, ns, ns);
+  transpose(h, ht, nm, ns);
+
+  for (auto _ : state)
+  {
+    mul(f, p_init, tmp, ns, ns, ns);
+    mul(tmp, ft, p, ns, ns, ns);
+
+    for (std::size_t i = 0; i < ns; ++i)
+      p[i * ns + i] += 1e-4;
+
+    mul(p, ht, pht, ns, ns, nm);
+    mul(h, pht, s, nm, ns, nm);
+
+    for (std::size_t i = 0; i < nm; ++i)
+      s[i * nm + i] += 1e-2;
+
+    inverse(s, s_inv, nm);
+    mul(pht, s_inv, k, ns, nm, nm);
+    mul(k, h, kh, ns, nm, ns);
+
+    for (std::size_t i = 0; i < ns; ++i)
+      for (std::size_t j = 0; j < ns; ++j)
+        kh[i * ns + j] = ((i == j) ? 1.0 : 0.0) - kh[i * ns + j];
+
+    mul(kh, p, tmp, ns, ns, ns);
+
+    for (std::size_t i = 0; i < ns * ns; ++i)
+      p[i] = tmp[i];
+
+    benchmark::DoNotOptimize(p);
+    benchmark::ClobberMemory();
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+
+//
+// Single products
+//
+template < std::size_t N >
+static void bench_multiply_esl(benchmark::State& state)
+{
+  using M = esl::matrix< double, N, N >;
+  M a, b;
+
+  for (std::size_t i = 0; i < N * N; ++i)
+  {
+    a.data()[i] = std::sin(double(i));
+    b.data()[i] = std::cos(double(i));
+  }
+
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(a.data());
+    auto c = a * b;
+    benchmark::DoNotOptimize(c.data());
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+
+template < std::size_t N >
+static void bench_multiply_naive(benchmark::State& state)
+{
+  double a[N * N], b[N * N], c[N * N];
+
+  for (std::size_t i = 0; i < N * N; ++i)
+  {
+    a[i] = std::sin(double(i));
+    b[i] = std::cos(double(i));
+  }
+
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(a);
+    mul(a, b, c, N, N, N);
+    benchmark::DoNotOptimize(c);
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(bench_filter_step_esl);
+BENCHMARK(bench_filter_step_naive);
+
+BENCHMARK_TEMPLATE(bench_multiply_esl, 3);
+BENCHMARK_TEMPLATE(bench_multiply_naive, 3);
+BENCHMARK_TEMPLATE(bench_multiply_esl, 4);
+BENCHMARK_TEMPLATE(bench_multiply_naive, 4);
+BENCHMARK_TEMPLATE(bench_multiply_esl, 6);
+BENCHMARK_TEMPLATE(bench_multiply_naive, 6);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,157 @@
+//          Copyright Emil Fresk 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <esl/containers/packed_array.hpp>
+
+//
+// A table of 4M IDs in 0-1000: 10 bit packed (5 MB) against uint16_t
+// (8 MB), summed in order with get(), with unpack() through a small buffer
+// and as the plain array, and read at random indices.
+//
+
+constexpr std::size_t num_ids = std::size_t(1) << 22;
+
+using packed_ids = esl::packed_array< 10, num_ids >;
+
+static std::vector< std::uint16_t > make_ids()
+{
+  std::mt19937 gen(1234);
+  std::uniform_int_distribution< std::uint16_t > dist(0, 1000);
+  std::vector< std::uint16_t > v(num_ids);
+
+  for (auto& e : v)
+    e = dist(gen);
+
+  return v;
+}
+
+static std::unique_ptr< packed_ids > make_packed()
+{
+  const auto ids = make_ids();
+  auto p = std::make_unique< packed_ids >();
+
+  for (std::size_t i = 0; i < num_ids; ++i)
+    p->set(i, ids[i]);
+
+  return p;
+}
+
+static std::vector< std::size_t > make_indices()
+{
+  std::mt19937 gen(4321);
+  std::uniform_int_distribution< std::size_t > dist(0, num_ids - 1);
+  std::vector< std::size_t > v(4096);
+
+  for (auto& e : v)
+    e = dist(gen);
+
+  return v;
+}
+
+static void bench_sum_uint16(benchmark::State& state)
+{
+  const auto ids = make_ids();
+
+  for (auto _ : state)
+  {
+    std::uint64_t s = 0;
+
+    for (std::size_t i = 0; i < num_ids; ++i)
+      s += ids[i];
+
+    benchmark::DoNotOptimize(s);
+  }
+
+  state.SetItemsProcessed(state.iterations() * num_ids);
+}
+
+static void bench_sum_packed_get(benchmark::State& state)
+{
+  const auto ids = make_packed();
+
+  for (auto _ : state)
+  {
+    std::uint64_t s = 0;
+
+    for (std::size_t i = 0; i < num_ids; ++i)
+      s += ids->get(i);
+
+    benchmark::DoNotOptimize(s);
+  }
+
+  state.SetItemsProcessed(state.iterations() * num_ids);
+}
+
+static void bench_sum_packed_unpack(benchmark::State& state)
+{
+  const auto ids = make_packed();
+  std::uint16_t buf[256];
+
+  for (auto _ : state)
+  {
+    std::uint64_t s = 0;
+
+    for (std::size_t i = 0; i < num_ids; i += 256)
+    {
+      ids->unpack(i, 256, buf);
+
+      for (auto e : buf)
+        s += e;
+    }
+
+    benchmark::DoNotOptimize(s);
+  }
+
+  state.SetItemsProcessed(state.iterations() * num_ids);
+}
+
+static void bench_random_uint16(benchmark::State& state)
+{
+  const auto ids = make_ids();
+  const auto idx = make_indices();
+
+  for (auto _ : state)
+  {
+    std::uint64_t s = 0;
+
+    for (auto i : idx)
+      s += ids[i];
+
+    benchmark::DoNotOptimize(s);
+  }
+
+  state.SetItemsProcessed(state.iterations() * idx.size());
+}
+
+static void bench_random_packed(benchmark::State& state)
+{
+  const auto ids = make_packed();
+  const auto idx = make_indices();
+
+  for (auto _ : state)
+  {
+    std::uint64_t s = 0;
+
+    for (auto i : idx)
+      s += ids->get(i);
+
+    benchmark::DoNotOptimize(s);
+  }
+
+  state.SetItemsProcessed(state.iterations() * idx.size());
+}
+
+BENCHMARK(bench_sum_uint16);
+BENCHMARK(bench_sum_packed_get);
+BENCHMARK(bench_sum_packed_unpack);
+BENCHMARK(bench_random_uint16);
+BENCHMARK(bench_random_packed);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,154 @@
+//          Copyright Emil Fresk 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <array>
+#include <random>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <esl/math/quaternion.hpp>
+
+//
+// Single quaternion operations, the per-object path that batch.hpp does not
+// cover. There is no std quaternion, the reference is the same math
+// written out on std::array< float, 4 > (w, x, y, z) and
+// std::array< float, 3 >.
+//
+
+using std_quaternion = std::array< float, 4 >;
+using std_vector3 = std::array< float, 3 >;
+
+constexpr std::size_t num_quaternions = 1024;
+
+static std::vector< esl::quaternionf > make_quaternions()
+{
+  std::mt19937 gen(1234);
+  std::uniform_real_distribution< float > dist(-1.0f, 1.0f);
+  std::vector< esl::quaternionf > v;
+
+  for (std::size_t i = 0; i < num_quaternions; ++i)
+  {
+    esl::quaternionf q(dist(gen), dist(gen), dist(gen), dist(gen));
+    q.normalize();
+    v.push_back(q);
+  }
+
+  return v;
+}
+
+static std::vector< std_quaternion > to_std(
+    const std::vector< esl::quaternionf >& q)
+{
+  std::vector< std_quaternion > v;
+
+  for (const auto& e : q)
+    v.push_back({{e.w(), e.x(), e.y(), e.z()}});
+
+  return v;
+}
+
+static std_quaternion multiply(const std_quaternion& p,
+                               const std_quaternion& q)
+{
+  return {{p[0] * q[0] - p[1] * q[1] - p[2] * q[2] - p[3] * q[3],
+           p[0] * q[1] + p[1] * q[0] + p[2] * q[3] - p[3] * q[2],
+           p[0] * q[2] - p[1] * q[3] + p[2] * q[0] + p[3] * q[1],
+           p[0] * q[3] + p[1] * q[2] - p[2] * q[1] + p[3] * q[0]}};
+}
+
+// v + 2 w (u x v) + 2 u x (u x v), u the vector part
+static std_vector3 rotate(const std_quaternion& q, const std_vector3& v)
+{
+  const std_vector3 t{{2 * (q[2] * v[2] - q[3] * v[1]),
+                       2 * (q[3] * v[0] - q[1] * v[2]),
+                       2 * (q[1] * v[1] - q[2] * v[0])}};
+
+  return {{v[0] + q[0] * t[0] + q[2] * t[2] - q[3] * t[1],
+           v[1] + q[0] * t[1] + q[3] * t[0] - q[1] * t[2],
+           v[2] + q[0] * t[2] + q[1] * t[1] - q[2] * t[0]}};
+}
+
+// Composing the rotations in a chain
+static void bench_multiply_esl(benchmark::State& state)
+{
+  const auto qs = make_quaternions();
+
+  for (auto _ : state)
+  {
+    esl::quaternionf acc;
+
+    for (const auto& q : qs)
+      acc *= q;
+
+    benchmark::DoNotOptimize(acc);
+  }
+
+  state.SetItemsProcessed(state.iterations() * num_quaternions);
+}
+
+static void bench_multiply_std(benchmark::State& state)
+{
+  const auto qs = to_std(make_quaternions());
+
+  for (auto _ : state)
+  {
+    std_quaternion acc{{1, 0, 0, 0}};
+
+    for (const auto& q : qs)
+      acc = multiply(acc, q);
+
+    benchmark::DoNotOptimize(acc);
+  }
+
+  state.SetItemsProcessed(state.iterations() * num_quaternions);
+}
+
+// Rotating one vector by each quaternion
+static void bench_rotate_esl(benchmark::State& state)
+{
+  const auto qs = make_quaternions();
+  const esl::vector3f v(1, 2, 3);
+
+  for (auto _ : state)
+  {
+    esl::vector3f acc(0, 0, 0);
+
+    for (const auto& q : qs)
+      acc += q.rotate(v);
+
+    benchmark::DoNotOptimize(acc);
+  }
+
+  state.SetItemsProcessed(state.iterations() * num_quaternions);
+}
+
+static void bench_rotate_std(benchmark::State& state)
+{
+  const auto qs = to_std(make_quaternions());
+  const std_vector3 v{{1, 2, 3}};
+
+  for (auto _ : state)
+  {
+    std_vector3 acc{{0, 0, 0}};
+
+    for (const auto& q : qs)
+    {
+      const auto r = rotate(q, v);
+      acc[0] += r[0];
+      acc[1] += r[1];
+      acc[2] += r[2];
+    }
+
+    benchmark::DoNotOptimize(acc);
+  }
+
+  state.SetItemsProcessed(state.iterations() * num_quaternions);
+}
+
+BENCHMARK(bench_multiply_esl);
+BENCHMARK(bench_multiply_std);
+BENCHMARK(bench_rotate_esl);
+BENCHMARK(bench_rotate_std);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,133 @@
+//          Copyright Emil Fresk 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <queue>
+#include <random>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <esl/containers/allocate.hpp>
+#include <esl/containers/ring_buffer.hpp>
+
+//
+// Bursts of 1-64 values pushed and then popped, as a FIFO between an
+// interrupt and the main loop. The burst sizes are the same for all
+// containers.
+//
+
+constexpr std::size_t capacity = 128;
+constexpr std::size_t num_bursts = 1024;
+
+static std::vector< std::size_t > make_bursts()
+{
+  std::mt19937 gen(1234);
+  std::uniform_int_distribution< std::size_t > dist(1, 64);
+  std::vector< std::size_t > v(num_bursts);
+
+  for (auto& e : v)
+    e = dist(gen);
+
+  return v;
+}
+
+static std::size_t total(const std::vector< std::size_t >& bursts)
+{
+  std::size_t n = 0;
+
+  for (auto b : bursts)
+    n += b;
+
+  return n;
+}
+
+static void bench_ring_buffer(benchmark::State& state)
+{
+  const auto bursts = make_bursts();
+  esl::allocate< esl::ring_buffer< int >, capacity > buf;
+
+  for (auto _ : state)
+  {
+    int acc = 0;
+
+    for (auto n : bursts)
+    {
+      for (std::size_t i = 0; i < n; ++i)
+        buf.push_back(int(i));
+
+      for (std::size_t i = 0; i < n; ++i)
+      {
+        acc += buf.front();
+        buf.pop();
+      }
+    }
+
+    benchmark::DoNotOptimize(acc);
+  }
+
+  state.SetItemsProcessed(state.iterations() * total(bursts));
+}
+
+// The same with the array push_back, one or two memcpy per burst
+static void bench_ring_buffer_array(benchmark::State& state)
+{
+  const auto bursts = make_bursts();
+  esl::allocate< esl::ring_buffer< int >, capacity > buf;
+  int values[64];
+
+  for (int i = 0; i < 64; ++i)
+    values[i] = i;
+
+  for (auto _ : state)
+  {
+    int acc = 0;
+
+    for (auto n : bursts)
+    {
+      buf.push_back(values, n);
+
+      for (std::size_t i = 0; i < n; ++i)
+      {
+        acc += buf.front();
+        buf.pop();
+      }
+    }
+
+    benchmark::DoNotOptimize(acc);
+  }
+
+  state.SetItemsProcessed(state.iterations() * total(bursts));
+}
+
+static void bench_std_queue(benchmark::State& state)
+{
+  const auto bursts = make_bursts();
+  std::queue< int > q;
+
+  for (auto _ : state)
+  {
+    int acc = 0;
+
+    for (auto n : bursts)
+    {
+      for (std::size_t i = 0; i < n; ++i)
+        q.push(int(i));
+
+      for (std::size_t i = 0; i < n; ++i)
+      {
+        acc += q.front();
+        q.pop();
+      }
+    }
+
+    benchmark::DoNotOptimize(acc);
+  }
+
+  state.SetItemsProcessed(state.iterations() * total(bursts));
+}
+
+BENCHMARK(bench_ring_buffer);
+BENCHMARK(bench_ring_buffer_array);
+BENCHMARK(bench_std_queue);
+
+BENCHMARK_MAIN();
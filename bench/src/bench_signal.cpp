@@ -0,0 +1,64 @@
+//          Copyright Emil Fresk 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <functional>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <esl/containers/allocate.hpp>
+#include <esl/callable/signal.hpp>
+
+struct subscriber
+{
+  int state = 0;
+
+  void on_event(int v)
+  {
+    state += v;
+    benchmark::ClobberMemory();
+  }
+};
+
+constexpr std::size_t max_subscribers = 256;
+
+static void bench_emit_signal(benchmark::State& state)
+{
+  using sig_type = esl::signal< void(int) >;
+  using slot = sig_type::function_type;
+
+  std::vector< subscriber > subs(state.range(0));
+  esl::allocate< sig_type, max_subscribers > sig;
+
+  for (auto& s : subs)
+    sig.connect(slot::from< subscriber, &subscriber::on_event >(s));
+
+  for (auto _ : state)
+    sig.emit(1);
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void bench_emit_std_function(benchmark::State& state)
+{
+  std::vector< subscriber > subs(state.range(0));
+  std::vector< std::function< void(int) > > sig;
+
+  for (auto& s : subs)
+    sig.emplace_back([&s](int v) { s.on_event(v); });
+
+  for (auto _ : state)
+  {
+    for (const auto& f : sig)
+      f(1);
+  }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(bench_emit_signal)->RangeMultiplier(4)->Range(1, max_subscribers);
+BENCHMARK(bench_emit_std_function)
+    ->RangeMultiplier(4)
+    ->Range(1, max_subscribers);
+
+BENCHMARK_MAIN();
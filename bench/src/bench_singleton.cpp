@@ -0,0 +1,90 @@
+//          Copyright Emil Fresk 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <benchmark/benchmark.h>
+#include <esl/helpers/singleton.hpp>
+
+//
+// Cost of reading a field of a singleton, 1000 reads per iteration. The
+// constructor is not constexpr, so a function-local static needs its guard
+// variable.
+//
+
+struct config
+{
+  int value;
+
+  config() : value(42)
+  {
+  }
+};
+
+constexpr int reads = 1000;
+
+// A copy of the field, DoNotOptimize on the field itself would store it back
+static void read(const config& c)
+{
+  const int v = c.value;
+  benchmark::DoNotOptimize(v);
+}
+
+static void bench_meyers(benchmark::State& state)
+{
+  for (auto _ : state)
+    for (int i = 0; i < reads; ++i)
+      read(esl::get_singleton< config >());
+
+  state.SetItemsProcessed(state.iterations() * reads);
+}
+
+static void bench_static_singleton(benchmark::State& state)
+{
+  using s = esl::static_singleton< config >;
+
+  s::init();
+
+  for (auto _ : state)
+    for (int i = 0; i < reads; ++i)
+      read(s::get());
+
+  s::destroy();
+  state.SetItemsProcessed(state.iterations() * reads);
+}
+
+static config& local_thread_instance()
+{
+  thread_local config inst;
+  return inst;
+}
+
+static void bench_local_thread_local(benchmark::State& state)
+{
+  for (auto _ : state)
+    for (int i = 0; i < reads; ++i)
+      read(local_thread_instance());
+
+  state.SetItemsProcessed(state.iterations() * reads);
+}
+
+static void bench_thread_singleton(benchmark::State& state)
+{
+  using s = esl::thread_singleton< config >;
+
+  s::init();
+
+  for (auto _ : state)
+    for (int i = 0; i < reads; ++i)
+      read(s::get());
+
+  s::destroy();
+  state.SetItemsProcessed(state.iterations() * reads);
+}
+
+BENCHMARK(bench_meyers);
+BENCHMARK(bench_static_singleton);
+BENCHMARK(bench_local_thread_local);
+BENCHMARK(bench_thread_singleton);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,119 @@
+//          Copyright Emil Fresk 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <esl/containers/slot_allocator.hpp>
+
+//
+// A pool that is full except for 16 random free slots, each iteration
+// allocates the lowest free slot and frees it again. A linear search over
+// one flag per slot, the state before the bitmap allocator, against the
+// hierarchical bitmap, plain and lock-free.
+//
+
+constexpr std::size_t num_free = 16;
+
+static std::vector< std::size_t > free_slots(std::size_t n)
+{
+  std::mt19937 gen(1234);
+  std::uniform_int_distribution< std::size_t > dist(0, n - 1);
+  std::vector< std::size_t > s;
+
+  while (s.size() < num_free)
+  {
+    const auto i = dist(gen);
+
+    if (std::find(s.begin(), s.end(), i) == s.end())
+      s.push_back(i);
+  }
+
+  return s;
+}
+
+// Fills the pool and frees the chosen slots
+template < typename Allocator >
+static void prepare(Allocator& a)
+{
+  while (a.allocate() < a.capacity())
+    ;
+
+  for (auto i : free_slots(a.capacity()))
+    a.free(i);
+}
+
+template < std::size_t N >
+static void bench_linear(benchmark::State& state)
+{
+  std::vector< std::uint8_t > used(N, 1);
+
+  for (auto i : free_slots(N))
+    used[i] = 0;
+
+  for (auto _ : state)
+  {
+    std::size_t s = 0;
+
+    while (s < N && used[s])
+      ++s;
+
+    used[s] = 1;
+    benchmark::DoNotOptimize(s);
+    used[s] = 0;
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+
+template < std::size_t N >
+static void bench_bitmap(benchmark::State& state)
+{
+  auto a = std::make_unique< esl::slot_allocator< N > >();
+  prepare(*a);
+
+  for (auto _ : state)
+  {
+    const auto s = a->allocate();
+    benchmark::DoNotOptimize(s);
+    a->free(s);
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+
+template < std::size_t N >
+static void bench_atomic_bitmap(benchmark::State& state)
+{
+  auto a = std::make_unique< esl::atomic_slot_allocator< N > >();
+  prepare(*a);
+
+  for (auto _ : state)
+  {
+    const auto s = a->allocate();
+    benchmark::DoNotOptimize(s);
+    a->free(s);
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_TEMPLATE(bench_linear, 64);
+BENCHMARK_TEMPLATE(bench_bitmap, 64);
+BENCHMARK_TEMPLATE(bench_atomic_bitmap, 64);
+BENCHMARK_TEMPLATE(bench_linear, 4096);
+BENCHMARK_TEMPLATE(bench_bitmap, 4096);
+BENCHMARK_TEMPLATE(bench_atomic_bitmap, 4096);
+BENCHMARK_TEMPLATE(bench_linear, 65536);
+BENCHMARK_TEMPLATE(bench_bitmap, 65536);
+BENCHMARK_TEMPLATE(bench_atomic_bitmap, 65536);
+BENCHMARK_TEMPLATE(bench_linear, 1 << 20);
+BENCHMARK_TEMPLATE(bench_bitmap, 1 << 20);
+BENCHMARK_TEMPLATE(bench_atomic_bitmap, 1 << 20);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,246 @@
+//          Copyright Emil Fresk 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <cmath>
+#include <random>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <esl/math/span.hpp>
+#include <esl/parallel/thread_pool.hpp>
+
+//
+// The span kernels against the plain loops they replace, for a buffer in
+// cache (4k elements) and one in memory (1M elements)
+//
+
+static std::vector< float > make_data(std::size_t n, unsigned seed)
+{
+  std::mt19937 gen(seed);
+  std::uniform_real_distribution< float > dist(-1.0f, 1.0f);
+  std::vector< float > v(n);
+
+  for (auto& e : v)
+    e = dist(gen);
+
+  return v;
+}
+
+static esl::thread_pool<>& pool()
+{
+  static esl::thread_pool<> p;
+  return p;
+}
+
+static void bench_dot_loop(benchmark::State& state)
+{
+  const auto n = static_cast< std::size_t >(state.range(0));
+  const auto a = make_data(n, 1);
+  const auto b = make_data(n, 2);
+
+  for (auto _ : state)
+  {
+    float s = 0;
+
+    for (std::size_t i = 0; i < n; ++i)
+      s += a[i] * b[i];
+
+    benchmark::DoNotOptimize(s);
+  }
+
+  state.SetItemsProcessed(state.iterations() * n);
+}
+
+static void bench_dot_span(benchmark::State& state)
+{
+  const auto n = static_cast< std::size_t >(state.range(0));
+  const auto a = make_data(n, 1);
+  const auto b = make_data(n, 2);
+
+  for (auto _ : state)
+    benchmark::DoNotOptimize(esl::span::dot(a.data(), b.data(), n));
+
+  state.SetItemsProcessed(state.iterations() * n);
+}
+
+static void bench_dot_span_compensated(benchmark::State& state)
+{
+  const auto n = static_cast< std::size_t >(state.range(0));
+  const auto a = make_data(n, 1);
+  const auto b = make_data(n, 2);
+
+  for (auto _ : state)
+    benchmark::DoNotOptimize(
+        esl::span::dot< esl::precision::compensated<> >(a.data(), b.data(),
+                                                          n));
+
+  state.SetItemsProcessed(state.iterations() * n);
+}
+
+static void bench_dot_span_parallel(benchmark::State& state)
+{
+  const auto n = static_cast< std::size_t >(state.range(0));
+  const auto a = make_data(n, 1);
+  const auto b = make_data(n, 2);
+
+  for (auto _ : state)
+    benchmark::DoNotOptimize(esl::span::dot(pool(), a.data(), b.data(), n));
+
+  state.SetItemsProcessed(state.iterations() * n);
+}
+
+static void bench_sum_loop(benchmark::State& state)
+{
+  const auto n = static_cast< std::size_t >(state.range(0));
+  const auto a = make_data(n, 1);
+
+  for (auto _ : state)
+  {
+    float s = 0;
+
+    for (std::size_t i = 0; i < n; ++i)
+      s += a[i];
+
+    benchmark::DoNotOptimize(s);
+  }
+
+  state.SetItemsProcessed(state.iterations() * n);
+}
+
+static void bench_sum_span(benchmark::State& state)
+{
+  const auto n = static_cast< std::size_t >(state.range(0));
+  const auto a = make_data(n, 1);
+
+  for (auto _ : state)
+    benchmark::DoNotOptimize(esl::span::sum(a.data(), n));
+
+  state.SetItemsProcessed(state.iterations() * n);
+}
+
+static void bench_norm_loop(benchmark::State& state)
+{
+  const auto n = static_cast< std::size_t >(state.range(0));
+  const auto a = make_data(n, 1);
+
+  for (auto _ : state)
+  {
+    float s = 0;
+
+    for (std::size_t i = 0; i < n; ++i)
+      s += a[i] * a[i];
+
+    benchmark::DoNotOptimize(std::sqrt(s));
+  }
+
+  state.SetItemsProcessed(state.iterations() * n);
+}
+
+static void bench_norm_span(benchmark::State& state)
+{
+  const auto n = static_cast< std::size_t >(state.range(0));
+  const auto a = make_data(n, 1);
+
+  for (auto _ : state)
+    benchmark::DoNotOptimize(esl::span::norm(a.data(), n));
+
+  state.SetItemsProcessed(state.iterations() * n);
+}
+
+static void bench_axpy_loop(benchmark::State& state)
+{
+  const auto n = static_cast< std::size_t >(state.range(0));
+  const auto x = make_data(n, 1);
+  auto y = make_data(n, 2);
+
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(y.data());
+
+    for (std::size_t i = 0; i < n; ++i)
+      y[i] += 1e-3f * x[i];
+
+    benchmark::ClobberMemory();
+  }
+
+  state.SetItemsProcessed(state.iterations() * n);
+}
+
+static void bench_axpy_span(benchmark::State& state)
+{
+  const auto n = static_cast< std::size_t >(state.range(0));
+  const auto x = make_data(n, 1);
+  auto y = make_data(n, 2);
+
+  for (auto _ : state)
+  {
+    esl::span::axpy(1e-3f, x.data(), y.data(), n);
+    benchmark::ClobberMemory();
+  }
+
+  state.SetItemsProcessed(state.iterations() * n);
+}
+
+static void bench_axpy_span_parallel(benchmark::State& state)
+{
+  const auto n = static_cast< std::size_t >(state.range(0));
+  const auto x = make_data(n, 1);
+  auto y = make_data(n, 2);
+
+  for (auto _ : state)
+  {
+    esl::span::axpy(pool(), 1e-3f, x.data(), y.data(), n);
+    benchmark::ClobberMemory();
+  }
+
+  state.SetItemsProcessed(state.iterations() * n);
+}
+
+static void bench_scale_loop(benchmark::State& state)
+{
+  const auto n = static_cast< std::size_t >(state.range(0));
+  auto x = make_data(n, 1);
+
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(x.data());
+
+    for (std::size_t i = 0; i < n; ++i)
+      x[i] *= -1.0f;
+
+    benchmark::ClobberMemory();
+  }
+
+  state.SetItemsProcessed(state.iterations() * n);
+}
+
+static void bench_scale_span(benchmark::State& state)
+{
+  const auto n = static_cast< std::size_t >(state.range(0));
+  auto x = make_data(n, 1);
+
+  for (auto _ : state)
+  {
+    esl::span::scale(-1.0f, x.data(), n);
+    benchmark::ClobberMemory();
+  }
+
+  state.SetItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK(bench_dot_loop)->Arg(4096)->Arg(1 << 20);
+BENCHMARK(bench_dot_span)->Arg(4096)->Arg(1 << 20);
+BENCHMARK(bench_dot_span_compensated)->Arg(4096)->Arg(1 << 20);
+BENCHMARK(bench_dot_span_parallel)->Arg(1 << 20)->UseRealTime();
+BENCHMARK(bench_sum_loop)->Arg(4096)->Arg(1 << 20);
+BENCHMARK(bench_sum_span)->Arg(4096)->Arg(1 << 20);
+BENCHMARK(bench_norm_loop)->Arg(4096)->Arg(1 << 20);
+BENCHMARK(bench_norm_span)->Arg(4096)->Arg(1 << 20);
+BENCHMARK(bench_axpy_loop)->Arg(4096)->Arg(1 << 20);
+BENCHMARK(bench_axpy_span)->Arg(4096)->Arg(1 << 20);
+BENCHMARK(bench_axpy_span_parallel)->Arg(1 << 20)->UseRealTime();
+BENCHMARK(bench_scale_loop)->Arg(4096)->Arg(1 << 20);
+BENCHMARK(bench_scale_span)->Arg(4096)->Arg(1 << 20);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,109 @@
+//          Copyright Emil Fresk 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <random>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <esl/containers/allocate.hpp>
+#include <esl/containers/static_vector.hpp>
+
+//
+// static_vector against a std::vector with the same capacity reserved up
+// front: filling and clearing, and erasing from random positions. The
+// positions come from a fixed seed and are the same for both.
+//
+
+constexpr std::size_t capacity = 1024;
+
+static std::vector< std::size_t > make_positions()
+{
+  std::mt19937 gen(1234);
+  std::vector< std::size_t > v;
+
+  // One erase for each size from capacity down to 1
+  for (std::size_t n = capacity; n > 0; --n)
+    v.push_back(std::uniform_int_distribution< std::size_t >(0, n - 1)(gen));
+
+  return v;
+}
+
+static void bench_fill_static_vector(benchmark::State& state)
+{
+  esl::allocate< esl::static_vector< int >, capacity > v;
+
+  for (auto _ : state)
+  {
+    for (std::size_t i = 0; i < capacity; ++i)
+      v.push_back(int(i));
+
+    benchmark::DoNotOptimize(v.data());
+    v.clear();
+  }
+
+  state.SetItemsProcessed(state.iterations() * capacity);
+}
+
+static void bench_fill_std_vector(benchmark::State& state)
+{
+  std::vector< int > v;
+  v.reserve(capacity);
+
+  for (auto _ : state)
+  {
+    for (std::size_t i = 0; i < capacity; ++i)
+      v.push_back(int(i));
+
+    benchmark::DoNotOptimize(v.data());
+    v.clear();
+  }
+
+  state.SetItemsProcessed(state.iterations() * capacity);
+}
+
+static void bench_erase_static_vector(benchmark::State& state)
+{
+  const auto positions = make_positions();
+  esl::allocate< esl::static_vector< int >, capacity > v;
+
+  for (auto _ : state)
+  {
+    for (std::size_t i = 0; i < capacity; ++i)
+      v.push_back(int(i));
+
+    for (auto p : positions)
+      v.erase(v.begin() + p, v.begin() + p + 1);
+
+    benchmark::DoNotOptimize(v.data());
+  }
+
+  state.SetItemsProcessed(state.iterations() * capacity);
+}
+
+static void bench_erase_std_vector(benchmark::State& state)
+{
+  const auto positions = make_positions();
+  std::vector< int > v;
+  v.reserve(capacity);
+
+  for (auto _ : state)
+  {
+    for (std::size_t i = 0; i < capacity; ++i)
+      v.push_back(int(i));
+
+    for (auto p : positions)
+      v.erase(v.begin() + p);
+
+    benchmark::DoNotOptimize(v.data());
+  }
+
+  state.SetItemsProcessed(state.iterations() * capacity);
+}
+
+BENCHMARK(bench_fill_static_vector);
+BENCHMARK(bench_fill_std_vector);
+BENCHMARK(bench_erase_static_vector);
+BENCHMARK(bench_erase_std_vector);
+
+BENCHMARK_MAIN();
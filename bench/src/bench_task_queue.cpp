@@ -0,0 +1,70 @@
+//          Copyright Emil Fresk 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <deque>
+#include <functional>
+#include <benchmark/benchmark.h>
+#include <esl/callable/task.hpp>
+#include <esl/containers/allocate.hpp>
+#include <esl/containers/task_queue.hpp>
+
+constexpr std::size_t batch_size = 64;
+
+// Captures 3 pointers, too large for the small buffer of most std::function
+struct work
+{
+  int* a;
+  int* b;
+  int* c;
+
+  void operator()() const
+  {
+    *a += *b + *c;
+  }
+};
+
+static void bench_task_queue(benchmark::State& state)
+{
+  esl::allocate< esl::task_queue< esl::task<> >, batch_size * 2 > q;
+  int a = 0, b = 1, c = 2;
+
+  for (auto _ : state)
+  {
+    for (std::size_t i = 0; i < batch_size; ++i)
+      q.emplace_back(work{&a, &b, &c});
+
+    q.drain();
+    benchmark::DoNotOptimize(a);
+  }
+
+  state.SetItemsProcessed(state.iterations() * batch_size);
+}
+
+static void bench_std_deque(benchmark::State& state)
+{
+  std::deque< std::function< void() > > q;
+  int a = 0, b = 1, c = 2;
+
+  for (auto _ : state)
+  {
+    for (std::size_t i = 0; i < batch_size; ++i)
+      q.emplace_back(work{&a, &b, &c});
+
+    while (!q.empty())
+    {
+      q.front()();
+      q.pop_front();
+    }
+
+    benchmark::DoNotOptimize(a);
+  }
+
+  state.SetItemsProcessed(state.iterations() * batch_size);
+}
+
+BENCHMARK(bench_task_queue);
+BENCHMARK(bench_std_deque);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,83 @@
+//          Copyright Emil Fresk 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <cmath>
+#include <future>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <esl/parallel/thread_pool.hpp>
+
+constexpr std::size_t num_items = 1 << 16;
+
+// A small amount of work per index, the interesting part is the overhead of
+// distributing fine-grained chunks
+static void kernel(std::vector< float >& v, std::size_t i)
+{
+  v[i] = std::sqrt(v[i] * v[i] + 1.0f);
+}
+
+static void bench_serial(benchmark::State& state)
+{
+  std::vector< float > v(num_items, 1.0f);
+
+  for (auto _ : state)
+  {
+    for (std::size_t i = 0; i < num_items; ++i)
+      kernel(v, i);
+
+    benchmark::ClobberMemory();
+  }
+
+  state.SetItemsProcessed(state.iterations() * num_items);
+}
+
+static void bench_thread_pool(benchmark::State& state)
+{
+  static esl::thread_pool<> pool;
+
+  const auto grain = static_cast< std::size_t >(state.range(0));
+  std::vector< float > v(num_items, 1.0f);
+
+  for (auto _ : state)
+  {
+    pool.parallel_for(0, num_items, grain,
+                      [&v](std::size_t i) { kernel(v, i); });
+    benchmark::ClobberMemory();
+  }
+
+  state.SetItemsProcessed(state.iterations() * num_items);
+}
+
+static void bench_std_async(benchmark::State& state)
+{
+  const auto grain = static_cast< std::size_t >(state.range(0));
+  std::vector< float > v(num_items, 1.0f);
+  std::vector< std::future< void > > futures;
+
+  for (auto _ : state)
+  {
+    for (std::size_t b = 0; b < num_items; b += grain)
+    {
+      futures.push_back(std::async(std::launch::async, [&v, b, grain] {
+        for (std::size_t i = b; i < b + grain; ++i)
+          kernel(v, i);
+      }));
+    }
+
+    for (auto& f : futures)
+      f.wait();
+
+    futures.clear();
+    benchmark::ClobberMemory();
+  }
+
+  state.SetItemsProcessed(state.iterations() * num_items);
+}
+
+BENCHMARK(bench_serial);
+BENCHMARK(bench_thread_pool)->RangeMultiplier(8)->Range(64, 8192)->UseRealTime();
+BENCHMARK(bench_std_async)->RangeMultiplier(8)->Range(512, 8192)->UseRealTime();
+
+BENCHMARK_MAIN();
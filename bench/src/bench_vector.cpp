@@ -0,0 +1,397 @@
+//          Copyright Emil Fresk 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <array>
+#include <random>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <esl/math/precision.hpp>
+#include <esl/math/simd.hpp>
+#include <esl/math/vector.hpp>
+
+// Built as bench_vector with the scalar esl::vector and as bench_vector_simd
+// with ESL_ENABLE_SIMD defined, so the bench_vector_* results of the two
+// compare what users get from the operators with the backend off and on.
+// The bench_kernel_* results call the SIMD kernels directly in both.
+
+constexpr std::size_t num_vectors = 1 << 20;
+
+// Small enough to stay in cache, to measure the arithmetic
+constexpr std::size_t num_cached_vectors = 1024;
+
+template < typename V >
+static std::vector< V > make_vectors(std::size_t n = num_vectors)
+{
+  std::mt19937 gen(1234);
+  std::uniform_real_distribution< double > dist(-1.0, 1.0);
+  std::vector< V > v(n);
+
+  for (auto& e : v)
+    for (int i = 0; i < int(sizeof(V) / sizeof(e[0])); ++i)
+      e[i] = static_cast< std::remove_reference_t< decltype(e[0]) > >(
+          dist(gen));
+
+  return v;
+}
+
+template < typename T, std::size_t N >
+static void bench_vector_add_assign(benchmark::State& state)
+{
+  using V = esl::vector< T, N >;
+  const auto a = make_vectors< V >();
+  auto b = make_vectors< V >();
+
+  for (auto _ : state)
+  {
+    for (std::size_t i = 0; i < num_vectors; ++i)
+      b[i] += a[i];
+
+    benchmark::ClobberMemory();
+  }
+
+  state.SetItemsProcessed(state.iterations() * num_vectors);
+}
+
+template < typename T, std::size_t N >
+static void bench_kernel_add(benchmark::State& state)
+{
+  using V = esl::vector< T, N >;
+  const auto a = make_vectors< V >();
+  auto b = make_vectors< V >();
+
+  for (auto _ : state)
+  {
+    for (std::size_t i = 0; i < num_vectors; ++i)
+      esl::simd::ops< T, N >::add(b[i].data(), b[i].data(), a[i].data());
+
+    benchmark::ClobberMemory();
+  }
+
+  state.SetItemsProcessed(state.iterations() * num_vectors);
+}
+
+//
+// The esl::vector operators, c = op(a, b) over in-cache vectors
+//
+template < typename T, std::size_t N, typename Op >
+static void run_vector_op(benchmark::State& state, Op&& op)
+{
+  using V = esl::vector< T, N >;
+  const auto a = make_vectors< V >(num_cached_vectors);
+  const auto b = make_vectors< V >(num_cached_vectors);
+  auto c = make_vectors< V >(num_cached_vectors);
+
+  for (auto _ : state)
+  {
+    for (std::size_t i = 0; i < num_cached_vectors; ++i)
+      c[i] = op(a[i], b[i]);
+
+    benchmark::ClobberMemory();
+  }
+
+  state.SetItemsProcessed(state.iterations() * num_cached_vectors);
+}
+
+template < typename T, std::size_t N >
+static void bench_vector_add(benchmark::State& state)
+{
+  using V = esl::vector< T, N >;
+  run_vector_op< T, N >(state, [](const V& a, const V& b) -> V {
+    return a + b;
+  });
+}
+
+template < typename T, std::size_t N >
+static void bench_vector_sub(benchmark::State& state)
+{
+  using V = esl::vector< T, N >;
+  run_vector_op< T, N >(state, [](const V& a, const V& b) -> V {
+    return a - b;
+  });
+}
+
+template < typename T, std::size_t N >
+static void bench_vector_scale(benchmark::State& state)
+{
+  using V = esl::vector< T, N >;
+  run_vector_op< T, N >(state,
+                        [](const V& a, const V&) -> V { return a * T(0.5); });
+}
+
+template < typename T, std::size_t N >
+static void bench_vector_dot(benchmark::State& state)
+{
+  using V = esl::vector< T, N >;
+  run_vector_op< T, N >(state,
+                        [](const V& a, const V& b) -> V { return a.dot(b); });
+}
+
+template < typename T, std::size_t N >
+static void bench_vector_norm(benchmark::State& state)
+{
+  using V = esl::vector< T, N >;
+  const auto a = make_vectors< V >(num_cached_vectors);
+  std::vector< T > s(num_cached_vectors);
+
+  for (auto _ : state)
+  {
+    for (std::size_t i = 0; i < num_cached_vectors; ++i)
+      s[i] = a[i].norm();
+
+    benchmark::ClobberMemory();
+  }
+
+  state.SetItemsProcessed(state.iterations() * num_cached_vectors);
+}
+
+// The same addition on std::array, the std counterpart of esl::vector
+template < typename T, std::size_t N >
+static void bench_add_std_array(benchmark::State& state)
+{
+  using V = std::array< T, N >;
+  const auto a = make_vectors< V >();
+  auto b = make_vectors< V >();
+
+  for (auto _ : state)
+  {
+    for (std::size_t i = 0; i < num_vectors; ++i)
+      for (std::size_t j = 0; j < N; ++j)
+        b[i][j] += a[i][j];
+
+    benchmark::ClobberMemory();
+  }
+
+  state.SetItemsProcessed(state.iterations() * num_vectors);
+}
+
+template < typename T, std::size_t N >
+static void bench_vector_normalize(benchmark::State& state)
+{
+  using V = esl::vector< T, N >;
+  auto a = make_vectors< V >();
+
+  for (auto _ : state)
+  {
+    for (auto& v : a)
+      v.normalize();
+
+    benchmark::ClobberMemory();
+  }
+
+  state.SetItemsProcessed(state.iterations() * num_vectors);
+}
+
+template < typename T, std::size_t N >
+static void bench_kernel_normalize(benchmark::State& state)
+{
+  using V = esl::vector< T, N >;
+  using ops = esl::simd::ops< T, N >;
+  auto a = make_vectors< V >();
+
+  for (auto _ : state)
+  {
+    for (auto& v : a)
+    {
+      const auto nrm = std::sqrt(ops::dot(v.data(), v.data()));
+
+      if (nrm != T(0))
+        ops::scale(v.data(), v.data(), T(1) / nrm);
+    }
+
+    benchmark::ClobberMemory();
+  }
+
+  state.SetItemsProcessed(state.iterations() * num_vectors);
+}
+
+//
+// Normalization of in-cache vectors with the given precision policy
+//
+template < typename T, std::size_t N, typename P >
+static void bench_normalize_precision(benchmark::State& state)
+{
+  using V = esl::vector< T, N >;
+  auto a = make_vectors< V >(num_cached_vectors);
+
+  for (auto _ : state)
+  {
+    for (auto& v : a)
+      v.template normalize< P >();
+
+    benchmark::ClobberMemory();
+  }
+
+  state.SetItemsProcessed(state.iterations() * num_cached_vectors);
+}
+
+//
+// Sum and sum of squares of in-cache vectors with the accumulation of the
+// given precision policy
+//
+template < typename T, std::size_t N, typename P >
+static void bench_sum_precision(benchmark::State& state)
+{
+  using V = esl::vector< T, N >;
+  const auto a = make_vectors< V >(num_cached_vectors);
+  std::vector< T > s(num_cached_vectors);
+
+  for (auto _ : state)
+  {
+    for (std::size_t i = 0; i < num_cached_vectors; ++i)
+      s[i] = a[i].template sum< P >();
+
+    benchmark::ClobberMemory();
+  }
+
+  state.SetItemsProcessed(state.iterations() * num_cached_vectors);
+}
+
+template < typename T, std::size_t N, typename P >
+static void bench_norm_squared_precision(benchmark::State& state)
+{
+  using V = esl::vector< T, N >;
+  const auto a = make_vectors< V >(num_cached_vectors);
+  std::vector< T > s(num_cached_vectors);
+
+  for (auto _ : state)
+  {
+    for (std::size_t i = 0; i < num_cached_vectors; ++i)
+      s[i] = a[i].template norm_squared< P >();
+
+    benchmark::ClobberMemory();
+  }
+
+  state.SetItemsProcessed(state.iterations() * num_cached_vectors);
+}
+
+//
+// a + b * s - c, with a temporary per operator (the behaviour before
+// expression templates) and as a single fused expression
+//
+template < typename T, std::size_t N >
+static esl::vector< T, N > eager(const esl::vector< T, N >& a,
+                                 const esl::vector< T, N >& b,
+                                 const esl::vector< T, N >& c, T s)
+{
+  auto t1 = b;
+  t1 *= s;
+  auto t2 = a;
+  t2 += t1;
+  auto t3 = t2;
+  t3 -= c;
+  return t3;
+}
+
+template < typename T, std::size_t N >
+static void bench_expression_eager(benchmark::State& state)
+{
+  using V = esl::vector< T, N >;
+  const auto a = make_vectors< V >(num_cached_vectors);
+  const auto b = make_vectors< V >(num_cached_vectors);
+  auto c = make_vectors< V >(num_cached_vectors);
+
+  for (auto _ : state)
+  {
+    for (std::size_t i = 0; i < num_cached_vectors; ++i)
+      c[i] = eager(a[i], b[i], c[i], T(0.5));
+
+    benchmark::ClobberMemory();
+  }
+
+  state.SetItemsProcessed(state.iterations() * num_cached_vectors);
+}
+
+template < typename T, std::size_t N >
+static void bench_expression_lazy(benchmark::State& state)
+{
+  using V = esl::vector< T, N >;
+  const auto a = make_vectors< V >(num_cached_vectors);
+  const auto b = make_vectors< V >(num_cached_vectors);
+  auto c = make_vectors< V >(num_cached_vectors);
+
+  for (auto _ : state)
+  {
+    for (std::size_t i = 0; i < num_cached_vectors; ++i)
+      c[i] = a[i] + b[i] * T(0.5) - c[i];
+
+    benchmark::ClobberMemory();
+  }
+
+  state.SetItemsProcessed(state.iterations() * num_cached_vectors);
+}
+
+BENCHMARK_TEMPLATE(bench_vector_add_assign, float, 3);
+BENCHMARK_TEMPLATE(bench_kernel_add, float, 3);
+BENCHMARK_TEMPLATE(bench_add_std_array, float, 3);
+BENCHMARK_TEMPLATE(bench_vector_add_assign, float, 4);
+BENCHMARK_TEMPLATE(bench_kernel_add, float, 4);
+BENCHMARK_TEMPLATE(bench_add_std_array, float, 4);
+BENCHMARK_TEMPLATE(bench_vector_add_assign, float, 8);
+BENCHMARK_TEMPLATE(bench_kernel_add, float, 8);
+BENCHMARK_TEMPLATE(bench_add_std_array, float, 8);
+BENCHMARK_TEMPLATE(bench_vector_add_assign, double, 3);
+BENCHMARK_TEMPLATE(bench_kernel_add, double, 3);
+BENCHMARK_TEMPLATE(bench_add_std_array, double, 3);
+BENCHMARK_TEMPLATE(bench_vector_add_assign, double, 4);
+BENCHMARK_TEMPLATE(bench_kernel_add, double, 4);
+BENCHMARK_TEMPLATE(bench_add_std_array, double, 4);
+
+BENCHMARK_TEMPLATE(bench_vector_add, float, 3);
+BENCHMARK_TEMPLATE(bench_vector_add, float, 4);
+BENCHMARK_TEMPLATE(bench_vector_add, float, 8);
+BENCHMARK_TEMPLATE(bench_vector_add, double, 3);
+BENCHMARK_TEMPLATE(bench_vector_add, double, 4);
+BENCHMARK_TEMPLATE(bench_vector_sub, float, 3);
+BENCHMARK_TEMPLATE(bench_vector_sub, float, 4);
+BENCHMARK_TEMPLATE(bench_vector_sub, double, 4);
+BENCHMARK_TEMPLATE(bench_vector_scale, float, 3);
+BENCHMARK_TEMPLATE(bench_vector_scale, float, 4);
+BENCHMARK_TEMPLATE(bench_vector_scale, double, 4);
+BENCHMARK_TEMPLATE(bench_vector_dot, float, 3);
+BENCHMARK_TEMPLATE(bench_vector_dot, float, 4);
+BENCHMARK_TEMPLATE(bench_vector_dot, double, 4);
+BENCHMARK_TEMPLATE(bench_vector_norm, float, 3);
+BENCHMARK_TEMPLATE(bench_vector_norm, float, 4);
+BENCHMARK_TEMPLATE(bench_vector_norm, double, 4);
+
+BENCHMARK_TEMPLATE(bench_vector_normalize, float, 3);
+BENCHMARK_TEMPLATE(bench_kernel_normalize, float, 3);
+BENCHMARK_TEMPLATE(bench_vector_normalize, float, 4);
+BENCHMARK_TEMPLATE(bench_kernel_normalize, float, 4);
+BENCHMARK_TEMPLATE(bench_vector_normalize, double, 4);
+BENCHMARK_TEMPLATE(bench_kernel_normalize, double, 4);
+
+BENCHMARK_TEMPLATE(bench_normalize_precision, float, 3,
+                   esl::precision::exact);
+BENCHMARK_TEMPLATE(bench_normalize_precision, float, 3, esl::precision::fast);
+BENCHMARK_TEMPLATE(bench_normalize_precision, float, 4,
+                   esl::precision::exact);
+BENCHMARK_TEMPLATE(bench_normalize_precision, float, 4, esl::precision::fast);
+BENCHMARK_TEMPLATE(bench_normalize_precision, double, 3,
+                   esl::precision::exact);
+BENCHMARK_TEMPLATE(bench_normalize_precision, double, 3,
+                   esl::precision::fast);
+
+BENCHMARK_TEMPLATE(bench_sum_precision, float, 16, esl::precision::exact);
+BENCHMARK_TEMPLATE(bench_sum_precision, float, 16,
+                   esl::precision::wide<>);
+BENCHMARK_TEMPLATE(bench_sum_precision, float, 16,
+                   esl::precision::compensated<>);
+BENCHMARK_TEMPLATE(bench_sum_precision, double, 16, esl::precision::exact);
+BENCHMARK_TEMPLATE(bench_norm_squared_precision, float, 16,
+                   esl::precision::exact);
+BENCHMARK_TEMPLATE(bench_norm_squared_precision, float, 16,
+                   esl::precision::wide<>);
+BENCHMARK_TEMPLATE(bench_norm_squared_precision, float, 16,
+                   esl::precision::compensated<>);
+BENCHMARK_TEMPLATE(bench_norm_squared_precision, double, 16,
+                   esl::precision::exact);
+
+BENCHMARK_TEMPLATE(bench_expression_eager, double, 6);
+BENCHMARK_TEMPLATE(bench_expression_lazy, double, 6);
+BENCHMARK_TEMPLATE(bench_expression_eager, double, 16);
+BENCHMARK_TEMPLATE(bench_expression_lazy, double, 16);
+
+BENCHMARK_MAIN();
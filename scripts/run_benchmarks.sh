@@ -0,0 +1,37 @@
+#!/bin/bash
+##          Copyright Emil Fresk 2017-2018.
+## Distributed under the Boost Software License, Version 1.0.
+##    (See accompanying file LICENSE.md or copy at
+##          http://www.boost.org/LICENSE_1_0.txt)
+
+# Runs all benchmarks of a build and saves one JSON file per benchmark, to be
+# compared between releases. Extra arguments are passed on to every
+# benchmark, e.g. --benchmark_repetitions=5.
+#
+# Usage: bash scripts/run_benchmarks.sh <build dir> <output dir> [args...]
+
+if [ $# -lt 2 ]; then
+    echo "Usage: $0 <build dir> <output dir> [benchmark args...]"
+    exit 1
+fi
+
+BUILD_DIR=$1
+OUT_DIR=$2
+shift 2
+
+BENCHES=$(find "$BUILD_DIR" -maxdepth 1 -type f -executable -name 'bench_*' | sort)
+
+if [ -z "$BENCHES" ]; then
+    echo "No benchmarks in $BUILD_DIR, configure with -DENABLE_BENCHMARKS=ON"
+    exit 1
+fi
+
+mkdir -p "$OUT_DIR"
+
+for BENCH in $BENCHES; do
+    NAME=$(basename "$BENCH")
+    echo "Running $NAME"
+
+    "$BENCH" --benchmark_out="$OUT_DIR/$NAME.json" \
+             --benchmark_out_format=json "$@" || exit 1
+done
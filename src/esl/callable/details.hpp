@@ -0,0 +1,78 @@
+//          Copyright Emil Fresk 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <type_traits>
+
+#include "../helpers/error_functions.hpp"
+
+namespace esl
+{
+namespace details
+{
+//
+// Return value of an empty callable. If the return type can be default
+// constructed the call is a no-op, else it is a trap.
+//
+template < typename Ret >
+constexpr Ret empty_return(std::true_type) noexcept
+{
+  return Ret();
+}
+
+template < typename Ret >
+[[noreturn]] Ret empty_return(std::false_type) noexcept
+{
+  error_functions::halt{}("call of an empty callable");
+}
+
+template < typename Ret >
+constexpr Ret empty_return() noexcept
+{
+  return empty_return< Ret >(
+      std::integral_constant< bool,
+                              std::is_void< Ret >::value ||
+                                  std::is_default_constructible< Ret >::value >{});
+}
+
+//
+// Helper to extract function signature
+//
+template < typename T >
+struct function_info;
+
+template < typename R, typename... A >
+struct function_info< R(A...) >  // function
+{
+  using signature = R(A...);
+};
+
+template < typename R, typename... A >
+struct function_info< R (*)(A...) > : function_info< R(A...) >  // pointer
+{
+};
+
+//
+// Helper to extract method signature + class type
+//
+template < typename T >
+struct method_info;
+
+template < typename C, typename R, typename... A >
+struct method_info< R (C::*)(A...) >  // method pointer
+{
+  using class_type = C;
+  using signature = R(A...);
+};
+
+// Specialization for const methods
+template < typename C, typename R, typename... A >
+struct method_info< R (C::*)(A...) const > : method_info< R (C::*)(A...) >
+{
+};
+
+}  // namespace details
+}  // namespace esl
@@ -0,0 +1,137 @@
+//          Copyright Emil Fresk 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#include "function_view.hpp"
+
+namespace esl
+{
+//
+// Base class definition
+//
+template < typename Key, typename, std::size_t Size >
+class dispatch_table;
+
+//
+// Compile-time built table of handlers keyed by an enum (or integer) ID.
+// The table is a constexpr array of function pointers indexed by the ID, so a
+// dispatch is a bounds check and an indirect call, and IDs known at compile
+// time are resolved to a direct call. IDs without a handler, or outside of
+// the table, go to the default handler.
+//
+template < typename Key, typename Ret, typename... Args, std::size_t Size >
+class dispatch_table< Key, Ret(Args...), Size >
+{
+public:
+  using function_pointer = Ret (*)(Args...);
+  using function_type = function_view< Ret(Args...) >;
+
+  //
+  // Handler definition, binds an ID to a function
+  //
+  template < Key Id, function_pointer Fptr >
+  struct handler
+  {
+    static_assert(Fptr != nullptr, "Function pointer must not be null");
+    static_assert(static_cast< std::size_t >(Id) < Size,
+                  "The handler ID does not fit in the table");
+
+    static constexpr std::size_t index = static_cast< std::size_t >(Id);
+    static constexpr function_pointer fun = Fptr;
+  };
+
+private:
+  template < typename... >
+  struct handler_list
+  {
+  };
+
+  function_pointer table_[Size];
+  function_pointer default_;
+
+  // Finds the handler for an index, falls back to the default handler
+  template < std::size_t I, typename... Handlers >
+  constexpr static function_pointer select(function_pointer def) noexcept
+  {
+    constexpr std::size_t indices[] = {Handlers::index...};
+    constexpr function_pointer funs[] = {Handlers::fun...};
+
+    for (std::size_t i = 0; i < sizeof...(Handlers); ++i)
+      if (indices[i] == I)
+        return funs[i];
+
+    return def;
+  }
+
+  template < typename... Handlers >
+  constexpr static bool unique_ids() noexcept
+  {
+    constexpr std::size_t indices[] = {Handlers::index...};
+
+    for (std::size_t i = 0; i < sizeof...(Handlers); ++i)
+      for (std::size_t j = i + 1; j < sizeof...(Handlers); ++j)
+        if (indices[i] == indices[j])
+          return false;
+
+    return true;
+  }
+
+  template < std::size_t... Is, typename... Handlers >
+  constexpr dispatch_table(function_pointer def, std::index_sequence< Is... >,
+                           handler_list< Handlers... >) noexcept
+      : table_{select< Is, Handlers... >(def)...}, default_{def}
+  {
+  }
+
+public:
+  //
+  // Create a table from a default handler and a list of handlers
+  //
+  template < function_pointer Default, typename... Handlers >
+  constexpr static dispatch_table make() noexcept
+  {
+    static_assert(Default != nullptr, "Function pointer must not be null");
+    static_assert(sizeof...(Handlers) > 0, "At least one handler is required");
+    static_assert(unique_ids< Handlers... >(), "Handler IDs must be unique");
+
+    return dispatch_table{Default, std::make_index_sequence< Size >{},
+                          handler_list< Handlers... >{}};
+  }
+
+  //
+  // Dispatch using operator()
+  //
+  template < typename... Ts >
+  constexpr Ret operator()(Key id, Ts&&... args) const
+  {
+    return get(id)(std::forward< Ts >(args)...);
+  }
+
+  //
+  // Access
+  //
+  constexpr function_pointer get(Key id) const noexcept
+  {
+    const auto idx = static_cast< std::size_t >(id);
+    return (idx < Size) ? table_[idx] : default_;
+  }
+
+  function_type operator[](Key id) const noexcept
+  {
+    return function_type::from(get(id));
+  }
+
+  constexpr std::size_t size() const noexcept
+  {
+    return Size;
+  }
+};
+
+}  // namespace esl
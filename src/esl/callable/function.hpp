@@ -6,10 +6,13 @@
 #pragma once
 
 #include <cstdint>
+#include <cstring>
 #include <memory>
 #include <type_traits>
+#include <utility>
 
-#include "../helpers/feature_defs.hpp"
+#include "../helpers/utils.hpp"
+#include "details.hpp"
 
 // For Cortex-M, sizeof(void*) bytes local storage is enough for function
 // pointers and method pointers that are know at compile time.
@@ -22,91 +25,253 @@ namespace esl
 // Base class definition and defaults
 //
 template < typename, std::size_t Size = sizeof(void*),
-           std::size_t Align = alignof(void*) >
+           std::size_t Align = alignof(void*), bool Copyable = true >
 class function;
 
-template < typename Ret, typename... Args, std::size_t Size, std::size_t Align >
-class function< Ret(Args...), Size, Align >
+// A function that cannot be copied, can hold move-only callables
+template < typename Signature, std::size_t Size = sizeof(void*),
+           std::size_t Align = alignof(void*) >
+using move_only_function = function< Signature, Size, Align, false >;
+
+template < typename Ret, typename... Args, std::size_t Size, std::size_t Align,
+           bool Copyable >
+class function< Ret(Args...), Size, Align, Copyable >
 {
 private:
   //
-  // Local "vtable" definition
+  // Local "vtable" definition, one static instance per callable type so each
+  // function only stores a single pointer next to the storage
   //
+  using Caller = Ret (*)(const void*, Args...);
+  using Destroyer = void (*)(const void*);
+  using Copier = void (*)(void*, const void*);
+  using Mover = void (*)(void*, void*);
+
   struct vtable
   {
-    Ret (*call)(const void*, Args...);
-    void (*destroy)(const void*);
+    Caller call;
+    Destroyer destroy;  // nullptr when trivially destructible
+    Copier copy;        // nullptr when memcpy is enough
+    Mover move;         // nullptr when memcpy is enough
+    bool relocatable;   // memcpy without destroying the source is enough
   };
 
-// Check for constexpr lambdas
-#ifndef ESL_CONSTEXPR_LAMBDA_AVAILABLE
-
-  // No constexpr lambdas, use statics to populate the vtable
+  //
+  // Call and lifecycle helpers, trivially copyable callables are relocated
+  // with a plain memcpy of the storage instead of going through the vtable
+  //
   template < typename F >
-  constexpr static Ret caller(const void* fun, Args... args)
+  static Ret caller(const void* fun, Args... args)
   {
     return (*static_cast< const F* >(fun))(args...);
   }
 
   template < typename F >
-  constexpr static void destroyer(const void* fun)
+  static void destroyer(const void* fun)
   {
     static_cast< const F* >(fun)->~F();
   }
 
   template < typename F >
-  constexpr vtable make_vtable() const noexcept
+  static void copier(void* dst, const void* src)
   {
-    return {
-        caller< F >,    // caller
-        destroyer< F >  // destroyer
-    };
+    new (dst) F(*static_cast< const F* >(src));
   }
 
-#else
+  template < typename F >
+  static void mover(void* dst, void* src)
+  {
+    new (dst) F(std::move(*static_cast< F* >(src)));
+  }
 
-  // Constexpr lambdas, use lambdas to populate the vtable
   template < typename F >
-  constexpr vtable make_vtable() const noexcept
+  constexpr static Destroyer make_destroyer() noexcept
   {
-    return {[](const void* fun, Args... args) -> Ret {  // caller
-              return (*static_cast< const F* >(fun))(args...);
-            },
-            [](const void* fun) {  // destroyer
-              static_cast< const F* >(fun)->~F();
-            }};
+    return std::is_trivially_destructible< F >::value ? nullptr
+                                                      : destroyer< F >;
   }
 
-#endif
+  template < typename F >
+  constexpr static Copier make_copier(std::true_type) noexcept
+  {
+    return std::is_trivially_copyable< F >::value ? nullptr : copier< F >;
+  }
+
+  template < typename F >
+  constexpr static Copier make_copier(std::false_type) noexcept
+  {
+    return nullptr;  // Never copied
+  }
+
+  template < typename F >
+  constexpr static Copier make_copier() noexcept
+  {
+    // A move-only callable in a copyable function fails the static_assert in
+    // the constructor, do not add a copier error on top of it
+    return make_copier< F >(std::integral_constant<
+                            bool, Copyable &&
+                                      std::is_copy_constructible< F >::value >{});
+  }
+
+  template < typename F >
+  constexpr static Mover make_mover() noexcept
+  {
+    return std::is_trivially_copyable< F >::value ? nullptr : mover< F >;
+  }
+
+  template < typename F >
+  static const vtable* get_vtable() noexcept
+  {
+    static constexpr vtable vt{
+        caller< F >,            // caller
+        make_destroyer< F >(),  // destroyer
+        make_copier< F >(),     // copier
+        make_mover< F >(),      // mover
+        is_trivially_relocatable< F >::value  // relocatable
+    };
+
+    return &vt;
+  }
+
+  //
+  // Empty state, calling is a no-op returning Ret() (or a trap if Ret cannot
+  // be default constructed) so call sites do not need to check for empty
+  //
+  static Ret empty_caller(const void*, Args...) noexcept
+  {
+    return details::empty_return< Ret >();
+  }
+
+  static const vtable* get_empty_vtable() noexcept
+  {
+    static constexpr vtable vt{
+        empty_caller,  // caller
+        nullptr,       // destroyer
+        nullptr,       // copier
+        nullptr,       // mover
+        true           // relocatable
+    };
+
+    return &vt;
+  }
 
   //
   // Storage
   //
-  vtable vtable_;
+  const vtable* vtable_;
   std::aligned_storage_t< Size, Align > storage_;
 
+  // Stands in for function in the copy operations of a move-only function,
+  // the implicit copy operations are then deleted by the move operations
+  struct not_copyable
+  {
+    not_copyable() = delete;
+  };
+
+  using copy_type = std::conditional_t< Copyable, function, not_copyable >;
+
+  // The vtable is only taken over when the copy succeeded
+  void copy_from(const function& other)
+  {
+    if (other.vtable_->copy)
+      other.vtable_->copy(&storage_, &other.storage_);
+    else
+      std::memcpy(&storage_, &other.storage_, Size);
+
+    vtable_ = other.vtable_;
+  }
+
+  void move_from(function& other) noexcept
+  {
+    vtable_ = other.vtable_;
+
+    if (vtable_->move)
+      vtable_->move(&storage_, &other.storage_);
+    else
+      std::memcpy(&storage_, &other.storage_, Size);
+  }
+
+  void destroy() noexcept
+  {
+    if (vtable_->destroy)
+      vtable_->destroy(&storage_);
+  }
+
 public:
-  // default constructors
-  constexpr function(const function&) = default;
-  constexpr function(function&&) = default;
-  constexpr function() = delete;  // There is no empty function
+  // copy / move constructors, the callable is copied / moved via the vtable
+  function(const copy_type& other)
+  {
+    copy_from(other);
+  }
+
+  function(function&& other) noexcept
+  {
+    move_from(other);
+  }
+
+  // empty constructors
+  function() noexcept : vtable_{get_empty_vtable()}
+  {
+  }
+
+  function(std::nullptr_t) noexcept : function()
+  {
+  }
 
   // assignment operators
-  constexpr function& operator=(const function&) = default;
-  constexpr function& operator=(function&&) = default;
+  function& operator=(const copy_type& other)
+  {
+    if (this != &other)
+    {
+      // Empty until the copy succeeded, a throwing copy leaves it empty
+      destroy();
+      vtable_ = get_empty_vtable();
+      copy_from(other);
+    }
+
+    return *this;
+  }
+
+  function& operator=(function&& other) noexcept
+  {
+    if (this != &other)
+    {
+      destroy();
+      move_from(other);
+    }
+
+    return *this;
+  }
+
+  function& operator=(std::nullptr_t) noexcept
+  {
+    destroy();
+    vtable_ = get_empty_vtable();
+
+    return *this;
+  }
 
   //
   // Explicit construction
   //
-  template < typename F, typename = std::enable_if_t<
-                             !std::is_convertible< F, function >::value > >
-  explicit constexpr function(F&& fun)
-      : vtable_{make_vtable< std::decay_t< F > >()}
+  template < typename F,
+             typename = std::enable_if_t<
+                 !std::is_same< std::decay_t< F >, function >::value &&
+                 !std::is_convertible< F, function >::value > >
+  explicit function(F&& fun) : vtable_{get_vtable< std::decay_t< F > >()}
   {
-    static_assert(sizeof(std::decay_t< F >) <= Size,
+    using Fun = std::decay_t< F >;
+
+    static_assert(sizeof(Fun) <= Size,
                   "The callable does not fit inside the function");
+    static_assert(Align % alignof(Fun) == 0,
+                  "The callable's alignment is not compatible");
+    static_assert(std::is_nothrow_move_constructible< Fun >::value,
+                  "The callable must be nothrow move constructible");
+    static_assert(!Copyable || std::is_copy_constructible< Fun >::value,
+                  "The callable is move-only, use move_only_function");
 
-    new (&storage_) F{std::forward< F >(fun)};
+    new (&storage_) Fun{std::forward< F >(fun)};
   }
 
   //
@@ -114,7 +279,7 @@ public:
   //
   ~function()
   {
-    vtable_.destroy(&storage_);
+    destroy();
   }
 
   //
@@ -123,7 +288,24 @@ public:
   template < typename... Ts >
   constexpr Ret operator()(Ts&&... args) const
   {
-    return vtable_.call(&storage_, std::forward< Ts >(args)...);
+    return vtable_->call(&storage_, std::forward< Ts >(args)...);
+  }
+
+  //
+  // Check if a callable is held
+  //
+  explicit operator bool() const noexcept
+  {
+    return vtable_ != get_empty_vtable();
+  }
+
+  //
+  // A function can be moved with a memcpy when the callable it holds can,
+  // containers such as static_vector check this per element
+  //
+  friend bool is_relocatable(const function& fun) noexcept
+  {
+    return fun.vtable_->relocatable;
   }
 
   //
@@ -131,8 +313,7 @@ public:
   //
   constexpr bool operator==(const function& other) const noexcept
   {
-    return (vtable_.call == other.vtable_.call) &&
-           (vtable_.destroy == other.vtable_.destroy);
+    return vtable_ == other.vtable_;
   }
 
   constexpr bool operator!=(const function& other) const noexcept
@@ -5,9 +5,13 @@
 
 #pragma once
 
+#include <cstddef>
 #include <memory>
 #include <type_traits>
 
+#include "../helpers/feature_defs.hpp"
+#include "details.hpp"
+
 namespace esl
 {
 //
@@ -25,6 +29,15 @@ private:
   void* object_;
   Caller caller_;
 
+  //
+  // Empty state, calling is a no-op returning Ret() (or a trap if Ret cannot
+  // be default constructed) so call sites do not need to check for empty
+  //
+  static Ret empty_caller(void*, Args...) noexcept
+  {
+    return details::empty_return< Ret >();
+  }
+
   //
   // constructor - private so users must use factory functions
   //
@@ -37,7 +50,15 @@ public:
   // default constructors
   constexpr function_view(const function_view&) = default;
   constexpr function_view(function_view&&) = default;
-  constexpr function_view() = delete;  // There is no empty function_view
+
+  // empty constructors
+  constexpr function_view() noexcept : object_(nullptr), caller_(empty_caller)
+  {
+  }
+
+  constexpr function_view(std::nullptr_t) noexcept : function_view()
+  {
+  }
 
   // assignment operators
   constexpr function_view& operator=(const function_view&) = default;
@@ -63,6 +84,14 @@ public:
     return caller_(object_, std::forward< Ts >(args)...);
   }
 
+  //
+  // Check if a callable is referenced
+  //
+  constexpr explicit operator bool() const noexcept
+  {
+    return caller_ != empty_caller;
+  }
+
   //
   // Operators
   //
@@ -90,12 +119,18 @@ public:
                          }};
   }
 
+  // No pointer is stored, Fptr is called directly from the caller. The
+  // result compares equal to views made the same way from the same Fptr,
+  // but not to from(Fptr), whose caller goes through the stored pointer.
   template < Ret (*Fptr)(Args...) >
   constexpr static function_view from() noexcept
   {
     static_assert(Fptr != nullptr, "Function pointer must not be null");
 
-    return function_view::from(Fptr);
+    return function_view{nullptr,  // no object, the function is in the caller
+                         [](void*, Args... args) -> Ret {
+                           return Fptr(args...);  // direct call, inlinable
+                         }};
   }
 
   // Make from Methods
@@ -122,4 +157,47 @@ public:
         }};
   }
 };
+
+//
+// Helpers to create function_views with the signature deduced from the
+// function / method pointer. The pointer is bound as a template parameter, so
+// no function or member pointer is stored and the call can be inlined.
+//
+#ifdef ESL_TEMPLATE_AUTO_AVAILABLE
+
+// Make from Functions
+template < auto Fptr >
+constexpr auto make_function_view() noexcept
+{
+  using info = details::function_info< decltype(Fptr) >;
+  return function_view< typename info::signature >::template from< Fptr >();
+}
+
+// Make from Methods and Const methods
+template < auto Mptr, typename Obj >
+constexpr auto make_function_view(Obj& obj) noexcept
+{
+  using info = details::method_info< decltype(Mptr) >;
+  return function_view< typename info::signature >::template from<
+      typename info::class_type, Mptr >(obj);
+}
+
+#endif
 }  // end namespace esl
+
+//
+// Macro versions of make_function_view, for C++14
+//
+
+// Generate a function_view from a function
+#define ESL_FUNCTION_VIEW_FUNCTION(fptr)                       \
+  esl::function_view< typename esl::details::function_info<    \
+      decltype(fptr) >::signature >::template from< (fptr) >()
+
+// Generate a function_view from a method
+#define ESL_FUNCTION_VIEW_METHOD(mptr, obj)                                 \
+  esl::function_view<                                                       \
+      typename esl::details::method_info< decltype(mptr) >::signature >::   \
+      template from<                                                        \
+          typename esl::details::method_info< decltype(mptr) >::class_type, \
+          (mptr) >(obj)
@@ -5,49 +5,13 @@
 
 #pragma once
 
-namespace esl
-{
-// Helper to extract function signature
-template < typename T >
-struct FunctionInfo;
+#include "../function_view.hpp"
 
-template < typename R, typename... A >
-struct FunctionInfo< R (*)(A...) >  // function pointer
-{
-  using Signature = R(A...);
-};
-
-// Helper to extract method signature + class type
-template < typename T >
-struct MethodInfo;
-
-template < typename C, typename R, typename... A >
-struct MethodInfo< R (C::*)(A...) >  // method pointer
-{
-  using ClassType = C;
-  using Signature = R(A...);
-};
-
-// Specialization for const methods
-template < typename C, typename R, typename... A >
-struct MethodInfo< R (C::*)(A...) const > : MethodInfo< R (C::*)(A...) >
-{
-};
-
-}  // namespace esl
+// The signature deduction helpers now live in callable/details.hpp, and the
+// delegate macros generate function_views
 
 // Generate function delegate
-#define DELEGATE_FUNCTION(fptr)                             \
-  [&]() {                                                   \
-    using minfo = esl::FunctionInfo< decltype(fptr) >;      \
-    using del = esl::delegate< typename minfo::Signature >; \
-    return del::from_function< (fptr) >();                  \
-  }()
+#define DELEGATE_FUNCTION(fptr) ESL_FUNCTION_VIEW_FUNCTION(fptr)
 
 // Generate method delegate
-#define DELEGATE_METHOD(mptr, obj)                                     \
-  [&]() {                                                              \
-    using minfo = esl::MethodInfo< decltype(mptr) >;                   \
-    using del = esl::delegate< typename minfo::Signature >;            \
-    return del::from_method< typename minfo::ClassType, (mptr) >(obj); \
-  }()
+#define DELEGATE_METHOD(mptr, obj) ESL_FUNCTION_VIEW_METHOD(mptr, obj)
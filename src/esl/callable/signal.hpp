@@ -0,0 +1,274 @@
+//          Copyright Emil Fresk 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#include "function_view.hpp"
+#include "../containers/static_vector.hpp"
+
+namespace esl
+{
+//
+// Base class definition
+//
+template < typename >
+class signal;
+
+//
+// Multicast delegate, fans one emission out to all connected slots. The
+// slots are stored contiguously in a static_vector so an emission is a
+// plain loop over function_views.
+//
+// Connecting and disconnecting from inside a slot is safe: slots connected
+// during an emission are first called on the next emission, and disconnected
+// slots are replaced by empty function_views and removed after the emission.
+//
+template < typename Ret, typename... Args >
+class signal< Ret(Args...) >
+{
+public:
+  using function_type = function_view< Ret(Args...) >;
+
+  //
+  // Handle to a connected slot, default constructed handles are invalid
+  //
+  class connection
+  {
+    friend class signal;
+
+    std::size_t id_ = 0;
+
+    constexpr explicit connection(std::size_t id) noexcept : id_(id)
+    {
+    }
+
+  public:
+    constexpr connection() noexcept = default;
+
+    constexpr explicit operator bool() const noexcept
+    {
+      return id_ != 0;
+    }
+
+    constexpr bool operator==(const connection& other) const noexcept
+    {
+      return id_ == other.id_;
+    }
+
+    constexpr bool operator!=(const connection& other) const noexcept
+    {
+      return !(*this == other);
+    }
+  };
+
+private:
+  struct slot
+  {
+    function_type fun;
+    std::size_t id;
+  };
+
+public:
+  //
+  // Standard type definitions
+  //
+  using size_type = std::size_t;
+  using value_type = slot;
+
+private:
+  static_vector< slot > slots_;
+  std::size_t next_id_ = 1;
+  std::size_t emit_depth_ = 0;
+  bool pending_removal_ = false;
+
+  // Remove slots disconnected during an emission
+  void compact() noexcept
+  {
+    if (!pending_removal_)
+      return;
+
+    auto it = std::remove_if(slots_.begin(), slots_.end(),
+                             [](const slot& s) { return s.id == 0; });
+    slots_.erase(it, slots_.end());
+
+    pending_removal_ = false;
+  }
+
+  // Counts an emission, compacts the slots when the outermost one ends, also
+  // when a slot throws
+  class emit_guard
+  {
+    signal& sig_;
+
+  public:
+    explicit emit_guard(signal& sig) noexcept : sig_(sig)
+    {
+      ++sig_.emit_depth_;
+    }
+
+    ~emit_guard()
+    {
+      if (--sig_.emit_depth_ == 0)
+        sig_.compact();
+    }
+
+    emit_guard(const emit_guard&) = delete;
+    emit_guard& operator=(const emit_guard&) = delete;
+  };
+
+  template < typename Pred >
+  bool disconnect_if(Pred&& pred) noexcept
+  {
+    for (auto it = slots_.begin(); it != slots_.end(); ++it)
+    {
+      if (it->id == 0 || !pred(*it))
+        continue;
+
+      if (emit_depth_ > 0)
+      {
+        // Emitting, keep the storage in place and remove afterwards
+        *it = slot{function_type{}, 0};
+        pending_removal_ = true;
+      }
+      else
+      {
+        slots_.erase(it);
+      }
+
+      return true;
+    }
+
+    return false;
+  }
+
+public:
+  //
+  // Constructor
+  //
+  constexpr signal(slot* buffer, size_type capacity) noexcept
+      : slots_(buffer, capacity)
+  {
+  }
+
+  signal(const signal&) = delete;
+  signal& operator=(const signal&) = delete;
+
+  //
+  // Capacity
+  //
+  constexpr size_type size() const noexcept
+  {
+    return slots_.size();
+  }
+
+  constexpr size_type capacity() const noexcept
+  {
+    return slots_.capacity();
+  }
+
+  constexpr bool empty() const noexcept
+  {
+    return slots_.empty();
+  }
+
+  constexpr bool full() const noexcept
+  {
+    return slots_.full();
+  }
+
+  //
+  // Modifiers
+  //
+
+  // Returns an invalid connection if the signal is full
+  connection connect(function_type fun) noexcept
+  {
+    if (slots_.full())
+      return connection{};
+
+    const auto id = next_id_++;
+    slots_.emplace_back(slot{fun, id});
+
+    return connection{id};
+  }
+
+  bool disconnect(const connection& con) noexcept
+  {
+    if (!con)
+      return false;
+
+    return disconnect_if([&](const slot& s) { return s.id == con.id_; });
+  }
+
+  // Disconnects the first slot bound to the same callable. Slots are matched
+  // with function_view's operator==, so a function must be given in the form
+  // it was connected with: from< f >() does not match from(f)
+  bool disconnect(const function_type& fun) noexcept
+  {
+    return disconnect_if([&](const slot& s) { return s.fun == fun; });
+  }
+
+  void clear() noexcept
+  {
+    if (emit_depth_ > 0)
+    {
+      for (auto& s : slots_)
+        s = slot{function_type{}, 0};
+
+      pending_removal_ = true;
+    }
+    else
+    {
+      slots_.clear();
+    }
+  }
+
+  //
+  // Emission, slots connected during the emission are not called
+  //
+  template < typename... Ts >
+  void emit(Ts&&... args)
+  {
+    const auto n = slots_.size();
+    const auto* s = slots_.data();
+
+    emit_guard guard(*this);
+
+    for (size_type i = 0; i < n; ++i)
+    {
+      if (s[i].id != 0)
+        s[i].fun(args...);
+    }
+  }
+
+  template < typename... Ts >
+  void operator()(Ts&&... args)
+  {
+    emit(std::forward< Ts >(args)...);
+  }
+
+  // Emission where each slot's return value is given to a collector
+  template < typename Collector, typename... Ts >
+  void emit_collect(Collector&& collector, Ts&&... args)
+  {
+    const auto n = slots_.size();
+    const auto* s = slots_.data();
+
+    emit_guard guard(*this);
+
+    for (size_type i = 0; i < n; ++i)
+    {
+      if (s[i].id != 0)
+        collector(s[i].fun(args...));
+    }
+  }
+};
+
+}  // namespace esl
@@ -0,0 +1,73 @@
+//          Copyright Emil Fresk 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#include "function.hpp"
+
+namespace esl
+{
+//
+// Move-only unit of deferred work, uses the inline storage of function so a
+// task never allocates. Being move-only it can hold move-only callables.
+//
+template < std::size_t Size = 3 * sizeof(void*),
+           std::size_t Align = alignof(void*) >
+class task
+{
+private:
+  using function_type = move_only_function< void(), Size, Align >;
+
+  function_type fun_;
+
+public:
+  // move only
+  task(const task&) = delete;
+  task& operator=(const task&) = delete;
+
+  task(task&&) noexcept = default;
+  task& operator=(task&&) noexcept = default;
+
+  // empty constructors
+  task() noexcept = default;
+
+  task(std::nullptr_t) noexcept : fun_{nullptr}
+  {
+  }
+
+  //
+  // Explicit construction
+  //
+  template < typename F,
+             typename = std::enable_if_t<
+                 !std::is_same< std::decay_t< F >, task >::value &&
+                 !std::is_convertible< F, task >::value > >
+  explicit task(F&& fun) : fun_{std::forward< F >(fun)}
+  {
+  }
+
+  //
+  // Run the task
+  //
+  void operator()() const
+  {
+    fun_();
+  }
+
+  //
+  // Check if a callable is held
+  //
+  explicit operator bool() const noexcept
+  {
+    return static_cast< bool >(fun_);
+  }
+};
+
+}  // namespace esl
@@ -0,0 +1,197 @@
+//          Copyright Emil Fresk 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+#include "../helpers/error_functions.hpp"
+#include "../helpers/feature_defs.hpp"
+#include "../helpers/utils.hpp"
+
+namespace esl
+{
+//
+// N unsigned integers of Bits bits each, stored back to back in 64 bit
+// words, e.g. IDs in 0-1000 take 10 bits instead of the 16 of
+// uint_least_t< 1000 >. A value may straddle two words, get() and set()
+// always touch both (there is one word of padding at the end) so they are
+// branch free.
+//
+// unpack() decodes blocks of 64 values, which span exactly Bits words, with
+// every shift known at compile time.
+//
+// ErrFun is called for indices out of bounds and values wider than Bits,
+// see error_functions.hpp.
+//
+template < std::size_t Bits, std::size_t N,
+           typename ErrFun = error_functions::noop >
+class packed_array
+{
+public:
+  static_assert(Bits > 0 && Bits <= 64, "Bits must be in 1 to 64.");
+  static_assert(N > 0, "At least one value is needed.");
+
+  using word_type = std::uint64_t;
+  using size_type = std::size_t;
+
+  static constexpr word_type max_value =
+      (Bits == 64) ? ~word_type(0) : (word_type(1) << (Bits % 64)) - 1;
+
+  using value_type = uint_least_t< max_value >;
+
+  // Values per block of unpack()
+  static constexpr size_type block_size = 64;
+
+private:
+  static constexpr size_type word_bits = 64;
+  static constexpr size_type num_words =
+      (N * Bits + word_bits - 1) / word_bits;
+
+  using CheckBounds = std::integral_constant<
+      bool, !std::is_same< ErrFun, error_functions::noop >::value >;
+
+  word_type words_[num_words + 1];
+
+  // Value starting at bit off of w[0], the double shifts make off == 0 read
+  // nothing from w[1]
+  static constexpr word_type extract(const word_type* w,
+                                     size_type off) noexcept
+  {
+    return ((w[0] >> off) | ((w[1] << 1) << (word_bits - 1 - off))) &
+           max_value;
+  }
+
+  // The 64 values of block b
+  template < typename T >
+  void unpack_block(size_type b, T* out) const noexcept
+  {
+    const word_type* w = words_ + b * Bits;
+
+    esl::repeat< block_size >([&](auto j) {
+      constexpr size_type bit = decltype(j)::value * Bits;
+      constexpr size_type off = bit % word_bits;
+
+      auto v = w[bit / word_bits] >> off;
+
+      if
+        ESL_CONSTEXPR_IF(off + Bits > word_bits)
+      v |= w[bit / word_bits + 1] << ((word_bits - off) % word_bits);
+
+      out[j] = T(v & max_value);
+    });
+  }
+
+public:
+  constexpr packed_array() noexcept : words_{}
+  {
+  }
+
+  constexpr static size_type size() noexcept
+  {
+    return N;
+  }
+
+  constexpr static size_type bits() noexcept
+  {
+    return Bits;
+  }
+
+  // Bytes used by the values, less than sizeof(value_type) * N unless Bits
+  // is a power of 2
+  constexpr static size_type storage_size() noexcept
+  {
+    return sizeof(words_);
+  }
+
+  constexpr value_type get(size_type idx) const
+      noexcept(noexcept(ErrFun{}("")))
+  {
+    if
+      ESL_CONSTEXPR_IF(CheckBounds())
+      {
+        if (idx >= N)
+        {
+          ErrFun{}("get out of bounds");
+          return 0;
+        }
+      }
+
+    const auto bit = idx * Bits;
+    return value_type(extract(words_ + bit / word_bits, bit % word_bits));
+  }
+
+  constexpr value_type operator[](size_type idx) const
+      noexcept(noexcept(ErrFun{}("")))
+  {
+    return get(idx);
+  }
+
+  constexpr void set(size_type idx,
+                     word_type value) noexcept(noexcept(ErrFun{}("")))
+  {
+    if
+      ESL_CONSTEXPR_IF(CheckBounds())
+      {
+        if (idx >= N)
+          return ErrFun{}("set out of bounds");
+
+        if (value > max_value)
+          return ErrFun{}("value wider than Bits");
+      }
+
+    const auto bit = idx * Bits;
+    const auto off = bit % word_bits;
+    word_type* w = words_ + bit / word_bits;
+
+    value &= max_value;
+
+    w[0] = (w[0] & ~(max_value << off)) | (value << off);
+
+    // The part in the next word, nothing when the value fits in w[0]
+    const auto high = word_bits - 1 - off;
+    w[1] = (w[1] & ~((max_value >> 1) >> high)) | ((value >> 1) >> high);
+  }
+
+  // Sets all values to zero
+  constexpr void clear() noexcept
+  {
+    for (auto i = 0U; i < num_words + 1; ++i)
+      words_[i] = 0;
+  }
+
+  //
+  // Writes the values [first, first + count) to out, converted to T. Whole
+  // blocks of 64 values are decoded unrolled, the rest one at a time.
+  //
+  template < typename T >
+  void unpack(size_type first, size_type count, T* out) const
+      noexcept(noexcept(ErrFun{}("")))
+  {
+    if
+      ESL_CONSTEXPR_IF(CheckBounds())
+      {
+        if (first > N || count > N - first)
+          return ErrFun{}("unpack out of bounds");
+      }
+
+    const auto last = first + count;
+
+    // Up to the first block boundary
+    for (; first < last && first % block_size != 0; ++first)
+      *out++ = T(get(first));
+
+    for (; last - first >= block_size; first += block_size)
+    {
+      unpack_block(first / block_size, out);
+      out += block_size;
+    }
+
+    for (; first < last; ++first)
+      *out++ = T(get(first));
+  }
+};
+
+}  // namespace esl
@@ -221,7 +221,7 @@ public:
     {
       // All will fit without the head_idx_ overflowing
       std::memcpy(&buffer_[head_idx_], ptr, n * sizeof(T));
-      head_idx_ += n;
+      head_idx_ = (head_idx_ + n) & mask_;
     }
     else
     {
@@ -0,0 +1,434 @@
+//          Copyright Emil Fresk 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+#include "../helpers/error_functions.hpp"
+#include "../helpers/feature_defs.hpp"
+#include "../helpers/unsafe_flag.hpp"
+
+namespace esl
+{
+namespace details
+{
+constexpr std::size_t bitmap_word_bits = 64;
+
+constexpr std::size_t bitmap_words(std::size_t n)
+{
+  return (n + bitmap_word_bits - 1) / bitmap_word_bits;
+}
+
+//
+// One level of a hierarchical bitmap, a set bit is a free slot. Levels with
+// more than one word have a summary level with one bit per word, set when
+// the word has a free slot, so a free slot is found with one count trailing
+// zeros per level: 2 levels for 4096 slots, 4 for 16M.
+//
+template < std::size_t N, bool = (N > bitmap_word_bits) >
+class bitmap_level
+{
+private:
+  unsafe_flag< N > free_;
+
+public:
+  constexpr void fill() noexcept
+  {
+    free_.set();
+  }
+
+  // A free slot, N if there is none
+  constexpr std::size_t find() const noexcept
+  {
+    return free_.find_first();
+  }
+
+  constexpr void take(std::size_t i) noexcept
+  {
+    free_.reset(i);
+  }
+
+  constexpr void release(std::size_t i) noexcept
+  {
+    free_.set(i);
+  }
+
+  constexpr bool is_free(std::size_t i) const noexcept
+  {
+    return free_[i];
+  }
+};
+
+template < std::size_t N >
+class bitmap_level< N, true >
+{
+private:
+  static constexpr std::size_t W = bitmap_word_bits;
+
+  unsafe_flag< N > free_;
+  bitmap_level< bitmap_words(N) > summary_;
+
+public:
+  constexpr void fill() noexcept
+  {
+    free_.set();
+    summary_.fill();
+  }
+
+  constexpr std::size_t find() const noexcept
+  {
+    const auto w = summary_.find();
+
+    if (w >= bitmap_words(N))
+      return N;
+
+    return w * W + lowest_bit(free_.word(w));
+  }
+
+  constexpr void take(std::size_t i) noexcept
+  {
+    free_.reset(i);
+
+    if (free_.word(i / W) == 0)
+      summary_.take(i / W);
+  }
+
+  constexpr void release(std::size_t i) noexcept
+  {
+    if (free_.word(i / W) == 0)
+      summary_.release(i / W);
+
+    free_.set(i);
+  }
+
+  constexpr bool is_free(std::size_t i) const noexcept
+  {
+    return free_[i];
+  }
+};
+
+//
+// The lock-free version of bitmap_level on atomic words. The summary bits
+// are hints: a bit whose word turns out to be empty is cleared, and set
+// again if a slot was released in the meantime. All operations are
+// sequentially consistent, which the re-check after clearing a hint needs.
+//
+template < std::size_t N, bool = (N > bitmap_word_bits) >
+class atomic_bitmap_level
+{
+private:
+  using word_type = std::uint64_t;
+
+  static constexpr word_type full =
+      (N % bitmap_word_bits == 0)
+          ? ~word_type(0)
+          : (word_type(1) << (N % bitmap_word_bits)) - 1;
+
+  std::atomic< word_type > word_{0};
+
+public:
+  void fill() noexcept
+  {
+    word_.store(full);
+  }
+
+  // Sets bit i, returns if it was set before
+  bool set(std::size_t i) noexcept
+  {
+    const auto m = word_type(1) << i;
+    return (word_.fetch_or(m) & m) != 0;
+  }
+
+  void clear(std::size_t i) noexcept
+  {
+    word_.fetch_and(~(word_type(1) << i));
+  }
+
+  // A set bit, N if there is none
+  std::size_t find() noexcept
+  {
+    const auto w = word_.load();
+    return (w != 0) ? std::size_t(lowest_bit(w)) : N;
+  }
+
+  // Clears and returns a set bit, N if there is none
+  std::size_t claim() noexcept
+  {
+    auto w = word_.load();
+
+    while (w != 0)
+      if (word_.compare_exchange_weak(w, w & (w - 1)))
+        return std::size_t(lowest_bit(w));
+
+    return N;
+  }
+
+  bool test(std::size_t i) const noexcept
+  {
+    return (word_.load() & (word_type(1) << i)) != 0;
+  }
+};
+
+template < std::size_t N >
+class atomic_bitmap_level< N, true >
+{
+private:
+  using word_type = std::uint64_t;
+
+  static constexpr std::size_t W = bitmap_word_bits;
+  static constexpr std::size_t num_words = bitmap_words(N);
+
+  static constexpr word_type top_mask =
+      (N % W == 0) ? ~word_type(0) : (word_type(1) << (N % W)) - 1;
+
+  std::atomic< word_type > words_[num_words] = {};
+  atomic_bitmap_level< num_words > summary_;
+
+  // Word w was seen empty, its hint is cleared unless a bit came back
+  void hint_empty(std::size_t w) noexcept
+  {
+    summary_.clear(w);
+
+    if (words_[w].load() != 0)
+      summary_.set(w);
+  }
+
+public:
+  void fill() noexcept
+  {
+    for (std::size_t i = 0; i + 1 < num_words; ++i)
+      words_[i].store(~word_type(0));
+
+    words_[num_words - 1].store(top_mask);
+    summary_.fill();
+  }
+
+  bool set(std::size_t i) noexcept
+  {
+    const auto m = word_type(1) << (i % W);
+    const auto prev = words_[i / W].fetch_or(m);
+
+    if (prev == 0)
+      summary_.set(i / W);
+
+    return (prev & m) != 0;
+  }
+
+  void clear(std::size_t i) noexcept
+  {
+    const auto m = word_type(1) << (i % W);
+
+    if ((words_[i / W].fetch_and(~m) & ~m) == 0)
+      hint_empty(i / W);
+  }
+
+  std::size_t find() noexcept
+  {
+    for (;;)
+    {
+      const auto w = summary_.find();
+
+      if (w >= num_words)
+        return N;
+
+      const auto bits = words_[w].load();
+
+      if (bits != 0)
+        return w * W + lowest_bit(bits);
+
+      hint_empty(w);
+    }
+  }
+
+  std::size_t claim() noexcept
+  {
+    for (;;)
+    {
+      const auto w = summary_.find();
+
+      if (w >= num_words)
+        return N;
+
+      auto bits = words_[w].load();
+
+      while (bits != 0)
+      {
+        const auto rest = bits & (bits - 1);
+
+        if (words_[w].compare_exchange_weak(bits, rest))
+        {
+          if (rest == 0)
+            hint_empty(w);
+
+          return w * W + lowest_bit(bits);
+        }
+      }
+
+      hint_empty(w);
+    }
+  }
+
+  bool test(std::size_t i) const noexcept
+  {
+    return (words_[i / W].load() & (word_type(1) << (i % W))) != 0;
+  }
+};
+
+}  // namespace details
+
+//
+// Fixed pool of N slots (e.g. connection IDs or buffer indices), handing out
+// the lowest free slot. allocate() and free() are O(1): one count trailing
+// zeros per level of a hierarchical bitmap, at most 4 levels up to 16M
+// slots.
+//
+// ErrFun is called for out of bounds and double free, see
+// error_functions.hpp.
+//
+template < std::size_t N, typename ErrFun = error_functions::noop >
+class slot_allocator
+{
+private:
+  details::bitmap_level< N > free_;
+  std::size_t used_ = 0;
+
+  using CheckBounds = std::integral_constant<
+      bool, !std::is_same< ErrFun, error_functions::noop >::value >;
+
+public:
+  using size_type = std::size_t;
+
+  constexpr slot_allocator() noexcept : free_{}
+  {
+    free_.fill();
+  }
+
+  // A free slot, capacity() if all slots are in use
+  constexpr size_type allocate() noexcept
+  {
+    const auto i = free_.find();
+
+    if (i < N)
+    {
+      free_.take(i);
+      ++used_;
+    }
+
+    return i;
+  }
+
+  constexpr void free(size_type slot) noexcept(noexcept(ErrFun{}("")))
+  {
+    if
+      ESL_CONSTEXPR_IF(CheckBounds())
+      {
+        if (slot >= N)
+          return ErrFun{}("free out of bounds");
+
+        if (free_.is_free(slot))
+          return ErrFun{}("free of a free slot");
+      }
+
+    free_.release(slot);
+    --used_;
+  }
+
+  // Frees all slots
+  constexpr void reset() noexcept
+  {
+    free_.fill();
+    used_ = 0;
+  }
+
+  constexpr bool is_allocated(size_type slot) const noexcept
+  {
+    return !free_.is_free(slot);
+  }
+
+  constexpr size_type size() const noexcept
+  {
+    return used_;
+  }
+
+  constexpr static size_type capacity() noexcept
+  {
+    return N;
+  }
+
+  constexpr bool empty() const noexcept
+  {
+    return used_ == 0;
+  }
+
+  constexpr bool full() const noexcept
+  {
+    return used_ == N;
+  }
+};
+
+//
+// Lock-free slot_allocator, allocate() and free() may be called from any
+// thread. A slot is handed out to one thread only. When the pool is close to
+// full, allocate() can return capacity() while another thread is freeing a
+// slot, as with any lock-free pool there is no waiting for it.
+//
+template < std::size_t N, typename ErrFun = error_functions::noop >
+class atomic_slot_allocator
+{
+private:
+  static_assert(ATOMIC_LLONG_LOCK_FREE == 2,
+                "64 bit atomics must be lock-free on this target.");
+
+  details::atomic_bitmap_level< N > free_;
+
+  using CheckBounds = std::integral_constant<
+      bool, !std::is_same< ErrFun, error_functions::noop >::value >;
+
+public:
+  using size_type = std::size_t;
+
+  atomic_slot_allocator() noexcept
+  {
+    free_.fill();
+  }
+
+  atomic_slot_allocator(const atomic_slot_allocator&) = delete;
+  atomic_slot_allocator& operator=(const atomic_slot_allocator&) = delete;
+
+  // A free slot, capacity() if none was found
+  size_type allocate() noexcept
+  {
+    return free_.claim();
+  }
+
+  void free(size_type slot) noexcept(noexcept(ErrFun{}("")))
+  {
+    if
+      ESL_CONSTEXPR_IF(CheckBounds())
+    if (slot >= N)
+      return ErrFun{}("free out of bounds");
+
+    const bool was_free = free_.set(slot);
+
+    if
+      ESL_CONSTEXPR_IF(CheckBounds())
+    if (was_free)
+      ErrFun{}("free of a free slot");
+  }
+
+  bool is_allocated(size_type slot) const noexcept
+  {
+    return !free_.test(slot);
+  }
+
+  constexpr static size_type capacity() noexcept
+  {
+    return N;
+  }
+};
+
+}  // namespace esl
@@ -13,6 +13,7 @@
 
 #include "../helpers/error_functions.hpp"
 #include "../helpers/feature_defs.hpp"
+#include "../helpers/utils.hpp"
 
 namespace esl
 {
@@ -50,6 +51,33 @@ protected:
   using CheckBounds = std::integral_constant<
       bool, !std::is_same< ErrFun, error_functions::noop >::value >;
 
+  //
+  // Moves n elements from src to dst (dst < src), ending the lifetime of the
+  // source elements. Relocatable types are moved with a single memmove.
+  //
+  static void relocate(T *dst, T *src, size_type n, std::true_type) noexcept
+  {
+    std::memmove(static_cast< void * >(dst), src, n * sizeof(T));
+  }
+
+  // Element by element, each element can still be relocatable at run-time
+  static void relocate(T *dst, T *src, size_type n, std::false_type) noexcept(
+      std::is_nothrow_move_constructible< T >::value)
+  {
+    for (auto idx = 0U; idx < n; ++idx)
+    {
+      if (is_relocatable(src[idx]))
+      {
+        std::memcpy(static_cast< void * >(&dst[idx]), &src[idx], sizeof(T));
+      }
+      else
+      {
+        new (&dst[idx]) T(std::move(src[idx]));
+        (&src[idx])->~T();
+      }
+    }
+  }
+
 public:
   //
   // Constructor / Destructor
@@ -215,7 +243,7 @@ public:
     if (full())
       ErrFun{}("push_back on full vector");
 
-    buffer_[curr_idx_] = std::forward< T1 >(val);
+    new (&buffer_[curr_idx_]) T(std::forward< T1 >(val));
     ++curr_idx_;
   }
 
@@ -252,6 +280,22 @@ public:
     curr_idx_ = 0;
   }
 
+  constexpr void resize(size_type count) noexcept(noexcept(ErrFun{}("")))
+  {
+    if
+      ESL_CONSTEXPR_IF(CheckBounds())
+    if (count > capacity())
+      ErrFun{}("resize larger than capacity");
+
+    // Destroy elements past the new size
+    for (; curr_idx_ > count; --curr_idx_)
+      (&buffer_[curr_idx_ - 1])->~T();
+
+    // Default construct new elements
+    for (; curr_idx_ < count; ++curr_idx_)
+      new (&buffer_[curr_idx_]) T();
+  }
+
   constexpr void pop_back() noexcept(noexcept(ErrFun{}("")))
   {
     if
@@ -290,14 +334,8 @@ public:
       curr->~T();
 
     // Move elements
-    auto next = end;
-
-    while (next != vend)
-    {
-      *begin = *next;
-      ++begin;
-      ++next;
-    }
+    relocate(begin, end, std::distance(end, vend),
+             is_trivially_relocatable< T >{});
 
     // Update count
     curr_idx_ -= dist;
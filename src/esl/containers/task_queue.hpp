@@ -0,0 +1,226 @@
+//          Copyright Emil Fresk 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#include "allocate.hpp"
+#include "ring_buffer.hpp"
+#include "../helpers/error_functions.hpp"
+#include "../helpers/feature_defs.hpp"
+
+namespace esl
+{
+//
+// task_queue definition
+//
+template < typename Task, typename ErrFun = error_functions::noop >
+class task_queue;
+
+//
+// allocate specialized trait to force task_queues to be power of 2
+//
+template < typename T, typename F, std::size_t Capacity >
+struct allocate_capacity_check< task_queue< T, F >, Capacity >
+    : std::integral_constant< bool, details::is_power_of_2(Capacity) >
+{
+  static_assert(details::is_power_of_2(Capacity),
+                "task_queue only accepts capacity in powers of 2.");
+};
+
+//
+// FIFO of deferred tasks, stored in place in a ring buffer so deferring work
+// never allocates. Unlike ring_buffer it handles the lifetime of the
+// elements, tasks are constructed on push and destroyed after they have run.
+//
+template < typename Task, typename ErrFun >
+class task_queue
+{
+protected:
+  Task* buffer_;
+  std::size_t head_idx_ = 0;
+  std::size_t tail_idx_ = 0;
+  std::size_t mask_ = 0;
+
+  using CheckBounds = std::integral_constant<
+      bool, !std::is_same< ErrFun, error_functions::noop >::value >;
+
+  constexpr void increment_head() noexcept
+  {
+    head_idx_ = (head_idx_ + 1) & mask_;
+  }
+
+  constexpr void increment_tail() noexcept
+  {
+    tail_idx_ = (tail_idx_ + 1) & mask_;
+  }
+
+  // Pops the task at the tail and runs it. The task is moved out first, so
+  // a task that runs the queue or throws has already been removed.
+  void run_tail()
+  {
+    Task t(std::move(buffer_[tail_idx_]));
+
+    buffer_[tail_idx_].~Task();
+    increment_tail();
+
+    t();
+  }
+
+public:
+  //
+  // Standard type definitions
+  //
+  using size_type = std::size_t;
+  using value_type = Task;
+
+  //
+  // Constructor / Destructor
+  //
+  constexpr task_queue(Task* buffer,
+                       size_type capacity) noexcept(noexcept(ErrFun{}("")))
+      : buffer_{buffer}, mask_{capacity - 1}
+  {
+    if
+      ESL_CONSTEXPR_IF(CheckBounds())
+      {
+        if (!details::is_power_of_2(capacity))
+          ErrFun{}("construction with size not a power of 2");
+
+        if (buffer == nullptr)
+          ErrFun{}("construction with nullptr");
+      }
+  }
+
+  task_queue(const task_queue&) = delete;
+  task_queue& operator=(const task_queue&) = delete;
+
+  ~task_queue() noexcept
+  {
+    clear();
+  }
+
+  //
+  // Element access
+  //
+  constexpr Task& front() noexcept(noexcept(ErrFun{}("")))
+  {
+    if
+      ESL_CONSTEXPR_IF(CheckBounds())
+    if (empty())
+      ErrFun{}("front on empty queue");
+
+    return buffer_[tail_idx_];
+  }
+
+  //
+  // Capacity
+  //
+  constexpr size_type size() const noexcept
+  {
+    return (head_idx_ - tail_idx_ + mask_ + 1) & mask_;
+  }
+
+  constexpr size_type capacity() const noexcept
+  {
+    return mask_;
+  }
+
+  constexpr size_type free() const noexcept
+  {
+    return capacity() - size();
+  }
+
+  constexpr bool empty() const noexcept
+  {
+    return (head_idx_ == tail_idx_);
+  }
+
+  constexpr bool full() const noexcept
+  {
+    return (size() == capacity());
+  }
+
+  //
+  // Modifiers
+  //
+  template < typename... Args >
+  void emplace_back(Args&&... args) noexcept(
+      noexcept(ErrFun{}("")) &&
+      std::is_nothrow_constructible< Task, Args... >::value)
+  {
+    if
+      ESL_CONSTEXPR_IF(CheckBounds())
+    if (full())
+      ErrFun{}("emplace_back on full queue");
+
+    new (&buffer_[head_idx_]) Task(std::forward< Args >(args)...);
+    increment_head();
+  }
+
+  void push_back(Task&& t) noexcept(
+      noexcept(ErrFun{}("")) &&
+      std::is_nothrow_move_constructible< Task >::value)
+  {
+    emplace_back(std::move(t));
+  }
+
+  // Destroys the oldest task without running it
+  void pop() noexcept(noexcept(ErrFun{}("")))
+  {
+    if
+      ESL_CONSTEXPR_IF(CheckBounds())
+    if (empty())
+      ErrFun{}("pop on empty queue");
+
+    buffer_[tail_idx_].~Task();
+    increment_tail();
+  }
+
+  void clear() noexcept
+  {
+    while (!empty())
+    {
+      buffer_[tail_idx_].~Task();
+      increment_tail();
+    }
+  }
+
+  //
+  // Execution
+  //
+
+  // Runs the oldest task, returns false if the queue was empty
+  bool run_one()
+  {
+    if (empty())
+      return false;
+
+    run_tail();
+
+    return true;
+  }
+
+  // Runs up to max_tasks tasks in FIFO order, returns the number of tasks
+  // run. Tasks pushed while draining are left for the next drain, unless a
+  // task drains the queue itself.
+  size_type drain(size_type max_tasks = static_cast< size_type >(-1))
+  {
+    const auto s = size();
+    const auto n = (max_tasks < s) ? max_tasks : s;
+
+    size_type i = 0;
+
+    for (; i < n && !empty(); ++i)
+      run_tail();
+
+    return i;
+  }
+};
+
+}  // namespace esl
@@ -7,18 +7,29 @@
 
 // Containers
 #include <esl/containers/allocate.hpp>
+#include <esl/containers/packed_array.hpp>
 #include <esl/containers/ring_buffer.hpp>
+#include <esl/containers/slot_allocator.hpp>
 #include <esl/containers/static_vector.hpp>
+#include <esl/containers/task_queue.hpp>
 
 // Math
+#include <esl/math/fixed.hpp>
 #include <esl/math/vector.hpp>
 #include <esl/math/quaternion.hpp>
+#include <esl/math/matrix.hpp>
+#include <esl/math/batch.hpp>
+#include <esl/math/span.hpp>
 
 // Callable
+#include <esl/callable/dispatch_table.hpp>
 #include <esl/callable/function.hpp>
 #include <esl/callable/function_view.hpp>
+#include <esl/callable/signal.hpp>
+#include <esl/callable/task.hpp>
 
 // Helpers
 #include <esl/helpers/singleton.hpp>
 #include <esl/helpers/unsafe_flag.hpp>
 #include <esl/helpers/flag_enum.hpp>
+#include <esl/helpers/atomic_flag_enum.hpp>
@@ -0,0 +1,143 @@
+//          Copyright Emil Fresk 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <initializer_list>
+#include <type_traits>
+#include <esl/helpers/flag_enum.hpp>
+#include <esl/helpers/utils.hpp>
+
+namespace esl
+{
+//
+// A flag_enum that can be shared between threads without a lock, e.g. status
+// flags set by one thread and polled by another. The flags are bits of one
+// std::atomic word and every operation is a single atomic instruction,
+// multi-flag operations build the mask first and touch the word once.
+//
+// Modifications are acquire-release and reads are acquire, so data written
+// before a flag is set is visible to a thread that sees the flag.
+//
+template < typename Enum >
+class atomic_flag_enum
+{
+public:
+  static_assert(std::is_enum< Enum >::value,
+                "The specified type is not an enum.");
+  static_assert(details::flag_enum_bits< Enum > <= 64,
+                "flag_enum_max must fit in a 64 bit atomic word.");
+
+  // 32 bits unless flag_enum_max needs more
+  using word_type =
+      std::conditional_t< (details::flag_enum_bits< Enum > <= 32),
+                          std::uint32_t, std::uint64_t >;
+
+private:
+  static_assert((sizeof(word_type) == 4 && ATOMIC_INT_LOCK_FREE == 2) ||
+                    (sizeof(word_type) == 8 && ATOMIC_LLONG_LOCK_FREE == 2),
+                "The flag word must be lock-free on this target.");
+
+  std::atomic< word_type > flags_;
+
+  template < typename... Flags >
+  static constexpr word_type mask(Flags... flags) noexcept
+  {
+    static_assert(
+        details::all_true<
+            std::is_same< std::decay_t< Flags >, Enum >::value... >::value,
+        "Not all parameters are of the specified enum type.");
+    static_assert(sizeof...(Flags) > 0, "At least one flag is required.");
+
+    word_type m = 0;
+
+    (void)std::initializer_list< int >{
+        (m |= word_type(1) << static_cast< std::size_t >(flags), 0)...};
+
+    return m;
+  }
+
+public:
+  // Constructors
+  constexpr atomic_flag_enum() noexcept : flags_{0}
+  {
+  }
+
+  template < typename... Flags >
+  explicit atomic_flag_enum(Flags&&... flags) noexcept
+      : flags_{mask(flags...)}
+  {
+  }
+
+  atomic_flag_enum(const atomic_flag_enum&) = delete;
+  atomic_flag_enum& operator=(const atomic_flag_enum&) = delete;
+
+  // Set specified flags
+  template < typename... Flags >
+  void set(Flags&&... flags) noexcept
+  {
+    flags_.fetch_or(mask(flags...), std::memory_order_acq_rel);
+  }
+
+  // Clear all flags
+  void clear() noexcept
+  {
+    flags_.store(0, std::memory_order_release);
+  }
+
+  // Clear specified flags
+  template < typename... Flags >
+  void clear(Flags&&... flags) noexcept
+  {
+    flags_.fetch_and(word_type(~mask(flags...)), std::memory_order_acq_rel);
+  }
+
+  // Sets the flag and returns if it was set before, only one of several
+  // threads racing to set a flag gets false
+  bool test_and_set(Enum flag) noexcept
+  {
+    const auto m = mask(flag);
+    return (flags_.fetch_or(m, std::memory_order_acq_rel) & m) != 0;
+  }
+
+  // Clears the flag and returns if it was set before, e.g. to consume an
+  // event exactly once
+  bool test_and_clear(Enum flag) noexcept
+  {
+    const auto m = mask(flag);
+    return (flags_.fetch_and(word_type(~m), std::memory_order_acq_rel) & m) !=
+           0;
+  }
+
+  bool operator[](Enum flag) const noexcept
+  {
+    return (flags_.load(std::memory_order_acquire) & mask(flag)) != 0;
+  }
+
+  // Checks if all the specified flags are set, in one read
+  template < typename... Flags >
+  bool all(Flags&&... flags) const noexcept
+  {
+    const auto m = mask(flags...);
+    return (flags_.load(std::memory_order_acquire) & m) == m;
+  }
+
+  // Checks if any of the specified flags are set, in one read
+  template < typename... Flags >
+  bool any(Flags&&... flags) const noexcept
+  {
+    return (flags_.load(std::memory_order_acquire) & mask(flags...)) != 0;
+  }
+
+  // Checks if all flags are cleared
+  bool none() const noexcept
+  {
+    return flags_.load(std::memory_order_acquire) == 0;
+  }
+};
+
+}  // namespace esl
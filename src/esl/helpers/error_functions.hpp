@@ -19,7 +19,7 @@ struct noop
 
 struct halt
 {
-  void operator()(const char* msg) const noexcept
+  [[noreturn]] void operator()(const char* msg) const noexcept
   {
     (void)msg;
     while (1)
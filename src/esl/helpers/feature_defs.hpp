@@ -14,3 +14,19 @@
 #else
 #define ESL_CONSTEXPR_IF constexpr
 #endif
+
+#if defined(__cpp_nontype_template_parameter_auto) && \
+    (__cpp_nontype_template_parameter_auto >= 201606)
+#define ESL_TEMPLATE_AUTO_AVAILABLE
+#endif
+
+#if defined(__has_builtin)
+#if __has_builtin(__builtin_is_constant_evaluated)
+#define ESL_IS_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+#define ESL_IS_CONSTANT_EVALUATED_AVAILABLE
+#endif
+#endif
+
+#if !defined(ESL_IS_CONSTANT_EVALUATED)
+#define ESL_IS_CONSTANT_EVALUATED() false
+#endif
@@ -7,54 +7,145 @@
 
 #include <cstdint>
 #include <type_traits>
-#include <bitset>
+#include <cstddef>
+#include <iterator>
 #include <initializer_list>
 #include <esl/helpers/unsafe_flag.hpp>
 #include <esl/helpers/utils.hpp>
 
 namespace esl
 {
+//
+// The largest enumerator used as a flag, which sizes the storage of
+// flag_enum. Without a specialization every bit of the underlying type can
+// be a flag. Specialize it for flag enums to store them in the smallest
+// word that fits:
+//
+//   namespace esl
+//   {
+//   template <>
+//   struct flag_enum_max< flags >
+//       : std::integral_constant< flags, flags::C > {};
+//   }
+//
+template < typename Enum >
+struct flag_enum_max
+    : std::integral_constant< std::size_t, sizeof(Enum) * 8 - 1 >
+{
+};
+
+namespace details
+{
+template < typename Enum >
+constexpr std::size_t flag_enum_bits =
+    static_cast< std::size_t >(flag_enum_max< Enum >::value) + 1;
+}  // namespace details
+
 //
 // A class to view an enum as a set of flags, stored as single bits.
 // Used to replace "flags |= some_flag" or "flags &= ~some_flag" type of code
 // with a type safe alternative.
 //
+// Up to 64 flags fit one word, multi-flag checks build the mask of the
+// flags first and test it with one and / compare.
+//
 template < typename Enum >
 class flag_enum
 {
-private:
-  // Bitset with the same size as the enum
-  unsafe_flag< sizeof(Enum) * 8 > flags_;
-
 public:
   static_assert(std::is_enum< Enum >::value,
                 "The specified type is not an enum.");
 
+  using storage_type = unsafe_flag< details::flag_enum_bits< Enum > >;
+
+private:
+  // One bit per flag, up to the largest enumerator
+  storage_type flags_;
+
+  template < typename... Flags >
+  static constexpr storage_type mask(Flags... flags) noexcept
+  {
+    static_assert(
+        details::all_true<
+            std::is_same< std::decay_t< Flags >, Enum >::value... >::value,
+        "Not all parameters are of the specified enum type.");
+    static_assert(sizeof...(Flags) > 0, "At least one flag is required.");
+
+    storage_type m;
+
+    (void)std::initializer_list< int >{
+        ((void)m.set(static_cast< std::size_t >(flags)), 0)...};
+
+    return m;
+  }
+
+public:
+  //
+  // Iterates over the set flags, lowest first
+  //
+  class const_iterator
+  {
+  private:
+    const storage_type* flags_;
+    std::size_t idx_;
+
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = Enum;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const Enum*;
+    using reference = Enum;
+
+    constexpr const_iterator(const storage_type* flags,
+                             std::size_t idx) noexcept
+        : flags_(flags), idx_(idx)
+    {
+    }
+
+    constexpr Enum operator*() const noexcept
+    {
+      return static_cast< Enum >(idx_);
+    }
+
+    constexpr const_iterator& operator++() noexcept
+    {
+      idx_ = flags_->find_next(idx_);
+      return *this;
+    }
+
+    constexpr const_iterator operator++(int) noexcept
+    {
+      auto r = *this;
+      ++(*this);
+      return r;
+    }
+
+    constexpr bool operator==(const const_iterator& rhs) const noexcept
+    {
+      return idx_ == rhs.idx_;
+    }
+
+    constexpr bool operator!=(const const_iterator& rhs) const noexcept
+    {
+      return idx_ != rhs.idx_;
+    }
+  };
+
   // Constructors
   constexpr flag_enum() noexcept : flags_()
   {
   }
 
   template < typename... Flags >
-  constexpr flag_enum(Flags&&... flags) noexcept
+  constexpr flag_enum(Flags&&... flags) noexcept : flags_(mask(flags...))
   {
-    set(flags...);
   }
 
   // Set specified flags
   template < typename... Flags >
   constexpr void set(Flags&&... flags) noexcept
   {
-    // Error checking
-    static_assert(
-        details::all_true<
-            std::is_same< std::decay_t< Flags >, Enum >::value... >::value,
-        "Not all parameters are of the specified enum type.");
-    static_assert(sizeof...(Flags) > 0, "At least one flag is required.");
-
-    // A way to unroll the input pack of flags
-    (void)std::initializer_list< int >{
-        ((void)flags_.set(static_cast< std::size_t >(flags)), 0)...};
+    flags_ |= mask(flags...);
   }
 
   // Clear all flags
@@ -72,50 +163,22 @@ public:
   template < typename... Flags >
   constexpr void clear(Flags&&... flags) noexcept
   {
-    static_assert(
-        details::all_true<
-            std::is_same< std::decay_t< Flags >, Enum >::value... >::value,
-        "Not all parameters are of the specified enum type.");
-    static_assert(sizeof...(Flags) > 0, "At least one flag is required.");
-
-    (void)std::initializer_list< int >{
-        ((void)flags_.reset(static_cast< std::size_t >(flags)), 0)...};
+    flags_ &= ~mask(flags...);
   }
 
   // Checks if all the specified flags are set
   template < typename... Flags >
   constexpr bool all(Flags&&... flags) const noexcept
   {
-    static_assert(
-        details::all_true<
-            std::is_same< std::decay_t< Flags >, Enum >::value... >::value,
-        "Not all parameters are of the specified enum type.");
-    static_assert(sizeof...(Flags) > 0, "At least one flag is required.");
-
-    bool ret = true;
-
-    (void)std::initializer_list< int >{
-        (ret &= flags_[static_cast< std::size_t >(flags)], 0)...};
-
-    return ret;
+    const auto m = mask(flags...);
+    return (flags_ & m) == m;
   }
 
   // Checks if any of the specified flags are set
   template < typename... Flags >
   constexpr bool any(Flags&&... flags) const noexcept
   {
-    static_assert(
-        details::all_true<
-            std::is_same< std::decay_t< Flags >, Enum >::value... >::value,
-        "Not all parameters are of the specified enum type.");
-    static_assert(sizeof...(Flags) > 0, "At least one flag is required.");
-
-    bool ret = false;
-
-    (void)std::initializer_list< int >{
-        (ret |= flags_[static_cast< std::size_t >(flags)], 0)...};
-
-    return ret;
+    return (flags_ & mask(flags...)).any();
   }
 
   // Checks if all flags are cleared
@@ -123,6 +186,22 @@ public:
   {
     return flags_.none();
   }
+
+  // Number of set flags
+  constexpr std::size_t count() const noexcept
+  {
+    return flags_.count();
+  }
+
+  constexpr const_iterator begin() const noexcept
+  {
+    return {&flags_, flags_.find_first()};
+  }
+
+  constexpr const_iterator end() const noexcept
+  {
+    return {&flags_, storage_type::size()};
+  }
 };
 
 }  // namespace esl
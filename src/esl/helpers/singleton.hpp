@@ -5,6 +5,14 @@
 
 #pragma once
 
+#include <atomic>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include "error_functions.hpp"
+#include "feature_defs.hpp"
+
 namespace esl
 {
 namespace details
@@ -29,4 +37,243 @@ constexpr C& get_singleton()
   return details::singleton< C >::instance();
 }
 
+//
+// Singleton with an explicit lifecycle: constructed by init(), e.g. first
+// thing in main, and destroyed by destroy(), so construction and teardown
+// order is up to the program. get() is the address of static storage, no
+// guard variable is checked on access as with get_singleton.
+//
+// init() is thread-safe, one caller constructs and the others wait for it.
+// Threads started after init() can use get() directly, threads running
+// during init() must see initialized() first. destroy() must not race with
+// users of the instance.
+//
+// ErrFun is called for get() before init(), init() of an instance that was
+// already constructed when the call started (concurrent callers waiting for
+// the construction are fine) and destroy() without init(), see
+// error_functions.hpp. The default noop removes the checks.
+//
+template < class C, typename ErrFun = error_functions::noop >
+class static_singleton
+{
+private:
+  enum : int
+  {
+    empty,
+    busy,
+    ready
+  };
+
+  using CheckBounds = std::integral_constant<
+      bool, !std::is_same< ErrFun, error_functions::noop >::value >;
+
+  alignas(C) static unsigned char storage_[sizeof(C)];
+  static std::atomic< int > state_;
+
+  static C& instance() noexcept
+  {
+    return *reinterpret_cast< C* >(storage_);
+  }
+
+  // Puts the state back to empty if the constructor throws
+  struct init_guard
+  {
+    bool done = false;
+
+    ~init_guard()
+    {
+      if (!done)
+        state_.store(empty, std::memory_order_release);
+    }
+  };
+
+public:
+  static_singleton() = delete;
+
+  // Constructs the instance from args, returns it
+  template < typename... Args >
+  static C& init(Args&&... args)
+  {
+    while (true)
+    {
+      int expected = empty;
+
+      if (state_.compare_exchange_strong(expected, busy,
+                                         std::memory_order_acquire))
+      {
+        init_guard guard;
+        new (storage_) C(std::forward< Args >(args)...);
+        guard.done = true;
+
+        state_.store(ready, std::memory_order_release);
+        return instance();
+      }
+
+      // Constructed before this call, not a race with the constructor
+      if (expected == ready)
+      {
+        if
+          ESL_CONSTEXPR_IF(CheckBounds())
+        ErrFun{}("singleton initialized twice");
+
+        return instance();
+      }
+
+      // Another thread is constructing or destroying the instance, if it
+      // ends up empty (destroyed or the constructor threw) try again
+      while ((expected = state_.load(std::memory_order_acquire)) == busy)
+        std::this_thread::yield();
+
+      if (expected == ready)
+        return instance();
+    }
+  }
+
+  // Destroys the instance, init() can be called again after
+  static void destroy() noexcept(noexcept(ErrFun{}("")) &&
+                                 std::is_nothrow_destructible< C >::value)
+  {
+    int expected = ready;
+
+    if (!state_.compare_exchange_strong(expected, busy,
+                                        std::memory_order_acquire))
+    {
+      if
+        ESL_CONSTEXPR_IF(CheckBounds())
+      ErrFun{}("destroy of an uninitialized singleton");
+
+      return;
+    }
+
+    instance().~C();
+    state_.store(empty, std::memory_order_release);
+  }
+
+  static bool initialized() noexcept
+  {
+    return state_.load(std::memory_order_acquire) == ready;
+  }
+
+  static C& get() noexcept(noexcept(ErrFun{}("")))
+  {
+    if
+      ESL_CONSTEXPR_IF(CheckBounds())
+    if (state_.load(std::memory_order_relaxed) != ready)
+      ErrFun{}("get of an uninitialized singleton");
+
+    return instance();
+  }
+};
+
+template < class C, typename ErrFun >
+alignas(C) unsigned char static_singleton< C, ErrFun >::storage_[sizeof(C)];
+
+template < class C, typename ErrFun >
+std::atomic< int > static_singleton< C, ErrFun >::state_{empty};
+
+//
+// One instance per thread with the same explicit lifecycle, each thread
+// calls init() and destroy() for its own instance. get() is an offset from
+// the thread pointer, unlike a function-local thread_local which is checked
+// on every access.
+//
+template < class C, typename ErrFun = error_functions::noop >
+class thread_singleton
+{
+private:
+  using CheckBounds = std::integral_constant<
+      bool, !std::is_same< ErrFun, error_functions::noop >::value >;
+
+  alignas(C) static thread_local unsigned char storage_[sizeof(C)];
+  static thread_local bool initialized_;
+
+  static C& instance() noexcept
+  {
+    return *reinterpret_cast< C* >(storage_);
+  }
+
+public:
+  thread_singleton() = delete;
+
+  template < typename... Args >
+  static C& init(Args&&... args)
+  {
+    if (initialized_)
+    {
+      if
+        ESL_CONSTEXPR_IF(CheckBounds())
+      ErrFun{}("singleton initialized twice");
+    }
+    else
+    {
+      new (storage_) C(std::forward< Args >(args)...);
+      initialized_ = true;
+    }
+
+    return instance();
+  }
+
+  static void destroy() noexcept(noexcept(ErrFun{}("")) &&
+                                 std::is_nothrow_destructible< C >::value)
+  {
+    if (!initialized_)
+    {
+      if
+        ESL_CONSTEXPR_IF(CheckBounds())
+      ErrFun{}("destroy of an uninitialized singleton");
+
+      return;
+    }
+
+    initialized_ = false;
+    instance().~C();
+  }
+
+  static bool initialized() noexcept
+  {
+    return initialized_;
+  }
+
+  static C& get() noexcept(noexcept(ErrFun{}("")))
+  {
+    if
+      ESL_CONSTEXPR_IF(CheckBounds())
+    if (!initialized_)
+      ErrFun{}("get of an uninitialized singleton");
+
+    return instance();
+  }
+};
+
+template < class C, typename ErrFun >
+alignas(C) thread_local unsigned char
+    thread_singleton< C, ErrFun >::storage_[sizeof(C)];
+
+template < class C, typename ErrFun >
+thread_local bool thread_singleton< C, ErrFun >::initialized_ = false;
+
+//
+// Initializes a static_singleton or thread_singleton for a scope, e.g. in
+// main, destroying it at the end of the scope. Several scopes are torn down
+// in reverse order of construction.
+//
+template < typename Singleton >
+class singleton_scope
+{
+public:
+  template < typename... Args >
+  explicit singleton_scope(Args&&... args)
+  {
+    Singleton::init(std::forward< Args >(args)...);
+  }
+
+  ~singleton_scope()
+  {
+    Singleton::destroy();
+  }
+
+  singleton_scope(const singleton_scope&) = delete;
+  singleton_scope& operator=(const singleton_scope&) = delete;
+};
+
 }  // namespace esl
@@ -5,103 +5,298 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
+#include <type_traits>
+#include "utils.hpp"
 
 namespace esl
 {
+namespace details
+{
+// Number of set bits. x86 without POPCNT (e.g. plain x86-64) would call a
+// library function per word, the bit-parallel sum is branch free and
+// vectorizes in loops.
+constexpr int popcount(std::uint64_t x) noexcept
+{
+#if defined(__GNUC__) && \
+    (defined(__POPCNT__) || !(defined(__x86_64__) || defined(__i386__)))
+  return __builtin_popcountll(x);
+#else
+  x = x - ((x >> 1) & 0x5555555555555555u);
+  x = (x & 0x3333333333333333u) + ((x >> 2) & 0x3333333333333333u);
+  x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0fu;
+  x += x >> 8;
+  x += x >> 16;
+  x += x >> 32;
+
+  return int(x & 0x7f);
+#endif
+}
+
+// Index of the lowest set bit, x != 0
+constexpr int lowest_bit(std::uint64_t x) noexcept
+{
+#if defined(__GNUC__)
+  return __builtin_ctzll(x);
+#else
+  int n = 0;
+
+  for (; (x & 1) == 0; x >>= 1)
+    ++n;
+
+  return n;
+#endif
+}
+
+}  // namespace details
+
 //
 // Unsafe flag implementation, used to replace flags |= some_flag.
 // Does not check if set / reset goes out of bound on the storage.
 //
+// Up to 64 flags are stored in the smallest word that holds them, larger
+// sets in 64 bit words. The bits past N are always zero, so whole-set
+// operations work a word at a time (loops over the words of large sets are
+// vectorized by the compiler) and find_first / find_next skip empty words
+// with count-trailing-zeros.
+//
 template < std::size_t N >
 class unsafe_flag
 {
+public:
+  using word_type = std::conditional_t<
+      (N < 64), uint_least_t< (std::uint64_t(1) << (N % 64)) - 1 >,
+      std::uint64_t >;
+
+  static constexpr std::size_t bits_per_word = sizeof(word_type) * 8;
+  static constexpr std::size_t num_words =
+      (N + bits_per_word - 1) / bits_per_word;
+
 private:
-  // Sets the N_bits number of top bits
-  static constexpr std::uint32_t set_N_top_bits(std::size_t N_bits)
-  {
-    std::uint32_t r = 0;
+  static_assert(N > 0, "At least one flag is needed");
 
-    for (auto i = 0U; i < N_bits; i++)
-      r |= (1 << (31 - i));
+  static constexpr word_type all_ones = word_type(~word_type(0));
 
-    return r;
-  }
+  // Valid bits of the last word
+  static constexpr word_type top_mask =
+      (N % bits_per_word == 0)
+          ? all_ones
+          : word_type((word_type(1) << (N % bits_per_word)) - 1);
 
-  // Constants
-  static const constexpr auto N32 = (N + 31) / 32;
-  static const constexpr std::uint32_t top_mask =
-      ~set_N_top_bits(32 - (N % 32));
+  static constexpr word_type bit(std::size_t idx) noexcept
+  {
+    return word_type(word_type(1) << (idx % bits_per_word));
+  }
 
   // Storage for the flags
-  std::uint32_t storage_[N32];
+  word_type storage_[num_words];
 
 public:
   constexpr unsafe_flag() noexcept : storage_{}
   {
   }
 
+  // Number of flags
+  constexpr static std::size_t size() noexcept
+  {
+    return N;
+  }
+
   // Set all flags
   constexpr void set() noexcept
   {
-    for (auto i = 0U; i < N32 - 1; ++i)
-      storage_[i] = 0xffffffff;
+    for (auto i = 0U; i < num_words - 1; ++i)
+      storage_[i] = all_ones;
 
-    storage_[N32 - 1] = top_mask;
+    storage_[num_words - 1] = top_mask;
   }
 
   // Set a flag at a specific index
   constexpr void set(const std::size_t idx) noexcept
   {
-    storage_[idx / 32] |= (1 << (idx % 32));
+    storage_[idx / bits_per_word] |= bit(idx);
   }
 
   // Reset all flags
   constexpr void reset() noexcept
   {
-    for (auto i = 0U; i < N32; ++i)
+    for (auto i = 0U; i < num_words; ++i)
       storage_[i] = 0;
   }
 
   // Reset a flag as a specific index
   constexpr void reset(const std::size_t idx) noexcept
   {
-    storage_[idx / 32] &= ~(1 << (idx % 32));
+    storage_[idx / bits_per_word] &= word_type(~bit(idx));
+  }
+
+  // Flip all flags
+  constexpr void flip() noexcept
+  {
+    for (auto i = 0U; i < num_words; ++i)
+      storage_[i] = word_type(~storage_[i]);
+
+    storage_[num_words - 1] &= top_mask;
   }
 
   // Flip a flag at a specific index
   constexpr void flip(const std::size_t idx) noexcept
   {
-    storage_[idx / 32] ^= (1 << (idx % 32));
+    storage_[idx / bits_per_word] ^= bit(idx);
   }
 
   // Check if no flags are set
   constexpr bool none() const noexcept
   {
-    for (auto i = 0U; i < N32; ++i)
-      if (storage_[i] != 0)
-        return false;
+    word_type r = 0;
+
+    for (auto i = 0U; i < num_words; ++i)
+      r |= storage_[i];
 
-    return true;
+    return r == 0;
+  }
+
+  // Check if any flag is set
+  constexpr bool any() const noexcept
+  {
+    return !none();
   }
 
   // Check if all flags are set
   constexpr bool all() const noexcept
   {
-    for (auto i = 0U; i < N32 - 1; ++i)
-      if (storage_[i] != 0xffffffff)
-        return false;
+    word_type r = all_ones;
 
-    if (storage_[N32 - 1] != top_mask)
-      return false;
+    for (auto i = 0U; i < num_words - 1; ++i)
+      r &= storage_[i];
 
-    return true;
+    return r == all_ones && storage_[num_words - 1] == top_mask;
+  }
+
+  // Number of set flags
+  constexpr std::size_t count() const noexcept
+  {
+    std::size_t n = 0;
+
+    for (auto i = 0U; i < num_words; ++i)
+      n += details::popcount(storage_[i]);
+
+    return n;
+  }
+
+  // Index of the first set flag, size() if none is set
+  constexpr std::size_t find_first() const noexcept
+  {
+    for (auto i = 0U; i < num_words; ++i)
+      if (storage_[i] != 0)
+        return i * bits_per_word + details::lowest_bit(storage_[i]);
+
+    return N;
+  }
+
+  // Index of the first set flag after idx, size() if there is none
+  constexpr std::size_t find_next(const std::size_t idx) const noexcept
+  {
+    const auto next = idx + 1;
+
+    if (next >= N)
+      return N;
+
+    auto i = next / bits_per_word;
+
+    // The bits below next are masked away in the first word
+    word_type w = storage_[i] & word_type(~(bit(next) - 1));
+
+    while (w == 0)
+    {
+      if (++i == num_words)
+        return N;
+
+      w = storage_[i];
+    }
+
+    return i * bits_per_word + details::lowest_bit(w);
   }
 
   // Access a specific flag and check if it's set
   constexpr bool operator[](const std::size_t idx) const noexcept
   {
-    return storage_[idx / 32] & (1 << (idx % 32));
+    return (storage_[idx / bits_per_word] & bit(idx)) != 0;
+  }
+
+  // Word access, bit i of word w is flag w * bits_per_word + i
+  constexpr word_type word(const std::size_t w) const noexcept
+  {
+    return storage_[w];
+  }
+
+  //
+  // Operations between sets
+  //
+  constexpr unsafe_flag& operator&=(const unsafe_flag& rhs) noexcept
+  {
+    for (auto i = 0U; i < num_words; ++i)
+      storage_[i] &= rhs.storage_[i];
+
+    return *this;
+  }
+
+  constexpr unsafe_flag& operator|=(const unsafe_flag& rhs) noexcept
+  {
+    for (auto i = 0U; i < num_words; ++i)
+      storage_[i] |= rhs.storage_[i];
+
+    return *this;
+  }
+
+  constexpr unsafe_flag& operator^=(const unsafe_flag& rhs) noexcept
+  {
+    for (auto i = 0U; i < num_words; ++i)
+      storage_[i] ^= rhs.storage_[i];
+
+    return *this;
+  }
+
+  constexpr friend unsafe_flag operator&(unsafe_flag lhs,
+                                         const unsafe_flag& rhs) noexcept
+  {
+    return lhs &= rhs;
+  }
+
+  constexpr friend unsafe_flag operator|(unsafe_flag lhs,
+                                         const unsafe_flag& rhs) noexcept
+  {
+    return lhs |= rhs;
+  }
+
+  constexpr friend unsafe_flag operator^(unsafe_flag lhs,
+                                         const unsafe_flag& rhs) noexcept
+  {
+    return lhs ^= rhs;
+  }
+
+  constexpr friend unsafe_flag operator~(unsafe_flag rhs) noexcept
+  {
+    rhs.flip();
+    return rhs;
+  }
+
+  constexpr friend bool operator==(const unsafe_flag& lhs,
+                                   const unsafe_flag& rhs) noexcept
+  {
+    word_type r = 0;
+
+    for (auto i = 0U; i < num_words; ++i)
+      r |= lhs.storage_[i] ^ rhs.storage_[i];
+
+    return r == 0;
+  }
+
+  constexpr friend bool operator!=(const unsafe_flag& lhs,
+                                   const unsafe_flag& rhs) noexcept
+  {
+    return !(lhs == rhs);
   }
 };
 
@@ -25,6 +25,27 @@ using all_true =
 
 }  // namespace details
 
+//
+// Trait for types that can be moved to a new address with a plain memcpy,
+// without calling the move constructor and destructor. Specialize for types
+// that are known to be relocatable but are not trivially copyable.
+//
+template < typename T >
+struct is_trivially_relocatable : std::is_trivially_copyable< T >
+{
+};
+
+//
+// Run-time version of the trait, for type-erased wrappers that are
+// relocatable depending on the object they hold. Overload it for such a
+// type next to the type, it is found by argument dependent lookup.
+//
+template < typename T >
+constexpr bool is_relocatable(const T&) noexcept
+{
+  return is_trivially_relocatable< T >::value;
+}
+
 //
 // Simple compile-time repeat implementation with index
 //
@@ -0,0 +1,697 @@
+//          Copyright Emil Fresk 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include "simd.hpp"
+#include "matrix.hpp"
+#include "precision.hpp"
+#include "vector.hpp"
+#include "quaternion.hpp"
+
+namespace esl
+{
+namespace batch
+{
+//
+// Non-owning structure of arrays view, N component arrays of size() elements
+// each. Quaternions use N = 4 with the same [x, y, z, w] order as the
+// quaternion storage.
+//
+template < typename T, std::size_t N >
+class soa_view
+{
+private:
+  std::array< T*, N > comp_;
+  std::size_t size_;
+
+public:
+  constexpr soa_view(const std::array< T*, N >& components,
+                     std::size_t size) noexcept
+      : comp_(components), size_{size}
+  {
+  }
+
+  // A mutable view converts to a const view
+  template < typename U,
+             typename = std::enable_if_t<
+                 std::is_const< T >::value &&
+                 std::is_same< const U, T >::value > >
+  constexpr soa_view(const soa_view< U, N >& other) noexcept
+      : comp_{}, size_{other.size()}
+  {
+    for (std::size_t i = 0; i < N; ++i)
+      comp_[i] = other[i];
+  }
+
+  // Pointer to a component array
+  constexpr T* operator[](std::size_t component) const noexcept
+  {
+    return comp_[component];
+  }
+
+  constexpr std::size_t size() const noexcept
+  {
+    return size_;
+  }
+
+  // View of count elements starting at offset
+  constexpr soa_view subview(std::size_t offset, std::size_t count) const
+      noexcept
+  {
+    soa_view v{*this};
+
+    for (std::size_t i = 0; i < N; ++i)
+      v.comp_[i] += offset;
+
+    v.size_ = count;
+    return v;
+  }
+};
+
+// Elements per task when an executor is used
+constexpr std::size_t default_chunk = 16384;
+
+namespace details
+{
+template < typename T >
+struct identity
+{
+  using type = T;
+};
+
+// Used to stop a parameter from taking part in template deduction
+template < typename T >
+using identity_t = typename identity< T >::type;
+
+//
+// Runs kernel(reg, i) for full native registers, and the remainder one
+// element at a time with the scalar register
+//
+template < typename T, typename Kernel >
+void for_blocks(std::size_t n, Kernel&& kernel)
+{
+  using R = simd::native< T >;
+  const std::size_t full = n - n % R::width;
+
+  for (std::size_t i = 0; i < full; i += R::width)
+    kernel(R{}, i);
+
+  for (std::size_t i = full; i < n; ++i)
+    kernel(simd::scalar< T >{}, i);
+}
+
+//
+// Splits [0, n) in chunks and runs fun(offset, count) on the executor, which
+// must provide parallel_for(begin, end, grain, fun) (e.g. esl::thread_pool)
+//
+template < typename Executor, typename F >
+void for_chunks(Executor& ex, std::size_t n, std::size_t chunk, F&& fun)
+{
+  if (chunk == 0)
+    chunk = default_chunk;
+
+  const auto num_chunks = (n + chunk - 1) / chunk;
+
+  ex.parallel_for(0, num_chunks, 1, [&](std::size_t c) {
+    const auto offset = c * chunk;
+    fun(offset, (n - offset < chunk) ? n - offset : chunk);
+  });
+}
+
+}  // namespace details
+
+//
+// Rotates all vectors in `in` by q and writes them to `out`, in and out may
+// be the same arrays
+//
+template < typename T >
+void rotate(const quaternion< T >& q,
+            details::identity_t< soa_view< const T, 3 > > in,
+            soa_view< T, 3 > out) noexcept
+{
+  const auto m = esl::rotation_matrix(q);
+
+  details::for_blocks< T >(in.size(), [&](auto r, std::size_t i) {
+    using R = decltype(r);
+
+    const auto x = R::load(in[0] + i);
+    const auto y = R::load(in[1] + i);
+    const auto z = R::load(in[2] + i);
+
+    auto row = [&](std::size_t j) {
+      return R::add(R::add(R::mul(R::set1(m(j, 0)), x),
+                           R::mul(R::set1(m(j, 1)), y)),
+                    R::mul(R::set1(m(j, 2)), z));
+    };
+
+    const auto rx = row(0);
+    const auto ry = row(1);
+    const auto rz = row(2);
+
+    R::store(out[0] + i, rx);
+    R::store(out[1] + i, ry);
+    R::store(out[2] + i, rz);
+  });
+}
+
+//
+// Rotates each vector by its own quaternion
+//
+template < typename T >
+void rotate(details::identity_t< soa_view< const T, 4 > > q,
+            details::identity_t< soa_view< const T, 3 > > in,
+            soa_view< T, 3 > out) noexcept
+{
+  details::for_blocks< T >(in.size(), [&](auto r, std::size_t i) {
+    using R = decltype(r);
+
+    const auto qx = R::load(q[0] + i);
+    const auto qy = R::load(q[1] + i);
+    const auto qz = R::load(q[2] + i);
+    const auto qw = R::load(q[3] + i);
+
+    const auto x = R::load(in[0] + i);
+    const auto y = R::load(in[1] + i);
+    const auto z = R::load(in[2] + i);
+
+    // v' = v + w * t + q_vec x t, with t = 2 * (q_vec x v)
+    const auto two = R::set1(T(2));
+    const auto tx = R::mul(two, R::sub(R::mul(qy, z), R::mul(qz, y)));
+    const auto ty = R::mul(two, R::sub(R::mul(qz, x), R::mul(qx, z)));
+    const auto tz = R::mul(two, R::sub(R::mul(qx, y), R::mul(qy, x)));
+
+    const auto rx = R::add(R::add(x, R::mul(qw, tx)),
+                           R::sub(R::mul(qy, tz), R::mul(qz, ty)));
+    const auto ry = R::add(R::add(y, R::mul(qw, ty)),
+                           R::sub(R::mul(qz, tx), R::mul(qx, tz)));
+    const auto rz = R::add(R::add(z, R::mul(qw, tz)),
+                           R::sub(R::mul(qx, ty), R::mul(qy, tx)));
+
+    R::store(out[0] + i, rx);
+    R::store(out[1] + i, ry);
+    R::store(out[2] + i, rz);
+  });
+}
+
+//
+// Normalizes all vectors (or quaternions) in place. Zero vectors are left
+// as zero, as with vector::normalize. The precision policy P selects the
+// exact or approximate (precision::fast) 1 / sqrt.
+//
+template < typename P = precision::exact, typename T, std::size_t N >
+void normalize(soa_view< T, N > v) noexcept
+{
+  details::for_blocks< T >(v.size(), [&](auto r, std::size_t i) {
+    using R = decltype(r);
+
+    auto s = R::zero();
+
+    esl::repeat< N >([&](auto c) {
+      const auto e = R::load(v[c] + i);
+      s = R::add(s, R::mul(e, e));
+    });
+
+    // Clamping avoids the division by zero, zero vectors stay zero
+    s = R::max(s, R::set1(std::numeric_limits< T >::min()));
+    const auto inv = P::rsqrt(r, s);
+
+    esl::repeat< N >([&](auto c) {
+      R::store(v[c] + i, R::mul(R::load(v[c] + i), inv));
+    });
+  });
+}
+
+//
+// out[i] = sum of a[i] * b[i] over the components
+//
+template < typename A, typename B, std::size_t N, typename T >
+void dot(const soa_view< A, N >& a, const soa_view< B, N >& b,
+         T* out) noexcept
+{
+  static_assert(std::is_same< std::remove_const_t< A >, T >::value &&
+                    std::is_same< std::remove_const_t< B >, T >::value,
+                "The inputs and the output must have the same type");
+
+  details::for_blocks< T >(a.size(), [&](auto r, std::size_t i) {
+    using R = decltype(r);
+
+    auto s = R::zero();
+
+    esl::repeat< N >([&](auto c) {
+      s = R::add(s, R::mul(R::load(a[c] + i), R::load(b[c] + i)));
+    });
+
+    R::store(out + i, s);
+  });
+}
+
+//
+// out[i] = a[i] x b[i]
+//
+template < typename T >
+void cross(details::identity_t< soa_view< const T, 3 > > a,
+           details::identity_t< soa_view< const T, 3 > > b,
+           soa_view< T, 3 > out) noexcept
+{
+  details::for_blocks< T >(a.size(), [&](auto r, std::size_t i) {
+    using R = decltype(r);
+
+    const auto ax = R::load(a[0] + i);
+    const auto ay = R::load(a[1] + i);
+    const auto az = R::load(a[2] + i);
+    const auto bx = R::load(b[0] + i);
+    const auto by = R::load(b[1] + i);
+    const auto bz = R::load(b[2] + i);
+
+    R::store(out[0] + i, R::sub(R::mul(ay, bz), R::mul(az, by)));
+    R::store(out[1] + i, R::sub(R::mul(az, bx), R::mul(ax, bz)));
+    R::store(out[2] + i, R::sub(R::mul(ax, by), R::mul(ay, bx)));
+  });
+}
+
+//
+// Normalization of vectors (or quaternions) close to unit length, see
+// quaternion::renormalize
+//
+template < typename T, std::size_t N >
+void renormalize(soa_view< T, N > v) noexcept
+{
+  details::for_blocks< T >(v.size(), [&](auto r, std::size_t i) {
+    using R = decltype(r);
+
+    auto s = R::zero();
+
+    esl::repeat< N >([&](auto c) {
+      const auto e = R::load(v[c] + i);
+      s = R::add(s, R::mul(e, e));
+    });
+
+    const auto f = R::mul(R::sub(R::set1(T(3)), s), R::set1(T(0.5)));
+
+    esl::repeat< N >([&](auto c) {
+      R::store(v[c] + i, R::mul(R::load(v[c] + i), f));
+    });
+  });
+}
+
+//
+// Integrates the body rates omega (rad/s) over dt, q[i] = q[i] * exp(omega[i]
+// * dt / 2), and renormalizes. The exponential map is a series expansion
+// accurate to the precision of float for rotations up to 1 rad per step.
+//
+template < typename T >
+void integrate(soa_view< T, 4 > q,
+               details::identity_t< soa_view< const T, 3 > > omega,
+               details::identity_t< T > dt) noexcept
+{
+  details::for_blocks< T >(q.size(), [&](auto r, std::size_t i) {
+    using R = decltype(r);
+
+    const auto half_dt = R::set1(dt / T(2));
+    const auto hx = R::mul(R::load(omega[0] + i), half_dt);
+    const auto hy = R::mul(R::load(omega[1] + i), half_dt);
+    const auto hz = R::mul(R::load(omega[2] + i), half_dt);
+    const auto a2 = R::add(R::add(R::mul(hx, hx), R::mul(hy, hy)),
+                           R::mul(hz, hz));
+
+    // cos(a) and sin(a) / a
+    auto poly = [&](T c1, T c2, T c3) {
+      return R::add(
+          R::set1(T(1)),
+          R::mul(a2, R::add(R::set1(c1),
+                            R::mul(a2, R::add(R::set1(c2),
+                                              R::mul(a2, R::set1(c3)))))));
+    };
+
+    const auto rw = poly(T(-1) / T(2), T(1) / T(24), T(-1) / T(720));
+    const auto sc = poly(T(-1) / T(6), T(1) / T(120), T(-1) / T(5040));
+    const auto rx = R::mul(hx, sc);
+    const auto ry = R::mul(hy, sc);
+    const auto rz = R::mul(hz, sc);
+
+    const auto px = R::load(q[0] + i);
+    const auto py = R::load(q[1] + i);
+    const auto pz = R::load(q[2] + i);
+    const auto pw = R::load(q[3] + i);
+
+    const auto x = R::add(R::add(R::mul(pw, rx), R::mul(px, rw)),
+                          R::sub(R::mul(py, rz), R::mul(pz, ry)));
+    const auto y = R::add(R::sub(R::mul(pw, ry), R::mul(px, rz)),
+                          R::add(R::mul(py, rw), R::mul(pz, rx)));
+    const auto z = R::add(R::add(R::mul(pw, rz), R::mul(px, ry)),
+                          R::sub(R::mul(pz, rw), R::mul(py, rx)));
+    const auto w = R::sub(R::sub(R::mul(pw, rw), R::mul(px, rx)),
+                          R::add(R::mul(py, ry), R::mul(pz, rz)));
+
+    const auto n = R::add(R::add(R::mul(x, x), R::mul(y, y)),
+                          R::add(R::mul(z, z), R::mul(w, w)));
+    const auto f = R::mul(R::sub(R::set1(T(3)), n), R::set1(T(0.5)));
+
+    R::store(q[0] + i, R::mul(x, f));
+    R::store(q[1] + i, R::mul(y, f));
+    R::store(q[2] + i, R::mul(z, f));
+    R::store(q[3] + i, R::mul(w, f));
+  });
+}
+
+//
+// out[i] = nlerp(q0[i], q1[i], t)
+//
+template < typename T >
+void nlerp(details::identity_t< soa_view< const T, 4 > > q0,
+           details::identity_t< soa_view< const T, 4 > > q1,
+           details::identity_t< T > t, soa_view< T, 4 > out) noexcept
+{
+  details::for_blocks< T >(q0.size(), [&](auto r, std::size_t i) {
+    using R = decltype(r);
+
+    auto d = R::zero();
+
+    esl::repeat< 4 >([&](auto c) {
+      d = R::add(d, R::mul(R::load(q0[c] + i), R::load(q1[c] + i)));
+    });
+
+    // Shortest path
+    const auto w0 = R::set1(T(1) - t);
+    const auto w1 = R::select_gt(R::zero(), d, R::set1(-t), R::set1(t));
+
+    typename R::type q[4];
+    auto s = R::zero();
+
+    esl::repeat< 4 >([&](auto c) {
+      q[c] = R::add(R::mul(w0, R::load(q0[c] + i)),
+                    R::mul(w1, R::load(q1[c] + i)));
+      s = R::add(s, R::mul(q[c], q[c]));
+    });
+
+    s = R::max(s, R::set1(std::numeric_limits< T >::min()));
+    const auto inv = R::div(R::set1(T(1)), R::sqrt(s));
+
+    esl::repeat< 4 >([&](auto c) {
+      R::store(out[c] + i, R::mul(q[c], inv));  // op
+    });
+  });
+}
+
+//
+// out[i] = slerp(q0[i], q1[i], t), the weights sin(t theta) / sin(theta) are
+// evaluated as polynomials in cos(theta) so no trigonometric functions are
+// needed, based on "A Fast and Accurate Algorithm for Computing SLERP" by
+// D. Eberly. The weights are accurate to 3e-8 (float precision), also for
+// double.
+//
+template < typename T >
+void slerp(details::identity_t< soa_view< const T, 4 > > q0,
+           details::identity_t< soa_view< const T, 4 > > q1,
+           details::identity_t< T > t, soa_view< T, 4 > out) noexcept
+{
+  // The terms (u[i] t^2 - v[i]) of the series for the weights of q1 (t) and
+  // q0 (1 - t), the last term is scaled to compensate for the truncation
+  // (minimax fit of the factor over t in [0, 1] and theta in [0, pi / 2])
+  constexpr std::size_t terms = 16;
+  constexpr T one_plus_mu = T(1.9166610856890198);
+
+  const T d = T(1) - t;
+  T ct[terms], cd[terms];
+
+  for (std::size_t k = 0; k < terms; ++k)
+  {
+    const T a = T(k + 1);
+    const T b = T(2 * k + 3);
+    const T f = (k + 1 == terms) ? one_plus_mu : T(1);
+    const T u = f / (a * b);
+    const T v = f * a / b;
+
+    ct[k] = u * t * t - v;
+    cd[k] = u * d * d - v;
+  }
+
+  details::for_blocks< T >(q0.size(), [&](auto r, std::size_t i) {
+    using R = decltype(r);
+
+    auto x = R::zero();
+
+    esl::repeat< 4 >([&](auto c) {
+      x = R::add(x, R::mul(R::load(q0[c] + i), R::load(q1[c] + i)));
+    });
+
+    // Shortest path
+    const auto one = R::set1(T(1));
+    const auto sign = R::select_gt(R::zero(), x, R::set1(T(-1)), one);
+    const auto xm1 = R::sub(R::mul(x, sign), one);
+
+    auto wt = one;
+    auto wd = one;
+
+    // Horner scheme, from the last term
+    esl::repeat< terms >([&](auto j) {
+      const std::size_t k = terms - 1 - j;
+
+      wt = R::add(one, R::mul(R::mul(R::set1(ct[k]), xm1), wt));
+      wd = R::add(one, R::mul(R::mul(R::set1(cd[k]), xm1), wd));
+    });
+
+    const auto w1 = R::mul(R::mul(R::set1(t), wt), sign);
+    const auto w0 = R::mul(R::set1(d), wd);
+
+    esl::repeat< 4 >([&](auto c) {
+      R::store(out[c] + i, R::add(R::mul(w0, R::load(q0[c] + i)),
+                                  R::mul(w1, R::load(q1[c] + i))));
+    });
+  });
+}
+
+//
+// Rotation matrices of quaternions, the 9 output components are the matrix
+// elements in row-major order
+//
+template < typename T >
+void rotation_matrix(details::identity_t< soa_view< const T, 4 > > q,
+                     soa_view< T, 9 > out) noexcept
+{
+  details::for_blocks< T >(q.size(), [&](auto r, std::size_t i) {
+    using R = decltype(r);
+
+    const auto x = R::load(q[0] + i);
+    const auto y = R::load(q[1] + i);
+    const auto z = R::load(q[2] + i);
+    const auto w = R::load(q[3] + i);
+
+    const auto two = R::set1(T(2));
+    const auto ww = R::mul(w, w);
+    const auto xx = R::mul(x, x);
+    const auto yy = R::mul(y, y);
+    const auto zz = R::mul(z, z);
+    const auto xy = R::mul(x, y);
+    const auto xz = R::mul(x, z);
+    const auto xw = R::mul(x, w);
+    const auto yz = R::mul(y, z);
+    const auto yw = R::mul(y, w);
+    const auto zw = R::mul(z, w);
+
+    R::store(out[0] + i, R::sub(R::add(ww, xx), R::add(yy, zz)));
+    R::store(out[1] + i, R::mul(two, R::sub(xy, zw)));
+    R::store(out[2] + i, R::mul(two, R::add(xz, yw)));
+    R::store(out[3] + i, R::mul(two, R::add(xy, zw)));
+    R::store(out[4] + i, R::sub(R::add(ww, yy), R::add(xx, zz)));
+    R::store(out[5] + i, R::mul(two, R::sub(yz, xw)));
+    R::store(out[6] + i, R::mul(two, R::sub(xz, yw)));
+    R::store(out[7] + i, R::mul(two, R::add(yz, xw)));
+    R::store(out[8] + i, R::sub(R::add(ww, zz), R::add(xx, yy)));
+  });
+}
+
+//
+// Quaternions of rotation matrices (row-major), Shepperd's method as in
+// esl::to_quaternion with the branches replaced by per lane selects
+//
+template < typename T >
+void to_quaternion(details::identity_t< soa_view< const T, 9 > > m,
+                   soa_view< T, 4 > out) noexcept
+{
+  details::for_blocks< T >(m.size(), [&](auto r, std::size_t i) {
+    using R = decltype(r);
+
+    const auto m00 = R::load(m[0] + i);
+    const auto m01 = R::load(m[1] + i);
+    const auto m02 = R::load(m[2] + i);
+    const auto m10 = R::load(m[3] + i);
+    const auto m11 = R::load(m[4] + i);
+    const auto m12 = R::load(m[5] + i);
+    const auto m20 = R::load(m[6] + i);
+    const auto m21 = R::load(m[7] + i);
+    const auto m22 = R::load(m[8] + i);
+
+    const auto one = R::set1(T(1));
+    const auto tr = R::add(R::add(m00, m11), m22);
+
+    // 4 times the squared components, the largest one is solved first
+    const auto rw = R::add(one, tr);
+    const auto rx = R::sub(R::add(one, R::add(m00, m00)), tr);
+    const auto ry = R::sub(R::add(one, R::add(m11, m11)), tr);
+    const auto rz = R::sub(R::add(one, R::add(m22, m22)), tr);
+
+    const auto dx = R::sub(m21, m12);
+    const auto dy = R::sub(m02, m20);
+    const auto dz = R::sub(m10, m01);
+    const auto sxy = R::add(m01, m10);
+    const auto sxz = R::add(m02, m20);
+    const auto syz = R::add(m12, m21);
+
+    // Numerators of [x, y, z, w] for the selected case, divided by 4 times
+    // the largest component below
+    auto best = rw;
+    auto nx = dx;
+    auto ny = dy;
+    auto nz = dz;
+    auto nw = rw;
+
+    auto pick = [&](auto rc, auto cx, auto cy, auto cz, auto cw) {
+      nx = R::select_gt(rc, best, cx, nx);
+      ny = R::select_gt(rc, best, cy, ny);
+      nz = R::select_gt(rc, best, cz, nz);
+      nw = R::select_gt(rc, best, cw, nw);
+      best = R::max(rc, best);
+    };
+
+    pick(rx, rx, sxy, sxz, dx);
+    pick(ry, sxy, ry, syz, dy);
+    pick(rz, sxz, syz, rz, dz);
+
+    const auto s = R::div(R::set1(T(0.5)), R::sqrt(best));
+
+    R::store(out[0] + i, R::mul(nx, s));
+    R::store(out[1] + i, R::mul(ny, s));
+    R::store(out[2] + i, R::mul(nz, s));
+    R::store(out[3] + i, R::mul(nw, s));
+  });
+}
+
+//
+// Z-Y-X Euler angles, [roll, pitch, yaw], see quaternion::from_euler. These
+// need trigonometric functions and run one element at a time.
+//
+template < typename T >
+void from_euler(details::identity_t< soa_view< const T, 3 > > angles,
+                soa_view< T, 4 > out) noexcept
+{
+  for (std::size_t i = 0; i < angles.size(); ++i)
+  {
+    const auto q = quaternion< T >::from_euler(angles[0][i], angles[1][i],
+                                               angles[2][i]);
+
+    esl::repeat< 4 >([&](auto c) {
+      out[c][i] = q[c];  // op
+    });
+  }
+}
+
+template < typename T >
+void to_euler(details::identity_t< soa_view< const T, 4 > > q,
+              soa_view< T, 3 > out) noexcept
+{
+  for (std::size_t i = 0; i < q.size(); ++i)
+  {
+    const auto e =
+        quaternion< T >(q[3][i], q[0][i], q[1][i], q[2][i]).to_euler();
+
+    esl::repeat< 3 >([&](auto c) {
+      out[c][i] = e[c];  // op
+    });
+  }
+}
+
+//
+// Array of structures versions
+//
+template < typename T >
+void rotate(const quaternion< T >& q, const vector< T, 3 >* in,
+            vector< T, 3 >* out, std::size_t n) noexcept
+{
+  const auto m = esl::rotation_matrix(q);
+
+  for (std::size_t i = 0; i < n; ++i)
+    out[i] = m * in[i];
+}
+
+template < typename P = precision::exact, typename T, std::size_t N >
+void normalize(vector< T, N >* v, std::size_t n) noexcept
+{
+  for (std::size_t i = 0; i < n; ++i)
+    v[i].template normalize< P >();
+}
+
+//
+// Multithreaded versions, the input is split in chunks of `chunk` elements
+// which are run by the executor
+//
+template < typename Executor, typename T >
+void rotate(Executor& ex, const quaternion< T >& q,
+            details::identity_t< soa_view< const T, 3 > > in,
+            soa_view< T, 3 > out, std::size_t chunk = default_chunk)
+{
+  details::for_chunks(ex, in.size(), chunk,
+                      [&](std::size_t offset, std::size_t count) {
+                        rotate(q, in.subview(offset, count),
+                               out.subview(offset, count));
+                      });
+}
+
+template < typename Executor, typename T >
+void rotate(Executor& ex, details::identity_t< soa_view< const T, 4 > > q,
+            details::identity_t< soa_view< const T, 3 > > in,
+            soa_view< T, 3 > out, std::size_t chunk = default_chunk)
+{
+  details::for_chunks(ex, in.size(), chunk,
+                      [&](std::size_t offset, std::size_t count) {
+                        rotate< T >(q.subview(offset, count),
+                                    in.subview(offset, count),
+                                    out.subview(offset, count));
+                      });
+}
+
+template < typename P = precision::exact, typename Executor, typename T,
+           std::size_t N >
+void normalize(Executor& ex, soa_view< T, N > v,
+               std::size_t chunk = default_chunk)
+{
+  details::for_chunks(ex, v.size(), chunk,
+                      [&](std::size_t offset, std::size_t count) {
+                        normalize< P >(v.subview(offset, count));
+                      });
+}
+
+template < typename Executor, typename A, typename B, std::size_t N,
+           typename T >
+void dot(Executor& ex, const soa_view< A, N >& a, const soa_view< B, N >& b,
+         T* out, std::size_t chunk = default_chunk)
+{
+  details::for_chunks(ex, a.size(), chunk,
+                      [&](std::size_t offset, std::size_t count) {
+                        dot(a.subview(offset, count),
+                            b.subview(offset, count), out + offset);
+                      });
+}
+
+template < typename Executor, typename T >
+void cross(Executor& ex, details::identity_t< soa_view< const T, 3 > > a,
+           details::identity_t< soa_view< const T, 3 > > b,
+           soa_view< T, 3 > out, std::size_t chunk = default_chunk)
+{
+  details::for_chunks(ex, a.size(), chunk,
+                      [&](std::size_t offset, std::size_t count) {
+                        cross< T >(a.subview(offset, count),
+                                   b.subview(offset, count),
+                                   out.subview(offset, count));
+                      });
+}
+
+}  // namespace batch
+}  // namespace esl
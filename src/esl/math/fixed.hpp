@@ -0,0 +1,380 @@
+//          Copyright Emil Fresk 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include "../helpers/utils.hpp"
+
+namespace esl
+{
+namespace details
+{
+// Index of the highest set bit, x != 0
+constexpr int highest_bit(std::uint64_t x) noexcept
+{
+#if defined(__GNUC__)
+  return 63 - __builtin_clzll(x);
+#else
+  int n = 0;
+
+  while (x >>= 1)
+    ++n;
+
+  return n;
+#endif
+}
+
+// Integer square root rounded to nearest, bit by bit with only shifts and
+// additions (no multiplications or divisions), for cores without an FPU.
+// One iteration per result bit, without branches in the loop.
+constexpr std::uint64_t isqrt(std::uint64_t x) noexcept
+{
+  if (x == 0)
+    return 0;
+
+  std::uint64_t res = 0;
+  std::uint64_t bit = std::uint64_t(1) << (highest_bit(x) & ~1);
+
+  while (bit != 0)
+  {
+    const std::uint64_t t = res + bit;
+    const std::uint64_t mask = std::uint64_t(0) - std::uint64_t(x >= t);
+
+    x -= t & mask;
+    res = (res >> 1) + (bit & mask);
+    bit >>= 2;
+  }
+
+  // x is now the remainder x - res^2, (res + 0.5)^2 = res^2 + res + 0.25
+  return res + std::uint64_t(x > res);
+}
+
+}  // namespace details
+
+//
+// Signed fixed-point number with IntBits integer bits (including the sign)
+// and FracBits fractional bits, e.g. fixed< 16, 16 > is Q16.16 in 32 bits.
+// All arithmetic saturates at min() / max() instead of wrapping, and
+// multiplication, division and conversions round to nearest (ties away from
+// zero). Intermediates use an integer twice as wide, so at most 32 bits in
+// total are supported.
+//
+// Conversions from arithmetic types are implicit so fixed can be used as an
+// esl::vector element, conversions to them are explicit.
+//
+template < int IntBits, int FracBits >
+class fixed
+{
+public:
+  static_assert(IntBits >= 1, "The sign needs an integer bit");
+  static_assert(FracBits >= 0, "Fractional bits can not be negative");
+  static_assert(IntBits + FracBits <= 32,
+                "At most 32 bits, products are computed in 64 bits");
+
+  static constexpr int integer_bits = IntBits;
+  static constexpr int fraction_bits = FracBits;
+
+  using storage_type =
+      int_least_t< (std::uint64_t(1) << (IntBits + FracBits - 1)) - 1 >;
+  using wide_type = std::int64_t;
+
+private:
+  storage_type value_;
+
+  static constexpr wide_type one_raw = wide_type(1) << FracBits;
+  static constexpr wide_type max_raw =
+      (wide_type(1) << (IntBits + FracBits - 1)) - 1;
+  static constexpr wide_type min_raw = -max_raw - 1;
+
+  static constexpr storage_type saturate(wide_type v) noexcept
+  {
+    return static_cast< storage_type >(
+        (v > max_raw) ? max_raw : ((v < min_raw) ? min_raw : v));
+  }
+
+  // n / d rounded to nearest, ties away from zero, d != 0
+  static constexpr wide_type div_round(wide_type n, wide_type d) noexcept
+  {
+    const wide_type q = n / d;
+    const wide_type r = n % d;
+    const wide_type ar = (r < 0) ? -r : r;
+    const wide_type ad = (d < 0) ? -d : d;
+
+    if (ar >= ad - ar)
+      return ((n < 0) != (d < 0)) ? q - 1 : q + 1;
+
+    return q;
+  }
+
+  struct raw_tag
+  {
+  };
+
+  constexpr fixed(raw_tag, storage_type raw) noexcept : value_{raw}
+  {
+  }
+
+public:
+  //
+  // Constructors and conversions
+  //
+  constexpr fixed() noexcept : value_{0}
+  {
+  }
+
+  template < typename U,
+             std::enable_if_t< std::is_integral< U >::value, int > = 0 >
+  constexpr fixed(U v) noexcept : value_{0}
+  {
+    // Compared before scaling, the scaled value may not fit in wide_type
+    constexpr auto max_int = max_raw >> FracBits;
+
+    if (v > U(0) && std::uintmax_t(v) > std::uintmax_t(max_int))
+      value_ = storage_type(max_raw);
+    else if (!(v > U(0)) && std::intmax_t(v) < -max_int - 1)
+      value_ = storage_type(min_raw);
+    else
+      value_ = static_cast< storage_type >(wide_type(v) * one_raw);
+  }
+
+  template < typename U,
+             std::enable_if_t< std::is_floating_point< U >::value, int > = 0 >
+  constexpr fixed(U v) noexcept : value_{0}
+  {
+    const U scaled = v * U(one_raw);
+
+    if (scaled >= U(max_raw))
+      value_ = storage_type(max_raw);
+    else if (scaled <= U(min_raw))
+      value_ = storage_type(min_raw);
+    else if (scaled == scaled)  // NaN gives 0
+      value_ = static_cast< storage_type >(
+          (scaled < U(0)) ? scaled - U(0.5) : scaled + U(0.5));
+  }
+
+  constexpr static fixed from_raw(storage_type raw) noexcept
+  {
+    return {raw_tag{}, raw};
+  }
+
+  constexpr storage_type raw() const noexcept
+  {
+    return value_;
+  }
+
+  // Integers truncate towards zero, as for floating point
+  template < typename U,
+             std::enable_if_t< std::is_arithmetic< U >::value, int > = 0 >
+  explicit constexpr operator U() const noexcept
+  {
+    return std::is_floating_point< U >::value
+               ? static_cast< U >(static_cast< U >(value_) / U(one_raw))
+               : static_cast< U >(value_ / one_raw);
+  }
+
+  constexpr static fixed min() noexcept
+  {
+    return from_raw(storage_type(min_raw));
+  }
+
+  constexpr static fixed max() noexcept
+  {
+    return from_raw(storage_type(max_raw));
+  }
+
+  // Smallest step, 2^-FracBits
+  constexpr static fixed epsilon() noexcept
+  {
+    return from_raw(1);
+  }
+
+  //
+  // Arithmetic, saturating
+  //
+  constexpr fixed& operator+=(const fixed& rhs) noexcept
+  {
+    value_ = saturate(wide_type(value_) + rhs.value_);
+    return *this;
+  }
+
+  constexpr fixed& operator-=(const fixed& rhs) noexcept
+  {
+    value_ = saturate(wide_type(value_) - rhs.value_);
+    return *this;
+  }
+
+  constexpr fixed& operator*=(const fixed& rhs) noexcept
+  {
+    const wide_type p = wide_type(value_) * rhs.value_;
+    constexpr wide_type half = one_raw / 2;
+
+    // Shifts of negative values are avoided, they are not portable
+    value_ = saturate((p < 0) ? -((-p + half) >> FracBits)
+                              : ((p + half) >> FracBits));
+    return *this;
+  }
+
+  // Division by zero saturates towards the sign of the dividend, 0 / 0 is 0
+  constexpr fixed& operator/=(const fixed& rhs) noexcept
+  {
+    if (rhs.value_ == 0)
+      value_ = (value_ > 0) ? storage_type(max_raw)
+                            : ((value_ < 0) ? storage_type(min_raw) : 0);
+    else
+      value_ = saturate(div_round(wide_type(value_) * one_raw, rhs.value_));
+
+    return *this;
+  }
+
+  constexpr friend fixed operator+(fixed lhs, const fixed& rhs) noexcept
+  {
+    return lhs += rhs;
+  }
+
+  constexpr friend fixed operator-(fixed lhs, const fixed& rhs) noexcept
+  {
+    return lhs -= rhs;
+  }
+
+  constexpr friend fixed operator*(fixed lhs, const fixed& rhs) noexcept
+  {
+    return lhs *= rhs;
+  }
+
+  constexpr friend fixed operator/(fixed lhs, const fixed& rhs) noexcept
+  {
+    return lhs /= rhs;
+  }
+
+  constexpr friend fixed operator-(const fixed& rhs) noexcept
+  {
+    return from_raw(saturate(-wide_type(rhs.value_)));
+  }
+
+  constexpr friend fixed operator+(const fixed& rhs) noexcept
+  {
+    return rhs;
+  }
+
+  //
+  // Comparisons
+  //
+  constexpr friend bool operator==(const fixed& lhs,
+                                   const fixed& rhs) noexcept
+  {
+    return lhs.value_ == rhs.value_;
+  }
+
+  constexpr friend bool operator!=(const fixed& lhs,
+                                   const fixed& rhs) noexcept
+  {
+    return lhs.value_ != rhs.value_;
+  }
+
+  constexpr friend bool operator<(const fixed& lhs,
+                                  const fixed& rhs) noexcept
+  {
+    return lhs.value_ < rhs.value_;
+  }
+
+  constexpr friend bool operator<=(const fixed& lhs,
+                                   const fixed& rhs) noexcept
+  {
+    return lhs.value_ <= rhs.value_;
+  }
+
+  constexpr friend bool operator>(const fixed& lhs,
+                                  const fixed& rhs) noexcept
+  {
+    return lhs.value_ > rhs.value_;
+  }
+
+  constexpr friend bool operator>=(const fixed& lhs,
+                                   const fixed& rhs) noexcept
+  {
+    return lhs.value_ >= rhs.value_;
+  }
+};
+
+//
+// sqrt and abs for fixed, these are found by esl::sqrt and esl::abs (see
+// functions.hpp) and so by vector::norm, normalize, etc.
+//
+
+// Rounded to nearest, negative numbers give 0
+template < int IntBits, int FracBits >
+constexpr fixed< IntBits, FracBits > sqrt(
+    fixed< IntBits, FracBits > x) noexcept
+{
+  using F = fixed< IntBits, FracBits >;
+
+  if (x.raw() <= 0)
+    return F{};
+
+  // sqrt(v * 2^-F) * 2^F = sqrt(v * 2^F), rounding up can pass max() when
+  // there are no integer bits besides the sign
+  const auto r = details::isqrt(std::uint64_t(x.raw()) << FracBits);
+
+  return (r > std::uint64_t(F::max().raw()))
+             ? F::max()
+             : F::from_raw(static_cast< typename F::storage_type >(r));
+}
+
+template < int IntBits, int FracBits >
+constexpr fixed< IntBits, FracBits > abs(fixed< IntBits, FracBits > x) noexcept
+{
+  return (x.raw() < 0) ? -x : x;
+}
+
+//
+// Common definitions
+//
+using q15 = fixed< 1, 15 >;
+using q31 = fixed< 1, 31 >;
+using q16_16 = fixed< 16, 16 >;
+
+}  // namespace esl
+
+namespace std
+{
+template < int IntBits, int FracBits >
+class numeric_limits< esl::fixed< IntBits, FracBits > >
+{
+  using type = esl::fixed< IntBits, FracBits >;
+
+public:
+  static constexpr bool is_specialized = true;
+  static constexpr bool is_signed = true;
+  static constexpr bool is_integer = false;
+  static constexpr bool is_exact = true;
+  static constexpr bool is_bounded = true;
+  static constexpr int digits = IntBits + FracBits - 1;
+  static constexpr int radix = 2;
+
+  static constexpr type min() noexcept
+  {
+    return type::epsilon();
+  }
+
+  static constexpr type lowest() noexcept
+  {
+    return type::min();
+  }
+
+  static constexpr type max() noexcept
+  {
+    return type::max();
+  }
+
+  static constexpr type epsilon() noexcept
+  {
+    return type::epsilon();
+  }
+};
+
+}  // namespace std
@@ -0,0 +1,146 @@
+//          Copyright Emil Fresk 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <type_traits>
+#include "fixed.hpp"
+#include "../helpers/feature_defs.hpp"
+
+namespace esl
+{
+namespace details
+{
+// Rounding error of the product p = a * b, a * b - p exactly (barring
+// overflow and underflow). The factors are split in halves as in Dekker's
+// algorithm, as std::fma is not constexpr and slow without hardware support.
+template < typename T >
+constexpr T product_error(T a, T b, T p) noexcept
+{
+  constexpr T split =
+      T(std::uint64_t(1) << ((std::numeric_limits< T >::digits + 1) / 2)) +
+      T(1);
+
+  const T ta = split * a;
+  const T ah = ta - (ta - a);
+  const T al = a - ah;
+  const T tb = split * b;
+  const T bh = tb - (tb - b);
+  const T bl = b - bh;
+
+  return ((ah * bh - p) + ah * bl + al * bh) + al * bl;
+}
+
+// Sign of a * b - x without rounding error, x must be within a factor of two
+// of a * b so the difference is exact
+template < typename T >
+constexpr int product_sign(T a, T b, T x) noexcept
+{
+  const T p = a * b;
+  const T d = (p - x) + product_error(a, b, p);
+
+  return (d > T(0)) - (d < T(0));
+}
+
+// Correctly rounded square root for constant evaluation, x must be positive
+// and finite. x is scaled by powers of 4 into [1, 4), Newton-Raphson from
+// above gives the root to within an ulp and the last bit is fixed with the
+// exact test of Tuckerman (y is the rounded root if y- * y < x <= y * y+).
+template < typename T >
+constexpr T sqrt_newton(T x) noexcept
+{
+  constexpr T eps = std::numeric_limits< T >::epsilon();
+  T scale = T(1);
+
+  while (x >= T(4))
+  {
+    x *= T(0.25);
+    scale *= T(2);
+  }
+
+  while (x < T(1))
+  {
+    x *= T(4);
+    scale *= T(0.5);
+  }
+
+  T y = T(2);
+
+  while (true)
+  {
+    const T next = (y + x / y) / T(2);
+
+    if (!(next < y))
+      break;
+
+    y = next;
+  }
+
+  // The root is in [1, 2]
+  while (true)
+  {
+    const T up = (y < T(2)) ? y + eps : y + T(2) * eps;
+    const T down = (y > T(1)) ? y - eps : y - eps / T(2);
+
+    if (product_sign(y, up, x) < 0)
+      y = up;
+    else if (product_sign(down, y, x) >= 0)
+      y = down;
+    else
+      break;
+  }
+
+  return y * scale;
+}
+
+}  // namespace details
+
+//
+// std::sqrt and std::abs that can be used in constant expressions, e.g. for
+// calibration tables and fixed rotations. At run time they call the std
+// functions, so the generated code is unchanged. Constant evaluation needs
+// ESL_IS_CONSTANT_EVALUATED_AVAILABLE (GCC 9 and Clang 9 or later). The
+// overloads for esl::fixed are in fixed.hpp.
+//
+template < typename T,
+           std::enable_if_t< std::is_floating_point< T >::value, int > = 0 >
+constexpr T sqrt(T x) noexcept
+{
+  if (!ESL_IS_CONSTANT_EVALUATED())
+    return std::sqrt(x);
+
+  if (x != x || x < T(0))
+    return std::numeric_limits< T >::quiet_NaN();
+
+  // Zeros keep their sign
+  if (x == T(0) || x == std::numeric_limits< T >::infinity())
+    return x;
+
+  return details::sqrt_newton(x);
+}
+
+// Integers are converted to double, as with std::sqrt
+template < typename T,
+           std::enable_if_t< std::is_integral< T >::value, int > = 0 >
+constexpr double sqrt(T x) noexcept
+{
+  return esl::sqrt(static_cast< double >(x));
+}
+
+template < typename T >
+constexpr T abs(T x) noexcept
+{
+  if (!ESL_IS_CONSTANT_EVALUATED())
+    return static_cast< T >(std::abs(x));
+
+  // -0 gives +0
+  return (x < T(0)) ? static_cast< T >(-x) : ((x == T(0)) ? T(0) : x);
+}
+
+}  // namespace esl
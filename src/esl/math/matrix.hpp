@@ -0,0 +1,503 @@
+//          Copyright Emil Fresk 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <cstdint>
+#include <cmath>
+#include <type_traits>
+#include "functions.hpp"
+#include "vector.hpp"
+#include "quaternion.hpp"
+#include "../helpers/utils.hpp"
+
+namespace esl
+{
+//
+// Fixed size, row-major matrix for small sizes (e.g. filter state matrices).
+// All loops are unrolled at compile time with esl::repeat, and products run
+// in i-k-j order so the inner loop streams contiguous rows of the result and
+// the right hand side.
+//
+template < typename T, std::size_t R, std::size_t C >
+class matrix
+{
+protected:
+  T storage_[R * C];
+
+public:
+  static_assert(R > 0 && C > 0, "Size must be larger than 0");
+
+  using value_type = T;
+
+  //
+  // Constructors
+  //
+  constexpr matrix() noexcept : storage_{}
+  {
+  }
+
+  // Elements in row-major order
+  template < typename... Ts,
+             typename = std::enable_if_t<
+                 (sizeof...(Ts) > 1) &&
+                 details::all_true<
+                     std::is_convertible< Ts, T >::value... >::value > >
+  constexpr matrix(Ts&&... vals) noexcept
+      : storage_{static_cast< T >(std::forward< Ts >(vals))...}
+  {
+    static_assert(sizeof...(Ts) == R * C,
+                  "Number of arguments does not match the size of the matrix");
+  }
+
+  constexpr static matrix identity() noexcept
+  {
+    static_assert(R == C, "Identity is only defined for square matrices");
+
+    matrix m;
+
+    esl::repeat< R >([&](auto i) {
+      m(i, i) = T(1);  // op
+    });
+
+    return m;
+  }
+
+  //
+  // Access
+  //
+  constexpr T& operator()(std::size_t r, std::size_t c) noexcept
+  {
+    return storage_[r * C + c];
+  }
+
+  constexpr const T& operator()(std::size_t r, std::size_t c) const noexcept
+  {
+    return storage_[r * C + c];
+  }
+
+  constexpr T* data() noexcept
+  {
+    return storage_;
+  }
+
+  constexpr const T* data() const noexcept
+  {
+    return storage_;
+  }
+
+  constexpr static std::size_t rows() noexcept
+  {
+    return R;
+  }
+
+  constexpr static std::size_t cols() noexcept
+  {
+    return C;
+  }
+
+  constexpr vector< T, C > row(std::size_t r) const noexcept
+  {
+    vector< T, C > v;
+
+    esl::repeat< C >([&](auto j) {
+      v[j] = (*this)(r, j);  // op
+    });
+
+    return v;
+  }
+
+  constexpr vector< T, R > col(std::size_t c) const noexcept
+  {
+    vector< T, R > v;
+
+    esl::repeat< R >([&](auto i) {
+      v[i] = (*this)(i, c);  // op
+    });
+
+    return v;
+  }
+
+  //
+  // Standard math functions
+  //
+  constexpr matrix< T, C, R > transpose() const noexcept
+  {
+    matrix< T, C, R > m;
+
+    esl::repeat< R >([&](auto i) {
+      esl::repeat< C >([&](auto j) {
+        m(j, i) = (*this)(i, j);  // op
+      });
+    });
+
+    return m;
+  }
+
+  constexpr T trace() const noexcept
+  {
+    static_assert(R == C, "Trace is only defined for square matrices");
+
+    auto s = T(0);
+
+    esl::repeat< R >([&](auto i) {
+      s += (*this)(i, i);  // op
+    });
+
+    return s;
+  }
+
+  //
+  // Operators
+  //
+  constexpr matrix& operator+=(const matrix& rhs) noexcept
+  {
+    esl::repeat< R * C >([&](auto i) {
+      storage_[i] += rhs.storage_[i];  // op
+    });
+
+    return *this;
+  }
+
+  constexpr matrix& operator-=(const matrix& rhs) noexcept
+  {
+    esl::repeat< R * C >([&](auto i) {
+      storage_[i] -= rhs.storage_[i];  // op
+    });
+
+    return *this;
+  }
+
+  constexpr matrix& operator*=(const T& rhs) noexcept
+  {
+    esl::repeat< R * C >([&](auto i) {
+      storage_[i] *= rhs;  // op
+    });
+
+    return *this;
+  }
+
+  constexpr matrix& operator/=(const T& rhs) noexcept
+  {
+    esl::repeat< R * C >([&](auto i) {
+      storage_[i] /= rhs;  // op
+    });
+
+    return *this;
+  }
+
+  constexpr friend matrix operator+(matrix lhs, const matrix& rhs) noexcept
+  {
+    lhs += rhs;
+    return lhs;
+  }
+
+  constexpr friend matrix operator-(matrix lhs, const matrix& rhs) noexcept
+  {
+    lhs -= rhs;
+    return lhs;
+  }
+
+  constexpr friend matrix operator-(matrix rhs) noexcept
+  {
+    esl::repeat< R * C >([&](auto i) {
+      rhs.storage_[i] = -rhs.storage_[i];  // op
+    });
+
+    return rhs;
+  }
+
+  constexpr friend matrix operator*(matrix lhs, const T& rhs) noexcept
+  {
+    lhs *= rhs;
+    return lhs;
+  }
+
+  constexpr friend matrix operator*(const T& lhs, matrix rhs) noexcept
+  {
+    rhs *= lhs;
+    return rhs;
+  }
+
+  constexpr friend matrix operator/(matrix lhs, const T& rhs) noexcept
+  {
+    lhs /= rhs;
+    return lhs;
+  }
+
+  // Matrix product, i-k-j order
+  template < std::size_t C2 >
+  constexpr friend matrix< T, R, C2 > operator*(
+      const matrix& lhs, const matrix< T, C, C2 >& rhs) noexcept
+  {
+    matrix< T, R, C2 > m;
+
+    esl::repeat< R >([&](auto i) {
+      esl::repeat< C >([&](auto k) {
+        const T a = lhs(i, k);
+
+        esl::repeat< C2 >([&](auto j) {
+          m(i, j) += a * rhs(k, j);  // op
+        });
+      });
+    });
+
+    return m;
+  }
+
+  constexpr friend vector< T, R > operator*(const matrix& lhs,
+                                            const vector< T, C >& rhs) noexcept
+  {
+    vector< T, R > v;
+
+    esl::repeat< R >([&](auto i) {
+      auto s = T(0);
+
+      esl::repeat< C >([&](auto j) {
+        s += lhs(i, j) * rhs[j];  // op
+      });
+
+      v[i] = s;
+    });
+
+    return v;
+  }
+};
+
+//
+// Cholesky decomposition of a symmetric positive definite matrix, A = L L^T
+// with L lower triangular. Only the lower triangle of A is read. Returns
+// false if A is not positive definite.
+//
+template < typename T, std::size_t N >
+constexpr bool cholesky(const matrix< T, N, N >& a,
+                        matrix< T, N, N >& l) noexcept
+{
+  l = matrix< T, N, N >{};
+
+  for (std::size_t j = 0; j < N; ++j)
+  {
+    auto d = a(j, j);
+
+    for (std::size_t k = 0; k < j; ++k)
+      d -= l(j, k) * l(j, k);
+
+    if (!(d > T(0)))
+      return false;
+
+    const auto ljj = esl::sqrt(d);
+    const auto inv = T(1) / ljj;
+    l(j, j) = ljj;
+
+    for (std::size_t i = j + 1; i < N; ++i)
+    {
+      auto s = a(i, j);
+
+      for (std::size_t k = 0; k < j; ++k)
+        s -= l(i, k) * l(j, k);
+
+      l(i, j) = s * inv;
+    }
+  }
+
+  return true;
+}
+
+//
+// Inverse of a symmetric positive definite matrix (e.g. a covariance) via
+// Cholesky, A^-1 = L^-T L^-1. Returns false if A is not positive definite.
+//
+template < typename T, std::size_t N >
+constexpr bool inverse_spd(const matrix< T, N, N >& a,
+                           matrix< T, N, N >& inv) noexcept
+{
+  matrix< T, N, N > l;
+
+  if (!cholesky(a, l))
+    return false;
+
+  // L^-1 by forward substitution, lower triangular
+  matrix< T, N, N > li;
+
+  for (std::size_t j = 0; j < N; ++j)
+  {
+    li(j, j) = T(1) / l(j, j);
+
+    for (std::size_t i = j + 1; i < N; ++i)
+    {
+      auto s = T(0);
+
+      for (std::size_t k = j; k < i; ++k)
+        s -= l(i, k) * li(k, j);
+
+      li(i, j) = s / l(i, i);
+    }
+  }
+
+  // L^-T L^-1, symmetric
+  for (std::size_t i = 0; i < N; ++i)
+  {
+    for (std::size_t j = 0; j <= i; ++j)
+    {
+      auto s = T(0);
+
+      for (std::size_t k = i; k < N; ++k)
+        s += li(k, i) * li(k, j);
+
+      inv(i, j) = s;
+      inv(j, i) = s;
+    }
+  }
+
+  return true;
+}
+
+//
+// Inverse of a general square matrix, Gauss-Jordan elimination with partial
+// pivoting. Returns false if the matrix is singular.
+//
+template < typename T, std::size_t N >
+constexpr bool inverse(const matrix< T, N, N >& a,
+                       matrix< T, N, N >& inv) noexcept
+{
+  auto m = a;
+  inv = matrix< T, N, N >::identity();
+
+  for (std::size_t c = 0; c < N; ++c)
+  {
+    // Pivot on the largest element in the column
+    std::size_t p = c;
+
+    for (std::size_t r = c + 1; r < N; ++r)
+      if (esl::abs(m(r, c)) > esl::abs(m(p, c)))
+        p = r;
+
+    if (m(p, c) == T(0))
+      return false;
+
+    if (p != c)
+    {
+      // std::swap is not constexpr before C++20
+      for (std::size_t j = 0; j < N; ++j)
+      {
+        const auto mt = m(p, j);
+        m(p, j) = m(c, j);
+        m(c, j) = mt;
+
+        const auto it = inv(p, j);
+        inv(p, j) = inv(c, j);
+        inv(c, j) = it;
+      }
+    }
+
+    const auto pinv = T(1) / m(c, c);
+
+    for (std::size_t j = 0; j < N; ++j)
+    {
+      m(c, j) *= pinv;
+      inv(c, j) *= pinv;
+    }
+
+    for (std::size_t r = 0; r < N; ++r)
+    {
+      if (r == c)
+        continue;
+
+      const auto f = m(r, c);
+
+      for (std::size_t j = 0; j < N; ++j)
+      {
+        m(r, j) -= f * m(c, j);
+        inv(r, j) -= f * inv(c, j);
+      }
+    }
+  }
+
+  return true;
+}
+
+//
+// Rotation matrix of a quaternion, R v == q.rotate(v)
+//
+template < typename T >
+constexpr matrix< T, 3, 3 > rotation_matrix(const quaternion< T >& q) noexcept
+{
+  const T qwsq = q.w() * q.w();
+  const T qxsq = q.x() * q.x();
+  const T qysq = q.y() * q.y();
+  const T qzsq = q.z() * q.z();
+
+  const T qxy = q.x() * q.y();
+  const T qxz = q.x() * q.z();
+  const T qxw = q.x() * q.w();
+  const T qyz = q.y() * q.z();
+  const T qyw = q.y() * q.w();
+  const T qzw = q.z() * q.w();
+
+  return {qwsq + qxsq - qysq - qzsq, T(2) * (qxy - qzw), T(2) * (qxz + qyw),
+          T(2) * (qxy + qzw), qwsq - qxsq + qysq - qzsq, T(2) * (qyz - qxw),
+          T(2) * (qxz - qyw), T(2) * (qyz + qxw), qwsq - qxsq - qysq + qzsq};
+}
+
+//
+// Quaternion of a rotation matrix, Shepperd's method. The component with the
+// largest magnitude is found from the diagonal and the others are solved
+// from it, which stays accurate for all rotations (also around 180 degrees).
+//
+template < typename T >
+constexpr quaternion< T > to_quaternion(const matrix< T, 3, 3 >& m) noexcept
+{
+  const T tr = m(0, 0) + m(1, 1) + m(2, 2);
+
+  if (tr >= m(0, 0) && tr >= m(1, 1) && tr >= m(2, 2))
+  {
+    const T r = esl::sqrt(T(1) + tr);
+    const T s = T(0.5) / r;
+
+    return {T(0.5) * r, (m(2, 1) - m(1, 2)) * s, (m(0, 2) - m(2, 0)) * s,
+            (m(1, 0) - m(0, 1)) * s};
+  }
+  else if (m(0, 0) >= m(1, 1) && m(0, 0) >= m(2, 2))
+  {
+    const T r = esl::sqrt(T(1) + m(0, 0) - m(1, 1) - m(2, 2));
+    const T s = T(0.5) / r;
+
+    return {(m(2, 1) - m(1, 2)) * s, T(0.5) * r, (m(0, 1) + m(1, 0)) * s,
+            (m(0, 2) + m(2, 0)) * s};
+  }
+  else if (m(1, 1) >= m(2, 2))
+  {
+    const T r = esl::sqrt(T(1) - m(0, 0) + m(1, 1) - m(2, 2));
+    const T s = T(0.5) / r;
+
+    return {(m(0, 2) - m(2, 0)) * s, (m(0, 1) + m(1, 0)) * s, T(0.5) * r,
+            (m(1, 2) + m(2, 1)) * s};
+  }
+  else
+  {
+    const T r = esl::sqrt(T(1) - m(0, 0) - m(1, 1) + m(2, 2));
+    const T s = T(0.5) / r;
+
+    return {(m(1, 0) - m(0, 1)) * s, (m(0, 2) + m(2, 0)) * s,
+            (m(1, 2) + m(2, 1)) * s, T(0.5) * r};
+  }
+}
+
+//
+// Common definitions
+//
+using matrix2f = matrix< float, 2, 2 >;
+using matrix2d = matrix< double, 2, 2 >;
+
+using matrix3f = matrix< float, 3, 3 >;
+using matrix3d = matrix< double, 3, 3 >;
+
+using matrix4f = matrix< float, 4, 4 >;
+using matrix4d = matrix< double, 4, 4 >;
+
+using matrix6f = matrix< float, 6, 6 >;
+using matrix6d = matrix< double, 6, 6 >;
+
+}  // end namespace esl
@@ -0,0 +1,352 @@
+//          Copyright Emil Fresk 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <cmath>
+#include "functions.hpp"
+#include "simd.hpp"
+#include "../helpers/feature_defs.hpp"
+
+namespace esl
+{
+//
+// Precision policies for norms and normalization, selected with a template
+// parameter (e.g. v.normalize< esl::precision::fast >()). Each policy gives
+// scalar sqrt, rsqrt (1 / sqrt), recip (1 / x) and fma (a * b + c), rsqrt on
+// SIMD registers for the batch kernels, and the accumulator of reductions.
+//
+namespace precision
+{
+namespace details
+{
+// Approximate 1 / x, relative error below 1e-6, x must be non-zero and normal
+inline float recip(float x) noexcept
+{
+#if defined(__SSE__) || defined(_M_X64)
+  // Estimate (12 bits) and one Newton-Raphson step
+  const float y = _mm_cvtss_f32(_mm_rcp_ss(_mm_set_ss(x)));
+  return y * (2.0f - x * y);
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+  // Estimate (8 bits) and two Newton-Raphson steps
+  const auto v = vdup_n_f32(x);
+  auto r = vrecpe_f32(v);
+  r = vmul_f32(vrecps_f32(v, r), r);
+  r = vmul_f32(vrecps_f32(v, r), r);
+  return vget_lane_f32(r, 0);
+#else
+  return 1.0f / x;
+#endif
+}
+
+// No estimate instruction for double
+inline double recip(double x) noexcept
+{
+  return 1.0 / x;
+}
+
+// Where the FPU has a sqrt instruction it is as fast as the estimate, x * 1 /
+// sqrt(x) is only used on targets without one
+inline float sqrt(float x) noexcept
+{
+#if defined(__SSE__) || defined(_M_X64) || defined(__ARM_NEON) || \
+    defined(__ARM_NEON__)
+  return std::sqrt(x);
+#else
+  return (x > 0.0f) ? x * simd::details::rsqrt(x) : 0.0f;
+#endif
+}
+
+inline double sqrt(double x) noexcept
+{
+#if defined(__SSE2__) || defined(_M_X64) || defined(__aarch64__)
+  return std::sqrt(x);
+#else
+  return (x > 0.0) ? x * simd::details::rsqrt(x) : 0.0;
+#endif
+}
+
+// Fused multiply-add where the hardware has it, otherwise a * b + c as
+// std::fma would be emulated in software
+inline float fma(float a, float b, float c) noexcept
+{
+#if defined(FP_FAST_FMAF)
+  return std::fma(a, b, c);
+#else
+  return a * b + c;
+#endif
+}
+
+inline double fma(double a, double b, double c) noexcept
+{
+#if defined(FP_FAST_FMA)
+  return std::fma(a, b, c);
+#else
+  return a * b + c;
+#endif
+}
+
+// a * b - p exactly, with a fused multiply-add where the hardware has it
+template < typename T >
+constexpr T product_error(T a, T b, T p) noexcept
+{
+#if defined(FP_FAST_FMA) && defined(FP_FAST_FMAF)
+  if (!ESL_IS_CONSTANT_EVALUATED())
+    return std::fma(a, b, -p);
+#endif
+
+  return esl::details::product_error(a, b, p);
+}
+
+//
+// Accumulators of the reductions (sum, norm_squared), selected by the policy
+// with P::accumulator< T >. add adds a term and add_product the product of
+// two terms.
+//
+
+// In T, as the plain loop, products use the fma of the policy
+template < typename T, typename P >
+struct plain_accumulator
+{
+  static constexpr bool plain = true;
+
+  T s = T(0);
+
+  constexpr void add(T x) noexcept
+  {
+    s += x;
+  }
+
+  constexpr void add_product(T a, T b) noexcept
+  {
+    s = P::fma(a, b, s);
+  }
+
+  constexpr T result() const noexcept
+  {
+    return s;
+  }
+};
+
+// Next wider floating point type, long double is the same as double on
+// some targets (e.g. MSVC and 32 bit ARM)
+template < typename T >
+struct wider
+{
+  using type = T;
+};
+
+template <>
+struct wider< float >
+{
+  using type = double;
+};
+
+template <>
+struct wider< double >
+{
+  using type = long double;
+};
+
+// In the wider type, the products of float terms are exact in double
+template < typename T >
+struct wide_accumulator
+{
+  using wide_type = typename wider< T >::type;
+
+  static constexpr bool plain = false;
+
+  wide_type s = wide_type(0);
+
+  constexpr void add(T x) noexcept
+  {
+    s += wide_type(x);
+  }
+
+  constexpr void add_product(T a, T b) noexcept
+  {
+    s += wide_type(a) * wide_type(b);
+  }
+
+  constexpr T result() const noexcept
+  {
+    return static_cast< T >(s);
+  }
+};
+
+// Compensated summation, the rounding error of every addition (Knuth's
+// TwoSum, branch free unlike Kahan-Babuska) and product is summed
+// separately and added at the end. The result is as accurate as if computed
+// in twice the precision and then rounded to T (Ogita, Rump and Oishi,
+// "Accurate sum and dot product"). Must not be compiled with -ffast-math,
+// which removes the error terms.
+template < typename T >
+struct compensated_accumulator
+{
+  static constexpr bool plain = false;
+
+  T s = T(0);
+  T c = T(0);
+
+  constexpr void add(T x) noexcept
+  {
+    const T t = s + x;
+    const T z = t - s;
+
+    c += (s - (t - z)) + (x - z);
+    s = t;
+  }
+
+  constexpr void add_product(T a, T b) noexcept
+  {
+    const T p = a * b;
+
+    c += product_error(a, b, p);
+    add(p);
+  }
+
+  constexpr T result() const noexcept
+  {
+    return s + c;
+  }
+};
+
+}  // namespace details
+
+//
+// IEEE results, the default
+//
+struct exact
+{
+  template < typename T >
+  constexpr static T sqrt(T x) noexcept
+  {
+    return esl::sqrt(x);
+  }
+
+  template < typename T >
+  constexpr static T rsqrt(T x) noexcept
+  {
+    return T(1) / esl::sqrt(x);
+  }
+
+  template < typename T >
+  constexpr static T recip(T x) noexcept
+  {
+    return T(1) / x;
+  }
+
+  template < typename T >
+  constexpr static T fma(T a, T b, T c) noexcept
+  {
+    return a * b + c;
+  }
+
+  template < typename R >
+  static typename R::type rsqrt(R, typename R::type x) noexcept
+  {
+    return R::div(R::set1(1), R::sqrt(x));
+  }
+
+  template < typename T >
+  using accumulator = details::plain_accumulator< T, exact >;
+};
+
+//
+// Hardware estimates refined with Newton-Raphson steps, relative error below
+// 1e-6. Arguments must be positive and normal (sqrt also accepts 0). Falls
+// back to exact during constant evaluation.
+//
+struct fast
+{
+  template < typename T >
+  constexpr static T rsqrt(T x) noexcept
+  {
+    if (ESL_IS_CONSTANT_EVALUATED())
+      return exact::rsqrt(x);
+
+    return simd::details::rsqrt(x);
+  }
+
+  template < typename T >
+  constexpr static T sqrt(T x) noexcept
+  {
+    if (ESL_IS_CONSTANT_EVALUATED())
+      return exact::sqrt(x);
+
+    return details::sqrt(x);
+  }
+
+  template < typename T >
+  constexpr static T recip(T x) noexcept
+  {
+    if (ESL_IS_CONSTANT_EVALUATED())
+      return exact::recip(x);
+
+    return details::recip(x);
+  }
+
+  template < typename T >
+  constexpr static T fma(T a, T b, T c) noexcept
+  {
+    return a * b + c;
+  }
+
+  template < typename R >
+  static typename R::type rsqrt(R, typename R::type x) noexcept
+  {
+    return R::rsqrt(x);
+  }
+
+  template < typename T >
+  using accumulator = details::plain_accumulator< T, fast >;
+};
+
+//
+// As fast, with fused multiply-add where the hardware has it (FP_FAST_FMA)
+//
+struct fast_fma : fast
+{
+  template < typename T >
+  constexpr static T fma(T a, T b, T c) noexcept
+  {
+    if (ESL_IS_CONSTANT_EVALUATED())
+      return exact::fma(a, b, c);
+
+    return details::fma(a, b, c);
+  }
+
+  template < typename T >
+  using accumulator = details::plain_accumulator< T, fast_fma >;
+};
+
+//
+// Reductions (sum, norm_squared) accumulated in the next wider type, double
+// for float and long double for double, the rest as the Base policy. Keeps
+// float storage with close to double quality results, e.g.
+// v.norm< precision::wide<> >(). Not used by the SIMD backend.
+//
+template < typename Base = exact >
+struct wide : Base
+{
+  template < typename T >
+  using accumulator = details::wide_accumulator< T >;
+};
+
+//
+// Reductions with compensated summation for floating point types, as
+// accurate as twice the precision of T without a wider type (so also for
+// double where long double is double), the rest as the Base policy. Not used
+// by the SIMD backend.
+//
+template < typename Base = exact >
+struct compensated : Base
+{
+  template < typename T >
+  using accumulator = details::compensated_accumulator< T >;
+};
+
+}  // namespace precision
+}  // namespace esl
@@ -5,6 +5,8 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cmath>
 #include "vector.hpp"
 
 namespace esl
@@ -70,21 +72,98 @@ public:
     return vector< T, 4 >::storage_[3];
   }
 
-  constexpr vector< T, 3 >& vec()
+  // Copy of the vector part, usable in constant expressions. The copy is
+  // const so writes such as q.vec() += v do not compile, use set_vec()
+  constexpr const vector< T, 3 > vec() const
   {
-    return *reinterpret_cast< vector< T, 3 >* >(this);
+    return {x(), y(), z()};
   }
 
-  constexpr const vector< T, 3 >& vec() const
+  constexpr void set_vec(const vector< T, 3 >& v) noexcept
   {
-    return *reinterpret_cast< const vector< T, 3 >* >(this);
+    x() = v.x();
+    y() = v.y();
+    z() = v.z();
   }
 
+  //
+  // Construction from other representations
+  //
+
+  // Exponential map, rotation of |v| radians around the axis of v
+  static quaternion from_rotation_vector(const vector< T, 3 >& v) noexcept
+  {
+    const T theta_sq = v.norm_squared();
+    T c, s;
+
+    if (theta_sq < T(1e-8))
+    {
+      // Taylor expansion around zero, sin(a)/a is exact to the precision of T
+      c = T(1) - theta_sq / T(8);
+      s = T(0.5) - theta_sq / T(48);
+    }
+    else
+    {
+      const T theta = std::sqrt(theta_sq);
+      c = std::cos(theta / T(2));
+      s = std::sin(theta / T(2)) / theta;
+    }
+
+    return quaternion(c, s * v.x(), s * v.y(), s * v.z());
+  }
+
+  // Z-Y-X (yaw, pitch, roll) Euler angles in radians, R = Rz Ry Rx
+  static quaternion from_euler(T roll, T pitch, T yaw) noexcept
+  {
+    const T cr = std::cos(roll / T(2));
+    const T sr = std::sin(roll / T(2));
+    const T cp = std::cos(pitch / T(2));
+    const T sp = std::sin(pitch / T(2));
+    const T cy = std::cos(yaw / T(2));
+    const T sy = std::sin(yaw / T(2));
+
+    return quaternion(cr * cp * cy + sr * sp * sy, sr * cp * cy - cr * sp * sy,
+                      cr * sp * cy + sr * cp * sy, cr * cp * sy - sr * sp * cy);
+  }
+
+  //
+  // Standard quaternion functions
+  //
   constexpr quaternion conj() const
   {
     return quaternion(w(), -x(), -y(), -z());
   }
 
+  // Z-Y-X Euler angles as [roll, pitch, yaw], pitch in [-pi/2, pi/2]
+  vector< T, 3 > to_euler() const noexcept
+  {
+    const T sp = T(2) * (w() * y() - z() * x());
+
+    return {std::atan2(T(2) * (w() * x() + y() * z()),
+                       T(1) - T(2) * (x() * x() + y() * y())),
+            std::asin(std::min(std::max(sp, T(-1)), T(1))),
+            std::atan2(T(2) * (w() * z() + x() * y()),
+                       T(1) - T(2) * (y() * y() + z() * z()))};
+  }
+
+  // Normalization for quaternions close to unit length (e.g. after an
+  // integration step), a first order expansion of 1 / sqrt(n) around 1
+  // which needs no square root or division
+  constexpr void renormalize() noexcept
+  {
+    *this *= (T(3) - this->norm_squared()) / T(2);
+  }
+
+  // Integrates the body rate omega (rad/s) over dt with the exponential map,
+  // q = q * exp(omega * dt / 2), and renormalizes
+  quaternion& integrate(const vector< T, 3 >& omega, T dt) noexcept
+  {
+    *this *= from_rotation_vector(omega * dt);
+    renormalize();
+
+    return *this;
+  }
+
   constexpr vector< T, 3 > rotate(vector< T, 3 > v) const
   {
     // Rotation from the rotation matrix equations directly applied on v.
@@ -108,6 +187,12 @@ public:
                 (qwsq - qxsq - qysq + qzsq) * v.z()};
   }
 
+  constexpr quaternion& operator*=(const T& rhs) noexcept
+  {
+    vector< T, 4 >::operator*=(rhs);
+    return *this;
+  }
+
   constexpr quaternion& operator*=(const quaternion& rhs) noexcept
   {
     quaternion p{*this};
@@ -143,6 +228,50 @@ public:
   // }
 };
 
+//
+// Interpolation between unit quaternions, t in [0, 1]. Both take the
+// shortest path.
+//
+
+// Normalized linear interpolation, not constant angular rate but cheap and
+// close to slerp for nearby rotations
+template < typename T >
+quaternion< T > nlerp(const quaternion< T >& q0, const quaternion< T >& q1,
+                      T t) noexcept
+{
+  const T w1 = (q0.dot(q1).sum() < T(0)) ? -t : t;
+  const T w0 = T(1) - t;
+
+  quaternion< T > q(w0 * q0.w() + w1 * q1.w(), w0 * q0.x() + w1 * q1.x(),
+                    w0 * q0.y() + w1 * q1.y(), w0 * q0.z() + w1 * q1.z());
+  q.normalize();
+
+  return q;
+}
+
+// Spherical linear interpolation, constant angular rate
+template < typename T >
+quaternion< T > slerp(const quaternion< T >& q0, const quaternion< T >& q1,
+                      T t) noexcept
+{
+  T d = q0.dot(q1).sum();
+  const T sign = (d < T(0)) ? T(-1) : T(1);
+  d *= sign;
+
+  // sin(theta) goes to zero, nlerp is accurate here
+  if (d > T(0.9995))
+    return nlerp(q0, q1, t);
+
+  const T theta = std::acos(d);
+  const T s = T(1) / std::sin(theta);
+  const T w0 = std::sin((T(1) - t) * theta) * s;
+  const T w1 = sign * std::sin(t * theta) * s;
+
+  return quaternion< T >(
+      w0 * q0.w() + w1 * q1.w(), w0 * q0.x() + w1 * q1.x(),
+      w0 * q0.y() + w1 * q1.y(), w0 * q0.z() + w1 * q1.z());
+}
+
 //
 // Common definitions
 //
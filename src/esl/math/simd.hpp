@@ -0,0 +1,996 @@
+//          Copyright Emil Fresk 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include "../helpers/feature_defs.hpp"
+#include "../helpers/utils.hpp"
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#elif defined(__SSE__)
+#include <xmmintrin.h>  // Only the single float estimates in details
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
+namespace esl
+{
+namespace simd
+{
+//
+// A native register holding W lanes of T. Each instruction set specializes
+// the widths it supports, the base case marks the width as not available.
+//
+template < typename T, std::size_t W >
+struct reg
+{
+  static constexpr bool available = false;
+};
+
+#if defined(__SSE2__) || defined(_M_X64)
+template <>
+struct reg< float, 4 >
+{
+  using type = __m128;
+  static constexpr bool available = true;
+  static constexpr std::size_t width = 4;
+
+  static type zero() noexcept
+  {
+    return _mm_setzero_ps();
+  }
+
+  static type set1(float s) noexcept
+  {
+    return _mm_set1_ps(s);
+  }
+
+  static type load(const float* p) noexcept
+  {
+    return _mm_loadu_ps(p);
+  }
+
+  static void store(float* p, type v) noexcept
+  {
+    _mm_storeu_ps(p, v);
+  }
+
+  // Loads n < 4 elements, the remaining lanes are zero
+  static type load_partial(const float* p, std::size_t n) noexcept
+  {
+    if (n == 1)
+      return _mm_load_ss(p);
+
+    // The 64 bit integer load and store are declared with may_alias, a
+    // load or store through double* would break strict aliasing
+    const auto lo = _mm_castsi128_ps(
+        _mm_loadl_epi64(reinterpret_cast< const __m128i* >(p)));
+
+    if (n == 2)
+      return lo;
+
+    return _mm_movelh_ps(lo, _mm_load_ss(p + 2));
+  }
+
+  static void store_partial(float* p, type v, std::size_t n) noexcept
+  {
+    if (n == 1)
+    {
+      _mm_store_ss(p, v);
+      return;
+    }
+
+    _mm_storel_epi64(reinterpret_cast< __m128i* >(p), _mm_castps_si128(v));
+
+    if (n == 3)
+      _mm_store_ss(p + 2, _mm_movehl_ps(v, v));
+  }
+
+  static type add(type a, type b) noexcept
+  {
+    return _mm_add_ps(a, b);
+  }
+
+  static type sub(type a, type b) noexcept
+  {
+    return _mm_sub_ps(a, b);
+  }
+
+  static type mul(type a, type b) noexcept
+  {
+    return _mm_mul_ps(a, b);
+  }
+
+  static type div(type a, type b) noexcept
+  {
+    return _mm_div_ps(a, b);
+  }
+
+  static type sqrt(type a) noexcept
+  {
+    return _mm_sqrt_ps(a);
+  }
+
+  // Approximate 1 / sqrt(a), relative error below 1e-6, a must be positive
+  // and normal
+  static type rsqrt(type a) noexcept
+  {
+    // Estimate (12 bits) and one Newton-Raphson step
+    const auto y = _mm_rsqrt_ps(a);
+    return _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(0.5f), y),
+                      _mm_sub_ps(_mm_set1_ps(3.0f),
+                                 _mm_mul_ps(_mm_mul_ps(a, y), y)));
+  }
+
+  static type max(type a, type b) noexcept
+  {
+    return _mm_max_ps(a, b);
+  }
+
+  // Per lane a > b ? x : y
+  static type select_gt(type a, type b, type x, type y) noexcept
+  {
+    const auto m = _mm_cmpgt_ps(a, b);
+    return _mm_or_ps(_mm_and_ps(m, x), _mm_andnot_ps(m, y));
+  }
+
+  static float hsum(type v) noexcept
+  {
+    auto shuf = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1));
+    auto sums = _mm_add_ps(v, shuf);
+    shuf = _mm_movehl_ps(shuf, sums);
+    return _mm_cvtss_f32(_mm_add_ss(sums, shuf));
+  }
+};
+
+template <>
+struct reg< double, 2 >
+{
+  using type = __m128d;
+  static constexpr bool available = true;
+  static constexpr std::size_t width = 2;
+
+  static type zero() noexcept
+  {
+    return _mm_setzero_pd();
+  }
+
+  static type set1(double s) noexcept
+  {
+    return _mm_set1_pd(s);
+  }
+
+  static type load(const double* p) noexcept
+  {
+    return _mm_loadu_pd(p);
+  }
+
+  static void store(double* p, type v) noexcept
+  {
+    _mm_storeu_pd(p, v);
+  }
+
+  static type load_partial(const double* p, std::size_t) noexcept
+  {
+    return _mm_load_sd(p);
+  }
+
+  static void store_partial(double* p, type v, std::size_t) noexcept
+  {
+    _mm_store_sd(p, v);
+  }
+
+  static type add(type a, type b) noexcept
+  {
+    return _mm_add_pd(a, b);
+  }
+
+  static type sub(type a, type b) noexcept
+  {
+    return _mm_sub_pd(a, b);
+  }
+
+  static type mul(type a, type b) noexcept
+  {
+    return _mm_mul_pd(a, b);
+  }
+
+  static type div(type a, type b) noexcept
+  {
+    return _mm_div_pd(a, b);
+  }
+
+  static type sqrt(type a) noexcept
+  {
+    return _mm_sqrt_pd(a);
+  }
+
+  // Approximate 1 / sqrt(a), relative error below 1e-6, a must be positive
+  // and normal
+  static type rsqrt(type a) noexcept
+  {
+    // No estimate instruction for double
+    return _mm_div_pd(_mm_set1_pd(1.0), _mm_sqrt_pd(a));
+  }
+
+  static type max(type a, type b) noexcept
+  {
+    return _mm_max_pd(a, b);
+  }
+
+  // Per lane a > b ? x : y
+  static type select_gt(type a, type b, type x, type y) noexcept
+  {
+    const auto m = _mm_cmpgt_pd(a, b);
+    return _mm_or_pd(_mm_and_pd(m, x), _mm_andnot_pd(m, y));
+  }
+
+  static double hsum(type v) noexcept
+  {
+    return _mm_cvtsd_f64(_mm_add_sd(v, _mm_unpackhi_pd(v, v)));
+  }
+};
+#endif
+
+#if defined(__AVX__)
+template <>
+struct reg< float, 8 >
+{
+  using type = __m256;
+  static constexpr bool available = true;
+  static constexpr std::size_t width = 8;
+
+  static type zero() noexcept
+  {
+    return _mm256_setzero_ps();
+  }
+
+  static type set1(float s) noexcept
+  {
+    return _mm256_set1_ps(s);
+  }
+
+  static type load(const float* p) noexcept
+  {
+    return _mm256_loadu_ps(p);
+  }
+
+  static void store(float* p, type v) noexcept
+  {
+    _mm256_storeu_ps(p, v);
+  }
+
+  // Built from two 128 bit halves, n < 8
+  static type load_partial(const float* p, std::size_t n) noexcept
+  {
+    using half = reg< float, 4 >;
+
+    if (n < 4)
+      return _mm256_insertf128_ps(_mm256_setzero_ps(),
+                                  half::load_partial(p, n), 0);
+
+    const auto lo = _mm256_castps128_ps256(half::load(p));
+
+    if (n == 4)
+      return _mm256_insertf128_ps(lo, _mm_setzero_ps(), 1);
+
+    return _mm256_insertf128_ps(lo, half::load_partial(p + 4, n - 4), 1);
+  }
+
+  static void store_partial(float* p, type v, std::size_t n) noexcept
+  {
+    using half = reg< float, 4 >;
+
+    if (n < 4)
+    {
+      half::store_partial(p, _mm256_castps256_ps128(v), n);
+      return;
+    }
+
+    half::store(p, _mm256_castps256_ps128(v));
+
+    if (n > 4)
+      half::store_partial(p + 4, _mm256_extractf128_ps(v, 1), n - 4);
+  }
+
+  static type add(type a, type b) noexcept
+  {
+    return _mm256_add_ps(a, b);
+  }
+
+  static type sub(type a, type b) noexcept
+  {
+    return _mm256_sub_ps(a, b);
+  }
+
+  static type mul(type a, type b) noexcept
+  {
+    return _mm256_mul_ps(a, b);
+  }
+
+  static type div(type a, type b) noexcept
+  {
+    return _mm256_div_ps(a, b);
+  }
+
+  static type sqrt(type a) noexcept
+  {
+    return _mm256_sqrt_ps(a);
+  }
+
+  // Approximate 1 / sqrt(a), relative error below 1e-6, a must be positive
+  // and normal
+  static type rsqrt(type a) noexcept
+  {
+    // Estimate (12 bits) and one Newton-Raphson step
+    const auto y = _mm256_rsqrt_ps(a);
+    return _mm256_mul_ps(_mm256_mul_ps(_mm256_set1_ps(0.5f), y),
+                         _mm256_sub_ps(_mm256_set1_ps(3.0f),
+                                       _mm256_mul_ps(_mm256_mul_ps(a, y), y)));
+  }
+
+  static type max(type a, type b) noexcept
+  {
+    return _mm256_max_ps(a, b);
+  }
+
+  // Per lane a > b ? x : y
+  static type select_gt(type a, type b, type x, type y) noexcept
+  {
+    return _mm256_blendv_ps(y, x, _mm256_cmp_ps(a, b, _CMP_GT_OQ));
+  }
+
+  static float hsum(type v) noexcept
+  {
+    return reg< float, 4 >::hsum(_mm_add_ps(_mm256_castps256_ps128(v),
+                                            _mm256_extractf128_ps(v, 1)));
+  }
+};
+
+template <>
+struct reg< double, 4 >
+{
+  using type = __m256d;
+  static constexpr bool available = true;
+  static constexpr std::size_t width = 4;
+
+  static type zero() noexcept
+  {
+    return _mm256_setzero_pd();
+  }
+
+  static type set1(double s) noexcept
+  {
+    return _mm256_set1_pd(s);
+  }
+
+  static type load(const double* p) noexcept
+  {
+    return _mm256_loadu_pd(p);
+  }
+
+  static void store(double* p, type v) noexcept
+  {
+    _mm256_storeu_pd(p, v);
+  }
+
+  // Built from two 128 bit halves, n < 4
+  static type load_partial(const double* p, std::size_t n) noexcept
+  {
+    using half = reg< double, 2 >;
+
+    if (n == 1)
+      return _mm256_insertf128_pd(_mm256_setzero_pd(), _mm_load_sd(p), 0);
+
+    const auto lo = _mm256_castpd128_pd256(half::load(p));
+
+    if (n == 2)
+      return _mm256_insertf128_pd(lo, _mm_setzero_pd(), 1);
+
+    return _mm256_insertf128_pd(lo, _mm_load_sd(p + 2), 1);
+  }
+
+  static void store_partial(double* p, type v, std::size_t n) noexcept
+  {
+    using half = reg< double, 2 >;
+
+    if (n == 1)
+    {
+      _mm_store_sd(p, _mm256_castpd256_pd128(v));
+      return;
+    }
+
+    half::store(p, _mm256_castpd256_pd128(v));
+
+    if (n == 3)
+      _mm_store_sd(p + 2, _mm256_extractf128_pd(v, 1));
+  }
+
+  static type add(type a, type b) noexcept
+  {
+    return _mm256_add_pd(a, b);
+  }
+
+  static type sub(type a, type b) noexcept
+  {
+    return _mm256_sub_pd(a, b);
+  }
+
+  static type mul(type a, type b) noexcept
+  {
+    return _mm256_mul_pd(a, b);
+  }
+
+  static type div(type a, type b) noexcept
+  {
+    return _mm256_div_pd(a, b);
+  }
+
+  static type sqrt(type a) noexcept
+  {
+    return _mm256_sqrt_pd(a);
+  }
+
+  // Approximate 1 / sqrt(a), relative error below 1e-6, a must be positive
+  // and normal
+  static type rsqrt(type a) noexcept
+  {
+    // No estimate instruction for double
+    return _mm256_div_pd(_mm256_set1_pd(1.0), _mm256_sqrt_pd(a));
+  }
+
+  static type max(type a, type b) noexcept
+  {
+    return _mm256_max_pd(a, b);
+  }
+
+  // Per lane a > b ? x : y
+  static type select_gt(type a, type b, type x, type y) noexcept
+  {
+    return _mm256_blendv_pd(y, x, _mm256_cmp_pd(a, b, _CMP_GT_OQ));
+  }
+
+  static double hsum(type v) noexcept
+  {
+    return reg< double, 2 >::hsum(_mm_add_pd(_mm256_castpd256_pd128(v),
+                                             _mm256_extractf128_pd(v, 1)));
+  }
+};
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+template <>
+struct reg< float, 4 >
+{
+  using type = float32x4_t;
+  static constexpr bool available = true;
+  static constexpr std::size_t width = 4;
+
+  static type zero() noexcept
+  {
+    return vdupq_n_f32(0.0f);
+  }
+
+  static type set1(float s) noexcept
+  {
+    return vdupq_n_f32(s);
+  }
+
+  static type load(const float* p) noexcept
+  {
+    return vld1q_f32(p);
+  }
+
+  static void store(float* p, type v) noexcept
+  {
+    vst1q_f32(p, v);
+  }
+
+  static type load_partial(const float* p, std::size_t n) noexcept
+  {
+    const auto zero = vdup_n_f32(0.0f);
+
+    if (n == 1)
+      return vcombine_f32(vld1_lane_f32(p, zero, 0), zero);
+
+    if (n == 2)
+      return vcombine_f32(vld1_f32(p), zero);
+
+    return vcombine_f32(vld1_f32(p), vld1_lane_f32(p + 2, zero, 0));
+  }
+
+  static void store_partial(float* p, type v, std::size_t n) noexcept
+  {
+    if (n == 1)
+    {
+      vst1q_lane_f32(p, v, 0);
+      return;
+    }
+
+    vst1_f32(p, vget_low_f32(v));
+
+    if (n == 3)
+      vst1q_lane_f32(p + 2, v, 2);
+  }
+
+  static type add(type a, type b) noexcept
+  {
+    return vaddq_f32(a, b);
+  }
+
+  static type sub(type a, type b) noexcept
+  {
+    return vsubq_f32(a, b);
+  }
+
+  static type mul(type a, type b) noexcept
+  {
+    return vmulq_f32(a, b);
+  }
+
+#if defined(__aarch64__)
+  static type div(type a, type b) noexcept
+  {
+    return vdivq_f32(a, b);
+  }
+
+  static type sqrt(type a) noexcept
+  {
+    return vsqrtq_f32(a);
+  }
+#else
+  // ARMv7 NEON has no division or square root, use the estimates refined
+  // with two Newton-Raphson steps (about 23 bits). sqrt is only valid for
+  // positive inputs.
+  static type div(type a, type b) noexcept
+  {
+    auto r = vrecpeq_f32(b);
+    r = vmulq_f32(vrecpsq_f32(b, r), r);
+    r = vmulq_f32(vrecpsq_f32(b, r), r);
+    return vmulq_f32(a, r);
+  }
+
+  static type sqrt(type a) noexcept
+  {
+    auto r = vrsqrteq_f32(a);
+    r = vmulq_f32(vrsqrtsq_f32(vmulq_f32(a, r), r), r);
+    r = vmulq_f32(vrsqrtsq_f32(vmulq_f32(a, r), r), r);
+    return vmulq_f32(a, r);
+  }
+#endif
+
+  // Approximate 1 / sqrt(a), relative error below 1e-6, a must be positive
+  // and normal
+  static type rsqrt(type a) noexcept
+  {
+    // Estimate (8 bits) and two Newton-Raphson steps
+    auto r = vrsqrteq_f32(a);
+    r = vmulq_f32(vrsqrtsq_f32(vmulq_f32(a, r), r), r);
+    return vmulq_f32(vrsqrtsq_f32(vmulq_f32(a, r), r), r);
+  }
+
+  static type max(type a, type b) noexcept
+  {
+    return vmaxq_f32(a, b);
+  }
+
+  // Per lane a > b ? x : y
+  static type select_gt(type a, type b, type x, type y) noexcept
+  {
+    return vbslq_f32(vcgtq_f32(a, b), x, y);
+  }
+
+  static float hsum(type v) noexcept
+  {
+#if defined(__aarch64__)
+    return vaddvq_f32(v);
+#else
+    const auto s = vadd_f32(vget_low_f32(v), vget_high_f32(v));
+    return vget_lane_f32(vpadd_f32(s, s), 0);
+#endif
+  }
+};
+
+#if defined(__aarch64__)
+template <>
+struct reg< double, 2 >
+{
+  using type = float64x2_t;
+  static constexpr bool available = true;
+  static constexpr std::size_t width = 2;
+
+  static type zero() noexcept
+  {
+    return vdupq_n_f64(0.0);
+  }
+
+  static type set1(double s) noexcept
+  {
+    return vdupq_n_f64(s);
+  }
+
+  static type load(const double* p) noexcept
+  {
+    return vld1q_f64(p);
+  }
+
+  static void store(double* p, type v) noexcept
+  {
+    vst1q_f64(p, v);
+  }
+
+  static type load_partial(const double* p, std::size_t) noexcept
+  {
+    return vld1q_lane_f64(p, vdupq_n_f64(0.0), 0);
+  }
+
+  static void store_partial(double* p, type v, std::size_t) noexcept
+  {
+    vst1q_lane_f64(p, v, 0);
+  }
+
+  static type add(type a, type b) noexcept
+  {
+    return vaddq_f64(a, b);
+  }
+
+  static type sub(type a, type b) noexcept
+  {
+    return vsubq_f64(a, b);
+  }
+
+  static type mul(type a, type b) noexcept
+  {
+    return vmulq_f64(a, b);
+  }
+
+  static type div(type a, type b) noexcept
+  {
+    return vdivq_f64(a, b);
+  }
+
+  static type sqrt(type a) noexcept
+  {
+    return vsqrtq_f64(a);
+  }
+
+  // Approximate 1 / sqrt(a), relative error below 1e-6, a must be positive
+  // and normal
+  static type rsqrt(type a) noexcept
+  {
+    // Estimate (8 bits) and two Newton-Raphson steps
+    auto r = vrsqrteq_f64(a);
+    r = vmulq_f64(vrsqrtsq_f64(vmulq_f64(a, r), r), r);
+    return vmulq_f64(vrsqrtsq_f64(vmulq_f64(a, r), r), r);
+  }
+
+  static type max(type a, type b) noexcept
+  {
+    return vmaxq_f64(a, b);
+  }
+
+  // Per lane a > b ? x : y
+  static type select_gt(type a, type b, type x, type y) noexcept
+  {
+    return vbslq_f64(vcgtq_f64(a, b), x, y);
+  }
+
+  static double hsum(type v) noexcept
+  {
+    return vaddvq_f64(v);
+  }
+};
+#endif
+#endif
+
+namespace details
+{
+// Bit level estimate of 1 / sqrt(x) ("fast inverse square root", constants
+// from C. Lomont and M. Robertson) refined with Newton-Raphson steps
+template < typename T, typename U, U Magic, int Steps >
+T rsqrt_bits(T x) noexcept
+{
+  static_assert(sizeof(T) == sizeof(U), "Integer must match the float size");
+
+  U i;
+  std::memcpy(&i, &x, sizeof(T));
+  i = Magic - (i >> 1);
+
+  T y;
+  std::memcpy(&y, &i, sizeof(T));
+
+  for (int k = 0; k < Steps; ++k)
+    y = T(0.5) * y * (T(3) - x * y * y);
+
+  return y;
+}
+
+// Approximate 1 / sqrt(x), relative error below 1e-6, x must be positive and
+// normal
+inline float rsqrt(float x) noexcept
+{
+#if defined(__SSE__) || defined(_M_X64)
+  // Estimate (12 bits) and one Newton-Raphson step
+  const float y = _mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(x)));
+  return 0.5f * y * (3.0f - x * y * y);
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+  // Estimate (8 bits) and two Newton-Raphson steps
+  const auto v = vdup_n_f32(x);
+  auto r = vrsqrte_f32(v);
+  r = vmul_f32(vrsqrts_f32(vmul_f32(v, r), r), r);
+  r = vmul_f32(vrsqrts_f32(vmul_f32(v, r), r), r);
+  return vget_lane_f32(r, 0);
+#else
+  return rsqrt_bits< float, std::uint32_t, 0x5f375a86u, 3 >(x);
+#endif
+}
+
+// There is no estimate instruction for double, where the FPU has a double
+// sqrt it beats the bit level estimate
+inline double rsqrt(double x) noexcept
+{
+#if defined(__SSE2__) || defined(_M_X64) || defined(__aarch64__)
+  return 1.0 / std::sqrt(x);
+#else
+  return rsqrt_bits< double, std::uint64_t, 0x5fe6eb50c7b537a9u, 3 >(x);
+#endif
+}
+
+}  // namespace details
+
+//
+// Single lane "register", used for the remainder of batch kernels and on
+// targets without SIMD
+//
+template < typename T >
+struct scalar
+{
+  using type = T;
+  static constexpr bool available = true;
+  static constexpr std::size_t width = 1;
+
+  static type zero() noexcept
+  {
+    return T(0);
+  }
+
+  static type set1(T s) noexcept
+  {
+    return s;
+  }
+
+  static type load(const T* p) noexcept
+  {
+    return *p;
+  }
+
+  static void store(T* p, type v) noexcept
+  {
+    *p = v;
+  }
+
+  static type add(type a, type b) noexcept
+  {
+    return a + b;
+  }
+
+  static type sub(type a, type b) noexcept
+  {
+    return a - b;
+  }
+
+  static type mul(type a, type b) noexcept
+  {
+    return a * b;
+  }
+
+  static type div(type a, type b) noexcept
+  {
+    return a / b;
+  }
+
+  static type sqrt(type a) noexcept
+  {
+    return std::sqrt(a);
+  }
+
+  // Approximate 1 / sqrt(a), relative error below 1e-6, a must be positive
+  // and normal
+  static type rsqrt(type a) noexcept
+  {
+    return details::rsqrt(a);
+  }
+
+  static type max(type a, type b) noexcept
+  {
+    return (a < b) ? b : a;
+  }
+
+  // Per lane a > b ? x : y
+  static type select_gt(type a, type b, type x, type y) noexcept
+  {
+    return (a > b) ? x : y;
+  }
+
+  static T hsum(type v) noexcept
+  {
+    return v;
+  }
+};
+
+//
+// The widest available register for T, used by the batch kernels
+//
+template < typename T >
+using native = std::conditional_t<
+    reg< T, 32 / sizeof(T) >::available, reg< T, 32 / sizeof(T) >,
+    std::conditional_t< reg< T, 16 / sizeof(T) >::available,
+                        reg< T, 16 / sizeof(T) >, scalar< T > > >;
+
+namespace details
+{
+//
+// Picks the register width for a vector of N elements: the narrow register
+// (128 bit) when the vector fits, else the wide one (256 bit) if available
+//
+template < typename T, std::size_t N >
+struct select_width
+{
+  static constexpr std::size_t narrow = 16 / sizeof(T);
+  static constexpr std::size_t wide = 32 / sizeof(T);
+
+  static constexpr std::size_t value =
+      (N > narrow && reg< T, wide >::available) ? wide : narrow;
+};
+
+}  // namespace details
+
+//
+// Kernels for N element arrays of T. Full registers are loaded directly, the
+// remaining elements (e.g. the last lane of a 3 element vector) are loaded
+// into a zero padded register with partial loads and stores, so the layout of
+// the arrays is never changed and nothing is written past the end.
+//
+template < typename T, std::size_t N,
+           bool = reg< T, details::select_width< T, N >::value >::available &&
+                  (N >= 2) && (N <= 8) >
+struct ops
+{
+  static constexpr bool available = true;
+
+private:
+  static constexpr std::size_t width_ = details::select_width< T, N >::value;
+  static constexpr std::size_t full_ = N / width_;
+  static constexpr std::size_t tail_ = N % width_;
+
+  using R = reg< T, width_ >;
+  using type = typename R::type;
+
+  static type load_tail(const T* p) noexcept
+  {
+    return R::load_partial(p, tail_);
+  }
+
+  static void store_tail(T* p, type v) noexcept
+  {
+    R::store_partial(p, v, tail_);
+  }
+
+  template < typename Op >
+  static void apply(T* out, const T* a, const T* b, Op&& op) noexcept
+  {
+    esl::repeat< full_ >([&](auto i) {
+      constexpr auto o = i * width_;
+      R::store(out + o, op(R::load(a + o), R::load(b + o)));
+    });
+
+    if
+      ESL_CONSTEXPR_IF(tail_ > 0)
+      {
+        constexpr auto o = full_ * width_;
+        store_tail(out + o, op(load_tail(a + o), load_tail(b + o)));
+      }
+  }
+
+public:
+  static void add(T* out, const T* a, const T* b) noexcept
+  {
+    apply(out, a, b, [](type x, type y) { return R::add(x, y); });
+  }
+
+  static void sub(T* out, const T* a, const T* b) noexcept
+  {
+    apply(out, a, b, [](type x, type y) { return R::sub(x, y); });
+  }
+
+  static void mul(T* out, const T* a, const T* b) noexcept
+  {
+    apply(out, a, b, [](type x, type y) { return R::mul(x, y); });
+  }
+
+  static void scale(T* out, const T* a, T s) noexcept
+  {
+    const auto sv = R::set1(s);
+    apply(out, a, a, [&](type x, type) { return R::mul(x, sv); });
+  }
+
+  // Sum of the element-wise products
+  static T dot(const T* a, const T* b) noexcept
+  {
+    auto acc = R::zero();
+
+    esl::repeat< full_ >([&](auto i) {
+      constexpr auto o = i * width_;
+      acc = R::add(acc, R::mul(R::load(a + o), R::load(b + o)));
+    });
+
+    if
+      ESL_CONSTEXPR_IF(tail_ > 0)
+      {
+        constexpr auto o = full_ * width_;
+        acc = R::add(acc, R::mul(load_tail(a + o), load_tail(b + o)));
+      }
+
+    return R::hsum(acc);
+  }
+};
+
+//
+// Scalar fallback for types and sizes without a SIMD backend
+//
+template < typename T, std::size_t N >
+struct ops< T, N, false >
+{
+  static constexpr bool available = false;
+
+  static void add(T* out, const T* a, const T* b) noexcept
+  {
+    esl::repeat< N >([&](auto i) {
+      out[i] = a[i] + b[i];  // op
+    });
+  }
+
+  static void sub(T* out, const T* a, const T* b) noexcept
+  {
+    esl::repeat< N >([&](auto i) {
+      out[i] = a[i] - b[i];  // op
+    });
+  }
+
+  static void mul(T* out, const T* a, const T* b) noexcept
+  {
+    esl::repeat< N >([&](auto i) {
+      out[i] = a[i] * b[i];  // op
+    });
+  }
+
+  static void scale(T* out, const T* a, T s) noexcept
+  {
+    esl::repeat< N >([&](auto i) {
+      out[i] = a[i] * s;  // op
+    });
+  }
+
+  static T dot(const T* a, const T* b) noexcept
+  {
+    auto s = T(0);
+
+    esl::repeat< N >([&](auto i) {
+      s += a[i] * b[i];  // op
+    });
+
+    return s;
+  }
+};
+
+}  // namespace simd
+}  // namespace esl
@@ -0,0 +1,243 @@
+//          Copyright Emil Fresk 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <cstdint>
+#include "batch.hpp"
+#include "precision.hpp"
+#include "simd.hpp"
+
+namespace esl
+{
+namespace span
+{
+//
+// Kernels over runtime sized arrays (pointer and size), the companion of
+// the fixed size esl::vector for long signal buffers. The reductions take
+// the same precision policies as vector::sum and vector::norm, see
+// precision.hpp. Plain accumulation runs on the widest SIMD register in a
+// different order than a scalar loop, so results may differ from it in the
+// last bits, the wide and compensated accumulators run one element at a time.
+//
+
+namespace details
+{
+//
+// Sum of term(reg, i) over [0, n), with four independent register
+// accumulators to hide the latency of the additions
+//
+template < typename T, typename Term >
+T reduce(std::size_t n, Term&& term) noexcept
+{
+  using R = simd::native< T >;
+  constexpr std::size_t w = R::width;
+
+  auto s0 = R::zero();
+  auto s1 = R::zero();
+  auto s2 = R::zero();
+  auto s3 = R::zero();
+  std::size_t i = 0;
+
+  for (; i + 4 * w <= n; i += 4 * w)
+  {
+    s0 = R::add(s0, term(R{}, i));
+    s1 = R::add(s1, term(R{}, i + w));
+    s2 = R::add(s2, term(R{}, i + 2 * w));
+    s3 = R::add(s3, term(R{}, i + 3 * w));
+  }
+
+  for (; i + w <= n; i += w)
+    s0 = R::add(s0, term(R{}, i));
+
+  T s = R::hsum(R::add(R::add(s0, s1), R::add(s2, s3)));
+
+  for (; i < n; ++i)
+    s += term(simd::scalar< T >{}, i);
+
+  return s;
+}
+
+//
+// Runs fun(offset, count) per chunk on the executor and sums the partial
+// results in chunk order. The chunks only depend on n and chunk, so the
+// result does not change with the number of threads or the scheduling.
+// The partial results are kept on the stack, for up to max_partials chunks
+// per round.
+//
+constexpr std::size_t max_partials = 64;
+
+template < typename P, typename T, typename Executor, typename F >
+T reduce_chunks(Executor& ex, std::size_t n, std::size_t chunk, F&& fun)
+{
+  if (chunk == 0)
+    chunk = batch::default_chunk;
+
+  const auto round = max_partials * chunk;
+
+  T partial[max_partials];
+  typename P::template accumulator< T > acc{};
+
+  for (std::size_t base = 0; base < n; base += round)
+  {
+    const auto len = (n - base < round) ? n - base : round;
+
+    batch::details::for_chunks(
+        ex, len, chunk, [&](std::size_t offset, std::size_t count) {
+          partial[offset / chunk] = fun(base + offset, count);
+        });
+
+    for (std::size_t i = 0; i < (len + chunk - 1) / chunk; ++i)
+      acc.add(partial[i]);
+  }
+
+  return acc.result();
+}
+
+}  // namespace details
+
+//
+// Sum of x[0, n)
+//
+template < typename P = precision::exact, typename T >
+T sum(const T* x, std::size_t n) noexcept
+{
+  using A = typename P::template accumulator< T >;
+
+  if (A::plain)
+    return details::reduce< T >(n, [&](auto r, std::size_t i) {
+      return decltype(r)::load(x + i);  // op
+    });
+
+  A acc{};
+
+  for (std::size_t i = 0; i < n; ++i)
+    acc.add(x[i]);
+
+  return acc.result();
+}
+
+//
+// Sum of a[i] * b[i] over [0, n)
+//
+template < typename P = precision::exact, typename T >
+T dot(const T* a, const T* b, std::size_t n) noexcept
+{
+  using A = typename P::template accumulator< T >;
+
+  if (A::plain)
+    return details::reduce< T >(n, [&](auto r, std::size_t i) {
+      using R = decltype(r);
+      return R::mul(R::load(a + i), R::load(b + i));
+    });
+
+  A acc{};
+
+  for (std::size_t i = 0; i < n; ++i)
+    acc.add_product(a[i], b[i]);
+
+  return acc.result();
+}
+
+template < typename P = precision::exact, typename T >
+T norm_squared(const T* x, std::size_t n) noexcept
+{
+  return dot< P >(x, x, n);
+}
+
+template < typename P = precision::exact, typename T >
+T norm(const T* x, std::size_t n) noexcept
+{
+  return P::sqrt(norm_squared< P >(x, n));
+}
+
+//
+// y[i] += a * x[i], x and y may be the same array
+//
+template < typename T >
+void axpy(batch::details::identity_t< T > a, const T* x, T* y,
+          std::size_t n) noexcept
+{
+  batch::details::for_blocks< T >(n, [&](auto r, std::size_t i) {
+    using R = decltype(r);
+    const auto p = R::mul(R::set1(a), R::load(x + i));
+    R::store(y + i, R::add(R::load(y + i), p));
+  });
+}
+
+//
+// x[i] *= a
+//
+template < typename T >
+void scale(batch::details::identity_t< T > a, T* x, std::size_t n) noexcept
+{
+  batch::details::for_blocks< T >(n, [&](auto r, std::size_t i) {
+    using R = decltype(r);
+    R::store(x + i, R::mul(R::load(x + i), R::set1(a)));
+  });
+}
+
+//
+// Multithreaded versions, the input is split in chunks of `chunk` elements
+// which are run by the executor (see batch::for_chunks). The partial sums of
+// the reductions are rounded to T before they are summed with the
+// accumulator of the policy.
+//
+template < typename P = precision::exact, typename Executor, typename T >
+T sum(Executor& ex, const T* x, std::size_t n,
+      std::size_t chunk = batch::default_chunk)
+{
+  return details::reduce_chunks< P, T >(
+      ex, n, chunk, [&](std::size_t offset, std::size_t count) {
+        return sum< P >(x + offset, count);
+      });
+}
+
+template < typename P = precision::exact, typename Executor, typename T >
+T dot(Executor& ex, const T* a, const T* b, std::size_t n,
+      std::size_t chunk = batch::default_chunk)
+{
+  return details::reduce_chunks< P, T >(
+      ex, n, chunk, [&](std::size_t offset, std::size_t count) {
+        return dot< P >(a + offset, b + offset, count);
+      });
+}
+
+template < typename P = precision::exact, typename Executor, typename T >
+T norm_squared(Executor& ex, const T* x, std::size_t n,
+               std::size_t chunk = batch::default_chunk)
+{
+  return dot< P >(ex, x, x, n, chunk);
+}
+
+template < typename P = precision::exact, typename Executor, typename T >
+T norm(Executor& ex, const T* x, std::size_t n,
+       std::size_t chunk = batch::default_chunk)
+{
+  return P::sqrt(norm_squared< P >(ex, x, n, chunk));
+}
+
+template < typename Executor, typename T >
+void axpy(Executor& ex, batch::details::identity_t< T > a, const T* x, T* y,
+          std::size_t n, std::size_t chunk = batch::default_chunk)
+{
+  batch::details::for_chunks(ex, n, chunk,
+                             [&](std::size_t offset, std::size_t count) {
+                               axpy< T >(a, x + offset, y + offset, count);
+                             });
+}
+
+template < typename Executor, typename T >
+void scale(Executor& ex, batch::details::identity_t< T > a, T* x,
+           std::size_t n, std::size_t chunk = batch::default_chunk)
+{
+  batch::details::for_chunks(ex, n, chunk,
+                             [&](std::size_t offset, std::size_t count) {
+                               scale< T >(a, x + offset, count);
+                             });
+}
+
+}  // namespace span
+}  // namespace esl
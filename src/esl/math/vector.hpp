@@ -9,8 +9,19 @@
 #include <cmath>
 #include <array>
 #include <type_traits>
+#include "functions.hpp"
+#include "precision.hpp"
+#include "simd.hpp"
+#include "vector_expression.hpp"
+#include "../helpers/feature_defs.hpp"
 #include "../helpers/utils.hpp"
 
+// The constexpr vector operations pick the scalar code during constant
+// evaluation, which needs __builtin_is_constant_evaluated
+#if defined(ESL_ENABLE_SIMD) && !defined(ESL_IS_CONSTANT_EVALUATED_AVAILABLE)
+#error "ESL_ENABLE_SIMD needs __builtin_is_constant_evaluated (GCC 9, Clang 9)"
+#endif
+
 namespace esl
 {
 template < typename T, std::size_t N >
@@ -19,18 +30,113 @@ class vector
 protected:
   T storage_[N];
 
+  //
+  // The SIMD backend is opt-in by defining ESL_ENABLE_SIMD, and is never used
+  // during constant evaluation
+  //
+  constexpr static bool use_simd() noexcept
+  {
+#if defined(ESL_ENABLE_SIMD) && defined(ESL_IS_CONSTANT_EVALUATED_AVAILABLE)
+    return simd::ops< T, N >::available && !ESL_IS_CONSTANT_EVALUATED();
+#else
+    return false;
+#endif
+  }
+
+  //
+  // A plain add, sub or scale of vectors is evaluated by the SIMD kernels,
+  // other expressions return false and are evaluated element by element
+  //
+  template < typename X >
+  using is_vector_operand = std::is_base_of< vector, std::decay_t< X > >;
+
+  template < typename E >
+  constexpr bool eval_simd(const E&) noexcept
+  {
+    return false;
+  }
+
+  template < typename Op, typename L, typename R >
+  constexpr bool eval_simd(
+      const vector_binary_expression< Op, L, R >& expr) noexcept
+  {
+    return eval_simd_binary(
+        Op{}, expr.lhs(), expr.rhs(),
+        std::integral_constant< bool, is_vector_operand< L >::value &&
+                                          is_vector_operand< R >::value >{});
+  }
+
+  template < typename Op, typename E, bool ScalarFirst >
+  constexpr bool eval_simd(
+      const vector_scalar_expression< Op, E, ScalarFirst >& expr) noexcept
+  {
+    return eval_simd_scalar(
+        Op{}, expr.expr(), expr.scalar(),
+        std::integral_constant< bool, is_vector_operand< E >::value >{});
+  }
+
+  template < typename Op, typename A, typename B >
+  constexpr bool eval_simd_binary(Op, const A&, const B&,
+                                  std::false_type) noexcept
+  {
+    return false;
+  }
+
+  template < typename Op >
+  constexpr bool eval_simd_binary(Op, const vector&, const vector&,
+                                  std::true_type) noexcept
+  {
+    return false;
+  }
+
+  constexpr bool eval_simd_binary(details::op_add, const vector& lhs,
+                                  const vector& rhs, std::true_type) noexcept
+  {
+    simd::ops< T, N >::add(storage_, lhs.storage_, rhs.storage_);
+    return true;
+  }
+
+  constexpr bool eval_simd_binary(details::op_sub, const vector& lhs,
+                                  const vector& rhs, std::true_type) noexcept
+  {
+    simd::ops< T, N >::sub(storage_, lhs.storage_, rhs.storage_);
+    return true;
+  }
+
+  template < typename Op, typename A >
+  constexpr bool eval_simd_scalar(Op, const A&, const T&,
+                                  std::false_type) noexcept
+  {
+    return false;
+  }
+
+  // Division stays element-wise, scaling by 1 / s would round differently
+  template < typename Op >
+  constexpr bool eval_simd_scalar(Op, const vector&, const T&,
+                                  std::true_type) noexcept
+  {
+    return false;
+  }
+
+  constexpr bool eval_simd_scalar(details::op_mul, const vector& v,
+                                  const T& s, std::true_type) noexcept
+  {
+    simd::ops< T, N >::scale(storage_, v.storage_, s);
+    return true;
+  }
+
 public:
   static_assert(N > 1, "Size must be larger than 1");
 
+  using value_type = T;
+
   //
   // Constructors
   //
-  constexpr vector() noexcept
+  // Storage is initialized in the member initializer list throughout, which
+  // constant evaluation requires before C++20
+  constexpr vector() noexcept : storage_{}
   {
-    // repeat works like loop-unrolling
-    esl::repeat< N >([&](auto i) {
-      storage_[i] = T(0);  // op
-    });
   }
 
   template < typename... Ts,
@@ -47,49 +153,64 @@ public:
   template <
       typename T2, std::size_t M,
       typename = std::enable_if_t< std::is_convertible< T, T2 >::value > >
-  constexpr vector(vector< T2, M > v) noexcept
+  constexpr vector(vector< T2, M > v) noexcept : storage_{}
   {
     static_assert(M <= N, "Size too big");
 
+    // repeat works like loop-unrolling
     esl::repeat< M >([&](auto i) {
       storage_[i] = static_cast< T >(v[i]);  // op
     });
-
-    esl::repeat< N - M >([&](auto i) {
-      storage_[M + i] = T(0);  // op
-    });
   }
 
   // Same or different sized array
   template < std::size_t M >
-  constexpr vector(const std::array< T, M >& arr) noexcept
+  constexpr vector(const std::array< T, M >& arr) noexcept : storage_{}
   {
     static_assert(M <= N, "Size too big");
 
     esl::repeat< M >([&](auto i) {
       storage_[i] = arr[i];  // op
     });
-
-    esl::repeat< N - M >([&](auto i) {
-      storage_[M + i] = T(0);  // op
-    });
   }
 
   // Same or different sized raw array
   template < std::size_t M >
-  constexpr vector(T (&arr)[M]) noexcept
+  constexpr vector(T (&arr)[M]) noexcept : storage_{}
   {
     static_assert(M <= N, "Size too big");
 
     esl::repeat< M >([&](auto i) {
       storage_[i] = arr[i];  // op
     });
+  }
 
-    esl::repeat< N - M >([&](auto i) {
-      storage_[M + i] = T(0);  // op
+  // Evaluation of an expression (e.g. a + b * s), in a single loop
+  template < typename E, typename = std::enable_if_t<
+                             details::is_vector_expression_node< E >::value > >
+  constexpr vector(const E& expr) noexcept : storage_{}
+  {
+    static_assert(details::expression_traits< E >::size == N,
+                  "Size of the expression does not match");
+
+    if (use_simd() && eval_simd(expr))
+      return;
+
+    esl::repeat< N >([&](auto i) {
+      storage_[i] = expr[i];  // op
     });
   }
 
+  template < typename E, typename = std::enable_if_t<
+                             details::is_vector_expression_node< E >::value > >
+  constexpr vector& operator=(const E& expr) noexcept
+  {
+    // Evaluated into a local first, the expression may refer to this vector
+    // and the compiler can then keep the result in registers
+    *this = vector(expr);
+    return *this;
+  }
+
   //
   // Standard math functions
   //
@@ -97,6 +218,12 @@ public:
   {
     vector v;
 
+    if (use_simd())
+    {
+      simd::ops< T, N >::mul(v.storage_, this->storage_, rhs.storage_);
+      return v;
+    }
+
     esl::repeat< N >([&](auto i) {
       v.storage_[i] = this->storage_[i] * rhs.storage_[i];  // op
     });
@@ -104,10 +231,9 @@ public:
     return v;
   }
 
-  template < std::size_t M >
-  constexpr vector< T, 3 > cross(const vector< T, M >& rhs) const noexcept
+  constexpr vector< T, 3 > cross(const vector< T, 3 >& rhs) const noexcept
   {
-    static_assert((M == 3) && (N == 3),
+    static_assert(N == 3,
                   "Cross product only makes sense if both vectors are size 3");
 
     return {this->storage_[1] * rhs[2] - this->storage_[2] * rhs[1],
@@ -115,42 +241,53 @@ public:
             this->storage_[0] * rhs[1] - this->storage_[1] * rhs[0]};
   }
 
+  //
+  // The precision policy P selects exact or approximate (precision::fast)
+  // square roots and plain, wide or compensated accumulation of the
+  // reductions, see precision.hpp
+  //
+  template < typename P = precision::exact >
   constexpr T sum() const noexcept
   {
-    auto s = T(0);
+    typename P::template accumulator< T > acc{};
 
     esl::repeat< N >([&](auto i) {
-      s += this->storage_[i];  // op
+      acc.add(this->storage_[i]);  // op
     });
 
-    return s;
+    return acc.result();
   }
 
+  template < typename P = precision::exact >
   constexpr T norm_squared() const noexcept
   {
-    auto s = T(0);
+    using A = typename P::template accumulator< T >;
+
+    if (use_simd() && A::plain)
+      return simd::ops< T, N >::dot(this->storage_, this->storage_);
+
+    A acc{};
 
     esl::repeat< N >([&](auto i) {
-      s += this->storage_[i] * this->storage_[i];  // op
+      acc.add_product(this->storage_[i], this->storage_[i]);  // op
     });
 
-    return s;
+    return acc.result();
   }
 
+  template < typename P = precision::exact >
   constexpr T norm() const noexcept
   {
-    return std::sqrt(norm_squared());
+    return P::sqrt(norm_squared< P >());
   }
 
+  template < typename P = precision::exact >
   constexpr void normalize() noexcept
   {
-    const auto nrm = norm();
+    const auto nrm_sq = norm_squared< P >();
 
-    if (nrm != T(0))
-    {
-      const auto norm_inv = T(1) / nrm;
-      *this *= norm_inv;
-    }
+    if (nrm_sq != T(0))
+      *this *= P::rsqrt(nrm_sq);
   }
 
   constexpr vector square() const noexcept
@@ -169,7 +306,7 @@ public:
     vector v;
 
     esl::repeat< N >([&](auto i) {
-      v.storage_[i] = std::sqrt(this->storage_[i]);  // op
+      v.storage_[i] = esl::sqrt(this->storage_[i]);  // op
     });
 
     return v;
@@ -180,7 +317,7 @@ public:
     vector v;
 
     esl::repeat< N >([&](auto i) {
-      v.storage_[i] = std::abs(this->storage_[i]);  // op
+      v.storage_[i] = esl::abs(this->storage_[i]);  // op
     });
 
     return v;
@@ -244,6 +381,12 @@ public:
   //
   constexpr vector& operator+=(const vector& rhs) noexcept
   {
+    if (use_simd())
+    {
+      simd::ops< T, N >::add(storage_, storage_, rhs.storage_);
+      return *this;
+    }
+
     esl::repeat< N >([&](auto i) {
       storage_[i] += rhs.storage_[i];  // op
     });
@@ -253,6 +396,12 @@ public:
 
   constexpr vector& operator-=(const vector& rhs) noexcept
   {
+    if (use_simd())
+    {
+      simd::ops< T, N >::sub(storage_, storage_, rhs.storage_);
+      return *this;
+    }
+
     esl::repeat< N >([&](auto i) {
       storage_[i] -= rhs.storage_[i];  // op
     });
@@ -260,61 +409,50 @@ public:
     return *this;
   }
 
-  constexpr vector& operator*=(const T& rhs) noexcept
+  template < typename E, typename = std::enable_if_t<
+                             details::is_vector_expression_node< E >::value > >
+  constexpr vector& operator+=(const E& expr) noexcept
   {
     esl::repeat< N >([&](auto i) {
-      storage_[i] *= rhs;  // op
+      storage_[i] += expr[i];  // op
     });
 
     return *this;
   }
 
-  constexpr vector& operator/=(const T& rhs) noexcept
+  template < typename E, typename = std::enable_if_t<
+                             details::is_vector_expression_node< E >::value > >
+  constexpr vector& operator-=(const E& expr) noexcept
   {
     esl::repeat< N >([&](auto i) {
-      storage_[i] /= rhs;  // op
+      storage_[i] -= expr[i];  // op
     });
 
     return *this;
   }
 
-  constexpr friend vector operator+(vector lhs, const vector& rhs) noexcept
-  {
-    lhs += rhs;
-    return lhs;
-  }
-
-  constexpr friend vector operator-(vector lhs, const vector& rhs) noexcept
+  constexpr vector& operator*=(const T& rhs) noexcept
   {
-    lhs -= rhs;
-    return lhs;
-  }
+    if (use_simd())
+    {
+      simd::ops< T, N >::scale(storage_, storage_, rhs);
+      return *this;
+    }
 
-  constexpr friend vector operator-(vector rhs) noexcept
-  {
     esl::repeat< N >([&](auto i) {
-      rhs.storage_[i] = -rhs.storage_[i];  // op
+      storage_[i] *= rhs;  // op
     });
 
-    return rhs;
-  }
-
-  constexpr friend vector operator*(vector lhs, const T& rhs) noexcept
-  {
-    lhs *= rhs;
-    return lhs;
+    return *this;
   }
 
-  constexpr friend vector operator*(const T& lhs, vector rhs) noexcept
+  constexpr vector& operator/=(const T& rhs) noexcept
   {
-    rhs *= lhs;
-    return rhs;
-  }
+    esl::repeat< N >([&](auto i) {
+      storage_[i] /= rhs;  // op
+    });
 
-  constexpr friend vector operator/(vector lhs, const T& rhs) noexcept
-  {
-    lhs /= rhs;
-    return lhs;
+    return *this;
   }
 };
 
@@ -0,0 +1,403 @@
+//          Copyright Emil Fresk 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include "precision.hpp"
+
+namespace esl
+{
+template < typename T, std::size_t N >
+class vector;
+
+//
+// Lazy expression templates for vector arithmetic. An expression such as
+// `a + b * s - c` builds a tree of small nodes, and is evaluated element by
+// element in a single loop when it is assigned to a vector, so no temporary
+// vectors are created. All operations are element-wise, which makes
+// assignments like `a = a + b` safe.
+//
+// Vectors passed as lvalues are held by reference, everything else (nodes,
+// temporary vectors and scalars) is held by value, so an expression never
+// refers to a destroyed temporary.
+//
+namespace details
+{
+template < typename... >
+using void_t = void;
+
+// Deduction helpers, also matching classes derived from vector (quaternion)
+template < typename T, std::size_t N >
+std::integral_constant< std::size_t, N > vector_size_of(const vector< T, N >&);
+
+template < typename T, std::size_t N >
+T vector_value_of(const vector< T, N >&);
+
+//
+// Traits for vectors (leaves) and expression nodes
+//
+template < typename E, typename = void >
+struct expression_traits
+{
+  static constexpr bool is_expression = false;
+  static constexpr bool is_node = false;
+};
+
+template < typename E >
+struct expression_traits<
+    E, void_t< decltype(vector_size_of(std::declval< const E& >())) > >
+{
+  static constexpr bool is_expression = true;
+  static constexpr bool is_node = false;
+
+  using value_type = decltype(vector_value_of(std::declval< const E& >()));
+  static constexpr std::size_t size =
+      decltype(vector_size_of(std::declval< const E& >()))::value;
+};
+
+template < typename E >
+struct expression_traits< E, void_t< typename E::expression_tag > >
+{
+  static constexpr bool is_expression = true;
+  static constexpr bool is_node = true;
+
+  using value_type = typename E::value_type;
+  static constexpr std::size_t size = E::size;
+};
+
+template < typename E >
+using is_vector_expression =
+    std::integral_constant< bool,
+                            expression_traits< std::decay_t< E > >::is_expression >;
+
+template < typename E >
+using is_vector_expression_node =
+    std::integral_constant< bool,
+                            expression_traits< std::decay_t< E > >::is_node >;
+
+// lvalue vectors by reference, anything else by value
+template < typename E >
+using operand_t = std::conditional_t<
+    std::is_lvalue_reference< E >::value &&
+        !is_vector_expression_node< E >::value,
+    const std::decay_t< E >&, std::decay_t< E > >;
+
+//
+// Element-wise operations
+//
+struct op_add
+{
+  template < typename T >
+  constexpr T operator()(const T& a, const T& b) const noexcept
+  {
+    return a + b;
+  }
+};
+
+struct op_sub
+{
+  template < typename T >
+  constexpr T operator()(const T& a, const T& b) const noexcept
+  {
+    return a - b;
+  }
+};
+
+struct op_mul
+{
+  template < typename T >
+  constexpr T operator()(const T& a, const T& b) const noexcept
+  {
+    return a * b;
+  }
+};
+
+struct op_div
+{
+  template < typename T >
+  constexpr T operator()(const T& a, const T& b) const noexcept
+  {
+    return a / b;
+  }
+};
+
+}  // namespace details
+
+//
+// Common base of the expression nodes, gives read access and the non
+// modifying vector functions through evaluation
+//
+template < typename Derived, typename T, std::size_t N >
+class vector_expression
+{
+public:
+  struct expression_tag
+  {
+  };
+
+  using value_type = T;
+  static constexpr std::size_t size = N;
+
+  constexpr const Derived& self() const noexcept
+  {
+    return static_cast< const Derived& >(*this);
+  }
+
+  constexpr vector< T, N > eval() const noexcept
+  {
+    return vector< T, N >(self());
+  }
+
+  constexpr T x() const noexcept
+  {
+    return self()[0];
+  }
+
+  constexpr T y() const noexcept
+  {
+    return self()[1];
+  }
+
+  constexpr T z() const noexcept
+  {
+    return self()[2];
+  }
+
+  constexpr vector< T, N > dot(const vector< T, N >& rhs) const noexcept
+  {
+    return eval().dot(rhs);
+  }
+
+  constexpr vector< T, 3 > cross(const vector< T, 3 >& rhs) const noexcept
+  {
+    return eval().cross(rhs);
+  }
+
+  template < typename P = precision::exact >
+  constexpr T sum() const noexcept
+  {
+    return eval().template sum< P >();
+  }
+
+  template < typename P = precision::exact >
+  constexpr T norm_squared() const noexcept
+  {
+    return eval().template norm_squared< P >();
+  }
+
+  template < typename P = precision::exact >
+  constexpr T norm() const noexcept
+  {
+    return eval().template norm< P >();
+  }
+
+  constexpr vector< T, N > square() const noexcept
+  {
+    return eval().square();
+  }
+
+  constexpr vector< T, N > sqrt() const noexcept
+  {
+    return eval().sqrt();
+  }
+
+  constexpr vector< T, N > abs() const noexcept
+  {
+    return eval().abs();
+  }
+};
+
+//
+// Element-wise binary operation of two vector expressions
+//
+template < typename Op, typename L, typename R >
+class vector_binary_expression
+    : public vector_expression<
+          vector_binary_expression< Op, L, R >,
+          typename details::expression_traits< std::decay_t< L > >::value_type,
+          details::expression_traits< std::decay_t< L > >::size >
+{
+  L lhs_;
+  R rhs_;
+
+public:
+  template < typename A, typename B >
+  constexpr vector_binary_expression(A&& lhs, B&& rhs) noexcept
+      : lhs_(std::forward< A >(lhs)), rhs_(std::forward< B >(rhs))
+  {
+  }
+
+  template < typename I >
+  constexpr auto operator[](I i) const noexcept
+  {
+    return Op{}(lhs_[i], rhs_[i]);
+  }
+
+  // The operands, for evaluation of whole vectors at once
+  constexpr const std::decay_t< L >& lhs() const noexcept
+  {
+    return lhs_;
+  }
+
+  constexpr const std::decay_t< R >& rhs() const noexcept
+  {
+    return rhs_;
+  }
+};
+
+//
+// Element-wise operation of a vector expression and a scalar
+//
+template < typename Op, typename E, bool ScalarFirst >
+class vector_scalar_expression
+    : public vector_expression<
+          vector_scalar_expression< Op, E, ScalarFirst >,
+          typename details::expression_traits< std::decay_t< E > >::value_type,
+          details::expression_traits< std::decay_t< E > >::size >
+{
+  using T =
+      typename details::expression_traits< std::decay_t< E > >::value_type;
+
+  E expr_;
+  T scalar_;
+
+public:
+  template < typename A >
+  constexpr vector_scalar_expression(A&& expr, const T& scalar) noexcept
+      : expr_(std::forward< A >(expr)), scalar_(scalar)
+  {
+  }
+
+  template < typename I >
+  constexpr auto operator[](I i) const noexcept
+  {
+    return ScalarFirst ? Op{}(scalar_, expr_[i]) : Op{}(expr_[i], scalar_);
+  }
+
+  constexpr const std::decay_t< E >& expr() const noexcept
+  {
+    return expr_;
+  }
+
+  constexpr const T& scalar() const noexcept
+  {
+    return scalar_;
+  }
+};
+
+//
+// Element-wise negation
+//
+template < typename E >
+class vector_negate_expression
+    : public vector_expression<
+          vector_negate_expression< E >,
+          typename details::expression_traits< std::decay_t< E > >::value_type,
+          details::expression_traits< std::decay_t< E > >::size >
+{
+  E expr_;
+
+public:
+  template < typename A >
+  constexpr explicit vector_negate_expression(A&& expr) noexcept
+      : expr_(std::forward< A >(expr))
+  {
+  }
+
+  template < typename I >
+  constexpr auto operator[](I i) const noexcept
+  {
+    return -expr_[i];
+  }
+
+  constexpr const std::decay_t< E >& expr() const noexcept
+  {
+    return expr_;
+  }
+};
+
+namespace details
+{
+template < typename L, typename R >
+using enable_if_vector_pair_t = std::enable_if_t<
+    is_vector_expression< L >::value && is_vector_expression< R >::value &&
+    std::is_same<
+        typename expression_traits< std::decay_t< L > >::value_type,
+        typename expression_traits< std::decay_t< R > >::value_type >::value &&
+    (expression_traits< std::decay_t< L > >::size ==
+     expression_traits< std::decay_t< R > >::size) >;
+
+template < typename E, typename S >
+using enable_if_vector_scalar_t = std::enable_if_t<
+    is_vector_expression< E >::value && !is_vector_expression< S >::value &&
+    std::is_convertible<
+        S, typename expression_traits< std::decay_t< E > >::value_type >::
+        value >;
+
+template < typename E >
+using value_type_t = typename expression_traits< std::decay_t< E > >::value_type;
+
+}  // namespace details
+
+//
+// Operators
+//
+template < typename L, typename R,
+           typename = details::enable_if_vector_pair_t< L, R > >
+constexpr auto operator+(L&& lhs, R&& rhs) noexcept
+{
+  return vector_binary_expression< details::op_add, details::operand_t< L >,
+                                   details::operand_t< R > >(
+      std::forward< L >(lhs), std::forward< R >(rhs));
+}
+
+template < typename L, typename R,
+           typename = details::enable_if_vector_pair_t< L, R > >
+constexpr auto operator-(L&& lhs, R&& rhs) noexcept
+{
+  return vector_binary_expression< details::op_sub, details::operand_t< L >,
+                                   details::operand_t< R > >(
+      std::forward< L >(lhs), std::forward< R >(rhs));
+}
+
+template < typename E, typename S,
+           typename = details::enable_if_vector_scalar_t< E, S > >
+constexpr auto operator*(E&& lhs, const S& rhs) noexcept
+{
+  return vector_scalar_expression< details::op_mul, details::operand_t< E >,
+                                   false >(
+      std::forward< E >(lhs), static_cast< details::value_type_t< E > >(rhs));
+}
+
+template < typename S, typename E,
+           typename = details::enable_if_vector_scalar_t< E, S > >
+constexpr auto operator*(const S& lhs, E&& rhs) noexcept
+{
+  return vector_scalar_expression< details::op_mul, details::operand_t< E >,
+                                   true >(
+      std::forward< E >(rhs), static_cast< details::value_type_t< E > >(lhs));
+}
+
+template < typename E, typename S,
+           typename = details::enable_if_vector_scalar_t< E, S > >
+constexpr auto operator/(E&& lhs, const S& rhs) noexcept
+{
+  return vector_scalar_expression< details::op_div, details::operand_t< E >,
+                                   false >(
+      std::forward< E >(lhs), static_cast< details::value_type_t< E > >(rhs));
+}
+
+template < typename E,
+           typename = std::enable_if_t< details::is_vector_expression< E >::value > >
+constexpr auto operator-(E&& rhs) noexcept
+{
+  return vector_negate_expression< details::operand_t< E > >(
+      std::forward< E >(rhs));
+}
+
+}  // namespace esl
@@ -0,0 +1,589 @@
+//          Copyright Emil Fresk 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "work_stealing_deque.hpp"
+#include "../callable/task.hpp"
+#include "../containers/allocate.hpp"
+#include "../containers/task_queue.hpp"
+#include "../helpers/error_functions.hpp"
+#include "../helpers/feature_defs.hpp"
+
+namespace esl
+{
+//
+// Work-stealing thread pool executing move-only tasks.
+//
+// Each worker owns a Chase-Lev deque of pointers into a fixed ring of task
+// slots, so submitting from a worker never allocates or locks. Idle workers
+// steal from the top of the other workers' deques. Tasks submitted from
+// outside of the pool go through a mutex protected injection queue.
+//
+// When a worker's slots (or the injection queue) are full the task is run
+// inline by the submitter, which gives natural back-pressure. Its exception
+// is kept for wait_idle() as for any other task, submit() does not throw it.
+//
+// A task must not call wait_idle() or destroy the pool it runs on, it would
+// wait for itself. The error function is called and wait_idle() returns
+// without waiting. Waiting for a parallel_for from a task is fine.
+//
+// An exception thrown by a task is caught by the thread running it, the first
+// one is rethrown by the next wait_idle() after all tasks have finished. An
+// exception thrown by the function of a parallel_for is rethrown by that
+// parallel_for, after the whole range has been handled.
+//
+template < typename Task = task<>, std::size_t Capacity = 1024,
+           typename ErrFun = error_functions::noop >
+class thread_pool
+{
+  static_assert(details::is_power_of_2(Capacity),
+                "thread_pool only accepts capacity in powers of 2.");
+
+public:
+  using size_type = std::size_t;
+  using task_type = Task;
+
+private:
+  using CheckBounds = std::integral_constant<
+      bool, !std::is_same< ErrFun, error_functions::noop >::value >;
+
+  //
+  // Storage for a submitted task, the busy flag is cleared by the thread that
+  // ran the task so the owner knows when the slot can be reused
+  //
+  struct slot
+  {
+    Task work;
+    std::atomic< bool > busy{false};
+  };
+
+  struct worker
+  {
+    work_stealing_deque< slot*, Capacity > deque;
+    slot slots[Capacity];
+    size_type next_slot = 0;
+    std::thread thread;
+  };
+
+  std::unique_ptr< worker[] > workers_;
+  size_type num_workers_;
+
+  std::mutex inject_mutex_;
+  allocate< task_queue< Task >, Capacity > inject_;
+
+  // Tasks waiting to be run, and tasks not yet finished
+  std::atomic< size_type > queued_{0};
+  std::atomic< size_type > pending_{0};
+
+  std::mutex sleep_mutex_;
+  std::condition_variable sleep_cv_;
+  std::atomic< size_type > sleeping_{0};
+  std::atomic< bool > stop_{false};
+
+  // First exception thrown by a task, for wait_idle
+  std::mutex error_mutex_;
+  std::exception_ptr error_;
+
+  // The worker the current thread runs, if any
+  static thread_local worker* current_worker_;
+  static thread_local thread_pool* current_pool_;
+
+  worker* this_worker() const noexcept
+  {
+    return (current_pool_ == this) ? current_worker_ : nullptr;
+  }
+
+  void wake_one()
+  {
+    if (sleeping_.load() > 0)
+    {
+      std::lock_guard< std::mutex > lock(sleep_mutex_);
+      sleep_cv_.notify_one();
+    }
+  }
+
+  //
+  // Finishes a task also when it throws: clears its slot, if any, and counts
+  // it as done. The guards of the tasks running on a thread form a chain, to
+  // find out if the thread is inside a task of a pool.
+  //
+  class finish_guard
+  {
+    thread_pool& pool_;
+    slot* slot_;
+    finish_guard* prev_;
+
+  public:
+    finish_guard(thread_pool& pool, slot* s) noexcept
+        : pool_(pool), slot_(s), prev_(running_)
+    {
+      running_ = this;
+    }
+
+    ~finish_guard()
+    {
+      running_ = prev_;
+
+      if (slot_ != nullptr)
+      {
+        slot_->work = Task{};
+        slot_->busy.store(false, std::memory_order_release);
+      }
+
+      pool_.pending_.fetch_sub(1, std::memory_order_acq_rel);
+    }
+
+    finish_guard(const finish_guard&) = delete;
+    finish_guard& operator=(const finish_guard&) = delete;
+
+    static bool in_task_of(const thread_pool* pool) noexcept
+    {
+      for (auto* g = running_; g != nullptr; g = g->prev_)
+      {
+        if (&g->pool_ == pool)
+          return true;
+      }
+
+      return false;
+    }
+  };
+
+  // Innermost task running on the current thread, if any
+  static thread_local finish_guard* running_;
+
+  void run_slot(slot* s)
+  {
+    finish_guard guard(*this, s);
+    s->work();
+  }
+
+  //
+  // Tries to find and run one task, returns false if no task was found
+  //
+  bool run_one(worker* self)
+  {
+    slot* s = nullptr;
+
+    // Own deque first (LIFO, cache friendly)
+    if (self != nullptr && self->deque.pop(s))
+    {
+      queued_.fetch_sub(1, std::memory_order_relaxed);
+      run_slot(s);
+      return true;
+    }
+
+    // Externally submitted tasks
+    if (queued_.load(std::memory_order_relaxed) > 0)
+    {
+      Task t;
+      bool found = false;
+
+      {
+        std::lock_guard< std::mutex > lock(inject_mutex_);
+
+        if (!inject_.empty())
+        {
+          t = std::move(inject_.front());
+          inject_.pop();
+          found = true;
+        }
+      }
+
+      if (found)
+      {
+        queued_.fetch_sub(1, std::memory_order_relaxed);
+
+        finish_guard guard(*this, nullptr);
+        t();
+        return true;
+      }
+    }
+
+    // Steal from the others, start after ourselves to spread the thieves
+    const auto start = (self != nullptr) ? (self - workers_.get()) + 1 : 0;
+
+    for (size_type i = 0; i < num_workers_; ++i)
+    {
+      auto& victim = workers_[(start + i) % num_workers_];
+
+      if (&victim != self && victim.deque.steal(s))
+      {
+        queued_.fetch_sub(1, std::memory_order_relaxed);
+        run_slot(s);
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  // Keeps the exception being handled for wait_idle, if it is the first
+  void keep_error() noexcept
+  {
+    std::lock_guard< std::mutex > lock(error_mutex_);
+
+    if (!error_)
+      error_ = std::current_exception();
+  }
+
+  //
+  // As run_one, but an exception thrown by the task is kept for wait_idle
+  //
+  bool run_one_caught(worker* self) noexcept
+  {
+    try
+    {
+      return run_one(self);
+    }
+    catch (...)
+    {
+      keep_error();
+      return true;
+    }
+  }
+
+  // Runs a task that did not fit in the queues, on the submitting thread
+  void run_slot_inline(slot* s) noexcept
+  {
+    try
+    {
+      run_slot(s);
+    }
+    catch (...)
+    {
+      keep_error();
+    }
+  }
+
+  template < typename F >
+  void run_inline(F& fun) noexcept
+  {
+    try
+    {
+      fun();
+    }
+    catch (...)
+    {
+      keep_error();
+    }
+  }
+
+  void worker_loop(worker* self)
+  {
+    current_worker_ = self;
+    current_pool_ = this;
+
+    std::size_t idle_spins = 0;
+
+    while (true)
+    {
+      if (run_one_caught(self))
+      {
+        idle_spins = 0;
+        continue;
+      }
+
+      if (stop_.load() && pending_.load() == 0)
+        break;
+
+      if (++idle_spins < 64)
+      {
+        std::this_thread::yield();
+        continue;
+      }
+
+      // Nothing to do for a while, go to sleep
+      std::unique_lock< std::mutex > lock(sleep_mutex_);
+      sleeping_.fetch_add(1);
+      sleep_cv_.wait(lock, [&] { return stop_.load() || queued_.load() > 0; });
+      sleeping_.fetch_sub(1);
+
+      idle_spins = 0;
+    }
+
+    current_worker_ = nullptr;
+    current_pool_ = nullptr;
+  }
+
+  // Stops the workers and joins the first num_started of them
+  void stop_workers(size_type num_started)
+  {
+    {
+      std::lock_guard< std::mutex > lock(sleep_mutex_);
+      stop_.store(true);
+    }
+
+    sleep_cv_.notify_all();
+
+    for (size_type i = 0; i < num_started; ++i)
+      workers_[i].thread.join();
+  }
+
+  static void pin_to_core(std::thread& t, size_type core) noexcept
+  {
+#if defined(__linux__)
+    const auto num_cores = std::thread::hardware_concurrency();
+
+    if (num_cores == 0)
+      return;
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(core % num_cores, &set);
+    (void)pthread_setaffinity_np(t.native_handle(), sizeof(set), &set);
+#else
+    (void)t;
+    (void)core;
+#endif
+  }
+
+  //
+  // Range splitting for parallel_for, the context lives on the stack of the
+  // parallel_for so every subrange is counted in remaining also when it throws
+  //
+  template < typename F >
+  struct range_context
+  {
+    F* fun;
+    size_type grain;
+    std::atomic< size_type > remaining;
+    thread_pool* pool;
+    std::atomic< bool > failed;
+    std::exception_ptr error;
+  };
+
+  template < typename F >
+  static void run_range(range_context< F >* ctx, size_type begin,
+                        size_type end) noexcept
+  {
+    try
+    {
+      // Split off the upper half for thieves until the range is small enough
+      while (end - begin > ctx->grain)
+      {
+        const auto mid = begin + (end - begin) / 2;
+        ctx->pool->submit(
+            [ctx, mid, end] { run_range(ctx, mid, end); });  // hand off
+        end = mid;
+      }
+
+      // After a throw the rest of the range is skipped
+      for (auto i = begin; i < end && !ctx->failed.load(); ++i)
+        (*ctx->fun)(i);
+    }
+    catch (...)
+    {
+      if (!ctx->failed.exchange(true))
+        ctx->error = std::current_exception();
+    }
+
+    ctx->remaining.fetch_sub(end - begin, std::memory_order_acq_rel);
+  }
+
+public:
+  //
+  // Constructor / Destructor
+  //
+  explicit thread_pool(
+      size_type num_threads = std::thread::hardware_concurrency(),
+      bool pin_threads = false)
+      : workers_{new worker[num_threads > 0 ? num_threads : 1]},
+        num_workers_{num_threads > 0 ? num_threads : 1}
+  {
+    size_type started = 0;
+
+    try
+    {
+      for (; started < num_workers_; ++started)
+      {
+        auto* w = &workers_[started];
+        w->thread = std::thread([this, w] { worker_loop(w); });
+
+        if (pin_threads)
+          pin_to_core(w->thread, started);
+      }
+    }
+    catch (...)
+    {
+      // A thread could not be started, the started ones must be joined
+      // before their std::thread objects are destroyed
+      stop_workers(started);
+      throw;
+    }
+  }
+
+  thread_pool(const thread_pool&) = delete;
+  thread_pool& operator=(const thread_pool&) = delete;
+
+  // Runs all submitted tasks before joining the workers, an exception kept
+  // from a task is dropped
+  ~thread_pool()
+  {
+    try
+    {
+      wait_idle();
+    }
+    catch (...)
+    {
+    }
+
+    stop_workers(num_workers_);
+  }
+
+  constexpr size_type size() const noexcept
+  {
+    return num_workers_;
+  }
+
+  //
+  // Submit a task, from a worker it goes to the worker's own deque
+  //
+  template < typename F >
+  void submit(F&& fun)
+  {
+    auto* self = this_worker();
+
+    if (self != nullptr)
+    {
+      auto& s = self->slots[self->next_slot & (Capacity - 1)];
+
+      if (!s.busy.load(std::memory_order_acquire))
+      {
+        s.work = Task(std::forward< F >(fun));
+        s.busy.store(true, std::memory_order_relaxed);
+
+        pending_.fetch_add(1, std::memory_order_relaxed);
+        queued_.fetch_add(1);
+
+        if (self->deque.push(&s))
+        {
+          ++self->next_slot;
+          wake_one();
+          return;
+        }
+
+        // Deque full, undo and run inline
+        queued_.fetch_sub(1, std::memory_order_relaxed);
+        run_slot_inline(&s);
+        return;
+      }
+    }
+    else
+    {
+      std::unique_lock< std::mutex > lock(inject_mutex_);
+
+      if (!inject_.full())
+      {
+        inject_.emplace_back(std::forward< F >(fun));
+        pending_.fetch_add(1, std::memory_order_relaxed);
+        queued_.fetch_add(1);
+        lock.unlock();
+
+        wake_one();
+        return;
+      }
+    }
+
+    // No room, run inline
+    run_inline(fun);
+  }
+
+  //
+  // Blocks until all submitted tasks have finished, the calling thread helps
+  // running tasks while waiting. Not from a task of this pool, see above.
+  // Rethrows the first exception thrown by a task since the last wait_idle.
+  //
+  void wait_idle()
+  {
+    if (finish_guard::in_task_of(this))
+    {
+      if
+        ESL_CONSTEXPR_IF(CheckBounds())
+      ErrFun{}("wait_idle from a task of the pool");
+
+      return;
+    }
+
+    auto* self = this_worker();
+
+    while (pending_.load(std::memory_order_acquire) > 0)
+    {
+      if (!run_one_caught(self))
+        std::this_thread::yield();
+    }
+
+    std::exception_ptr error;
+
+    {
+      std::lock_guard< std::mutex > lock(error_mutex_);
+      std::swap(error, error_);
+    }
+
+    if (error)
+      std::rethrow_exception(error);
+  }
+
+  //
+  // Calls fun(i) for all i in [begin, end), split in chunks of at least
+  // grain indices. Blocks until done, the calling thread helps. If fun
+  // throws, the rest of the range is skipped and the first exception is
+  // rethrown once all started chunks have finished.
+  //
+  template < typename F >
+  void parallel_for(size_type begin, size_type end, size_type grain, F&& fun)
+  {
+    if (end <= begin)
+      return;
+
+    range_context< std::remove_reference_t< F > > ctx{
+        std::addressof(fun), grain > 0 ? grain : 1, {end - begin}, this,
+        {false}, nullptr};
+
+    run_range(&ctx, begin, end);
+
+    auto* self = this_worker();
+
+    // Other tasks run while waiting keep their exceptions for wait_idle, so
+    // nothing leaves here while a subrange may still use ctx
+    while (ctx.remaining.load(std::memory_order_acquire) > 0)
+    {
+      if (!run_one_caught(self))
+        std::this_thread::yield();
+    }
+
+    if (ctx.error)
+      std::rethrow_exception(ctx.error);
+  }
+};
+
+template < typename Task, std::size_t Capacity, typename ErrFun >
+thread_local typename thread_pool< Task, Capacity, ErrFun >::worker*
+    thread_pool< Task, Capacity, ErrFun >::current_worker_ = nullptr;
+
+template < typename Task, std::size_t Capacity, typename ErrFun >
+thread_local thread_pool< Task, Capacity, ErrFun >*
+    thread_pool< Task, Capacity, ErrFun >::current_pool_ = nullptr;
+
+template < typename Task, std::size_t Capacity, typename ErrFun >
+thread_local typename thread_pool< Task, Capacity, ErrFun >::finish_guard*
+    thread_pool< Task, Capacity, ErrFun >::running_ = nullptr;
+
+}  // namespace esl
@@ -0,0 +1,152 @@
+//          Copyright Emil Fresk 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+
+#include "../containers/ring_buffer.hpp"
+
+namespace esl
+{
+//
+// Fixed capacity Chase-Lev work-stealing deque, based on "Correct and
+// Efficient Work-Stealing for Weak Memory Models" by Lê et al. (PPoPP 2013).
+//
+// The owner thread pushes and pops at the bottom, any other thread may steal
+// from the top. Elements are read racily by thieves, so they must be
+// trivially copyable (typically a pointer to the work item).
+//
+template < typename T, std::size_t Capacity >
+class work_stealing_deque
+{
+  static_assert(std::is_trivially_copyable< T >::value,
+                "The element type must be trivially copyable");
+  static_assert(details::is_power_of_2(Capacity),
+                "work_stealing_deque only accepts capacity in powers of 2.");
+
+private:
+  static constexpr std::int64_t mask_ = Capacity - 1;
+
+  // Padded to keep the thief and owner ends on separate cache lines, padding
+  // is used instead of alignas so the deque can be allocated with new in C++14
+  static constexpr std::size_t cache_line_ = 64;
+
+  std::atomic< std::int64_t > top_{0};
+  char top_pad_[cache_line_ - sizeof(std::atomic< std::int64_t >)];
+  std::atomic< std::int64_t > bottom_{0};
+  char bottom_pad_[cache_line_ - sizeof(std::atomic< std::int64_t >)];
+  std::atomic< T > buffer_[Capacity];
+
+public:
+  //
+  // Standard type definitions
+  //
+  using size_type = std::size_t;
+  using value_type = T;
+
+  work_stealing_deque() noexcept = default;
+
+  work_stealing_deque(const work_stealing_deque&) = delete;
+  work_stealing_deque& operator=(const work_stealing_deque&) = delete;
+
+  //
+  // Capacity, only approximate when other threads are stealing
+  //
+  size_type size() const noexcept
+  {
+    const auto b = bottom_.load(std::memory_order_relaxed);
+    const auto t = top_.load(std::memory_order_relaxed);
+
+    return (b > t) ? static_cast< size_type >(b - t) : 0;
+  }
+
+  constexpr size_type capacity() const noexcept
+  {
+    return Capacity;
+  }
+
+  bool empty() const noexcept
+  {
+    return size() == 0;
+  }
+
+  //
+  // Owner operations
+  //
+
+  // Returns false if the deque is full
+  bool push(T item) noexcept
+  {
+    const auto b = bottom_.load(std::memory_order_relaxed);
+    const auto t = top_.load(std::memory_order_acquire);
+
+    if (b - t >= static_cast< std::int64_t >(Capacity))
+      return false;
+
+    buffer_[b & mask_].store(item, std::memory_order_relaxed);
+    bottom_.store(b + 1, std::memory_order_release);
+
+    return true;
+  }
+
+  // Returns false if the deque is empty or the last item was stolen
+  bool pop(T& item) noexcept
+  {
+    const auto b = bottom_.load(std::memory_order_relaxed) - 1;
+    bottom_.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    auto t = top_.load(std::memory_order_relaxed);
+
+    if (t > b)
+    {
+      // Empty
+      bottom_.store(b + 1, std::memory_order_relaxed);
+      return false;
+    }
+
+    item = buffer_[b & mask_].load(std::memory_order_relaxed);
+
+    if (t == b)
+    {
+      // Last item, race against thieves
+      const bool won = top_.compare_exchange_strong(
+          t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+      bottom_.store(b + 1, std::memory_order_relaxed);
+
+      return won;
+    }
+
+    return true;
+  }
+
+  //
+  // Thief operation, any thread
+  //
+
+  // Returns false if the deque is empty or another thread won the item
+  bool steal(T& item) noexcept
+  {
+    auto t = top_.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const auto b = bottom_.load(std::memory_order_acquire);
+
+    if (t >= b)
+      return false;
+
+    const auto v = buffer_[t & mask_].load(std::memory_order_relaxed);
+
+    if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                      std::memory_order_relaxed))
+      return false;
+
+    item = v;
+    return true;
+  }
+};
+
+}  // namespace esl
@@ -0,0 +1,159 @@
+//          Copyright Emil Fresk 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include <esl/helpers/atomic_flag_enum.hpp>
+
+enum class test_flags
+{
+  A,
+  B,
+  C,
+  D
+};
+
+enum class wide_flags : std::uint64_t
+{
+  low = 0,
+  high = 63
+};
+
+TEST(test_atomic_flag_enum, set_clear_test)
+{
+  esl::atomic_flag_enum< test_flags > f;
+
+  ASSERT_TRUE(f.none());
+
+  f.set(test_flags::A);
+  f.set(test_flags::B, test_flags::C);
+
+  ASSERT_TRUE(f[test_flags::A]);
+  ASSERT_TRUE(f[test_flags::B]);
+  ASSERT_TRUE(f[test_flags::C]);
+  ASSERT_FALSE(f[test_flags::D]);
+
+  f.clear(test_flags::A, test_flags::C);
+
+  ASSERT_FALSE(f[test_flags::A]);
+  ASSERT_TRUE(f[test_flags::B]);
+  ASSERT_FALSE(f[test_flags::C]);
+
+  f.clear();
+
+  ASSERT_TRUE(f.none());
+}
+
+TEST(test_atomic_flag_enum, any_all_test)
+{
+  esl::atomic_flag_enum< test_flags > f(test_flags::B, test_flags::C);
+
+  ASSERT_TRUE(f.any(test_flags::A, test_flags::B));
+  ASSERT_FALSE(f.any(test_flags::A, test_flags::D));
+  ASSERT_TRUE(f.all(test_flags::B, test_flags::C));
+  ASSERT_FALSE(f.all(test_flags::C, test_flags::D));
+  ASSERT_TRUE(f.all(test_flags::B));
+}
+
+TEST(test_atomic_flag_enum, test_and_set_test)
+{
+  esl::atomic_flag_enum< test_flags > f;
+
+  ASSERT_FALSE(f.test_and_set(test_flags::D));
+  ASSERT_TRUE(f.test_and_set(test_flags::D));
+  ASSERT_TRUE(f.test_and_clear(test_flags::D));
+  ASSERT_FALSE(f.test_and_clear(test_flags::D));
+  ASSERT_TRUE(f.none());
+}
+
+TEST(test_atomic_flag_enum, word_size_test)
+{
+  static_assert(sizeof(esl::atomic_flag_enum< test_flags >) == 4, "");
+  static_assert(sizeof(esl::atomic_flag_enum< wide_flags >) == 8, "");
+
+  esl::atomic_flag_enum< wide_flags > f;
+
+  f.set(wide_flags::high);
+
+  ASSERT_TRUE(f[wide_flags::high]);
+  ASSERT_FALSE(f[wide_flags::low]);
+}
+
+// Each thread owns one flag and toggles it, no update may be lost
+TEST(test_atomic_flag_enum, concurrent_test)
+{
+  esl::atomic_flag_enum< test_flags > f;
+  std::vector< std::thread > threads;
+
+  for (int t = 0; t < 4; ++t)
+    threads.emplace_back([&f, t] {
+      const auto flag = static_cast< test_flags >(t);
+
+      for (int i = 0; i < 10000; ++i)
+      {
+        f.set(flag);
+
+        if (!f[flag])
+          std::abort();
+
+        f.clear(flag);
+
+        if (f[flag])
+          std::abort();
+      }
+
+      f.set(flag);
+    });
+
+  for (auto& t : threads)
+    t.join();
+
+  ASSERT_TRUE(
+      f.all(test_flags::A, test_flags::B, test_flags::C, test_flags::D));
+}
+
+// test_and_set as a try-lock, only one thread at a time gets it
+TEST(test_atomic_flag_enum, exclusive_test)
+{
+  esl::atomic_flag_enum< test_flags > f;
+  std::atomic< int > inside{0};
+  std::atomic< int > max_inside{0};
+  int counter = 0;
+  std::vector< std::thread > threads;
+
+  for (int t = 0; t < 4; ++t)
+    threads.emplace_back([&] {
+      for (int i = 0; i < 1000; ++i)
+      {
+        while (f.test_and_set(test_flags::A))
+          std::this_thread::yield();
+
+        const int n = inside.fetch_add(1) + 1;
+
+        if (n > max_inside.load())
+          max_inside.store(n);
+
+        ++counter;
+        inside.fetch_sub(1);
+        f.clear(test_flags::A);
+      }
+    });
+
+  for (auto& t : threads)
+    t.join();
+
+  ASSERT_EQ(1, max_inside.load());
+  ASSERT_EQ(4000, counter);
+}
+
+int main(int argc, char *argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,349 @@
+//          Copyright Emil Fresk 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+#include <gtest/gtest.h>
+#include <esl/math/batch.hpp>
+#include <esl/parallel/thread_pool.hpp>
+
+// Odd size to exercise the scalar remainder
+constexpr std::size_t num_elements = 1003;
+
+struct points
+{
+  std::vector< float > x, y, z;
+
+  points() : x(num_elements), y(num_elements), z(num_elements)
+  {
+  }
+
+  explicit points(unsigned seed) : points()
+  {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution< float > dist(-10.0f, 10.0f);
+
+    for (std::size_t i = 0; i < num_elements; ++i)
+    {
+      x[i] = dist(gen);
+      y[i] = dist(gen);
+      z[i] = dist(gen);
+    }
+  }
+
+  esl::batch::soa_view< float, 3 > view()
+  {
+    return {{{x.data(), y.data(), z.data()}}, num_elements};
+  }
+
+  esl::vector3f at(std::size_t i) const
+  {
+    return {x[i], y[i], z[i]};
+  }
+};
+
+// Relative tolerance, the kernels may contract or reorder the arithmetic
+// (FMA, wider registers) so results differ by a few ulp from the reference
+float tolerance(float ref)
+{
+  return 1e-5f * std::max(1.0f, std::abs(ref));
+}
+
+void expect_near(const esl::vector3f& a, const esl::vector3f& b)
+{
+  EXPECT_NEAR(a[0], b[0], tolerance(a[0]));
+  EXPECT_NEAR(a[1], b[1], tolerance(a[1]));
+  EXPECT_NEAR(a[2], b[2], tolerance(a[2]));
+}
+
+esl::quaternionf unit_quaternion(float w, float x, float y, float z)
+{
+  esl::quaternionf q(w, x, y, z);
+  q.normalize();
+  return q;
+}
+
+TEST(test_batch, test_rotate)
+{
+  points in(1), out;
+  const auto q = unit_quaternion(1, 2, 3, 4);
+
+  esl::batch::rotate(q, in.view(), out.view());
+
+  for (std::size_t i = 0; i < num_elements; ++i)
+    expect_near(q.rotate(in.at(i)), out.at(i));
+
+  // In place
+  esl::batch::rotate(q, out.view(), out.view());
+
+  for (std::size_t i = 0; i < num_elements; ++i)
+    expect_near(q.rotate(q.rotate(in.at(i))), out.at(i));
+}
+
+TEST(test_batch, test_rotate_per_element)
+{
+  points in(2), out;
+  std::vector< float > qx(num_elements), qy(num_elements), qz(num_elements),
+      qw(num_elements);
+
+  for (std::size_t i = 0; i < num_elements; ++i)
+  {
+    const auto q = unit_quaternion(1, float(i), 2, -float(i) / 3);
+    qx[i] = q.x();
+    qy[i] = q.y();
+    qz[i] = q.z();
+    qw[i] = q.w();
+  }
+
+  esl::batch::soa_view< float, 4 > qv{
+      {{qx.data(), qy.data(), qz.data(), qw.data()}}, num_elements};
+
+  esl::batch::rotate< float >(qv, in.view(), out.view());
+
+  for (std::size_t i = 0; i < num_elements; ++i)
+  {
+    const esl::quaternionf q(qw[i], qx[i], qy[i], qz[i]);
+    expect_near(q.rotate(in.at(i)), out.at(i));
+  }
+}
+
+TEST(test_batch, test_normalize)
+{
+  points p(3);
+  p.x[5] = p.y[5] = p.z[5] = 0;
+
+  esl::batch::normalize(p.view());
+
+  for (std::size_t i = 0; i < num_elements; ++i)
+  {
+    if (i == 5)
+      ASSERT_EQ(0.0f, p.at(i).norm());
+    else
+      ASSERT_NEAR(1.0f, p.at(i).norm(), 1e-5f);
+  }
+}
+
+TEST(test_batch, test_dot_cross)
+{
+  points a(4), b(5), c;
+  std::vector< float > d(num_elements);
+
+  esl::batch::dot(a.view(), b.view(), d.data());
+  esl::batch::cross< float >(a.view(), b.view(), c.view());
+
+  for (std::size_t i = 0; i < num_elements; ++i)
+  {
+    ASSERT_NEAR(a.at(i).dot(b.at(i)).sum(), d[i], tolerance(d[i]));
+    expect_near(a.at(i).cross(b.at(i)), c.at(i));
+  }
+}
+
+TEST(test_batch, test_aos)
+{
+  std::vector< esl::vector3f > in(num_elements), out(num_elements);
+  const auto q = unit_quaternion(4, 3, 2, 1);
+
+  for (std::size_t i = 0; i < num_elements; ++i)
+    in[i] = esl::vector3f(float(i), 1, -float(i));
+
+  esl::batch::rotate(q, in.data(), out.data(), num_elements);
+
+  for (std::size_t i = 0; i < num_elements; ++i)
+    expect_near(q.rotate(in[i]), out[i]);
+
+  esl::batch::normalize(out.data(), num_elements);
+
+  for (std::size_t i = 0; i < num_elements; ++i)
+    ASSERT_NEAR(1.0f, out[i].norm(), 1e-5f);
+}
+
+TEST(test_batch, test_parallel)
+{
+  esl::thread_pool<> pool(4);
+  points in(6), out;
+  const auto q = unit_quaternion(1, -2, 3, -4);
+
+  // Small chunks to get many tasks
+  esl::batch::rotate(pool, q, in.view(), out.view(), 64);
+
+  for (std::size_t i = 0; i < num_elements; ++i)
+    expect_near(q.rotate(in.at(i)), out.at(i));
+
+  esl::batch::normalize(pool, out.view(), 100);
+
+  for (std::size_t i = 0; i < num_elements; ++i)
+    ASSERT_NEAR(1.0f, out.at(i).norm(), 1e-5f);
+
+  points b(7), c;
+  std::vector< float > d(num_elements);
+
+  esl::batch::dot(pool, in.view(), b.view(), d.data(), 100);
+  esl::batch::cross(pool, in.view(), b.view(), c.view(), 100);
+
+  for (std::size_t i = 0; i < num_elements; ++i)
+  {
+    ASSERT_NEAR(in.at(i).dot(b.at(i)).sum(), d[i], tolerance(d[i]));
+    expect_near(in.at(i).cross(b.at(i)), c.at(i));
+  }
+}
+
+struct quaternions
+{
+  std::vector< float > x, y, z, w;
+
+  quaternions() : x(num_elements), y(num_elements), z(num_elements),
+                  w(num_elements)
+  {
+  }
+
+  explicit quaternions(unsigned seed) : quaternions()
+  {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution< float > dist(-1.0f, 1.0f);
+
+    for (std::size_t i = 0; i < num_elements; ++i)
+      set(i, unit_quaternion(dist(gen), dist(gen), dist(gen), dist(gen)));
+  }
+
+  esl::batch::soa_view< float, 4 > view()
+  {
+    return {{{x.data(), y.data(), z.data(), w.data()}}, num_elements};
+  }
+
+  esl::quaternionf at(std::size_t i) const
+  {
+    return {w[i], x[i], y[i], z[i]};
+  }
+
+  void set(std::size_t i, const esl::quaternionf& q)
+  {
+    x[i] = q.x();
+    y[i] = q.y();
+    z[i] = q.z();
+    w[i] = q.w();
+  }
+};
+
+void expect_same_rotation(const esl::quaternionf& a,
+                          const esl::quaternionf& b, float tol = 1e-5f)
+{
+  // q and -q are the same rotation
+  const float sign = (a.dot(b).sum() < 0) ? -1.0f : 1.0f;
+
+  EXPECT_NEAR(a.w(), sign * b.w(), tol);
+  EXPECT_NEAR(a.x(), sign * b.x(), tol);
+  EXPECT_NEAR(a.y(), sign * b.y(), tol);
+  EXPECT_NEAR(a.z(), sign * b.z(), tol);
+}
+
+TEST(test_batch, test_integrate)
+{
+  quaternions q(7);
+  points omega(8);
+  const auto ref = q;
+  const float dt = 0.01f;
+
+  esl::batch::integrate< float >(q.view(), omega.view(), dt);
+
+  for (std::size_t i = 0; i < num_elements; ++i)
+  {
+    auto r = ref.at(i);
+    r.integrate(omega.at(i), dt);
+
+    expect_same_rotation(r, q.at(i));
+    ASSERT_NEAR(1.0f, q.at(i).norm(), 1e-5f);
+  }
+}
+
+TEST(test_batch, test_renormalize)
+{
+  quaternions q(9);
+
+  for (std::size_t i = 0; i < num_elements; ++i)
+  {
+    auto s = q.at(i);
+    s *= 1.0f + float(i % 7) * 1e-3f;
+    q.set(i, s);
+  }
+
+  esl::batch::renormalize(q.view());
+  esl::batch::renormalize(q.view());
+
+  for (std::size_t i = 0; i < num_elements; ++i)
+    ASSERT_NEAR(1.0f, q.at(i).norm(), 1e-6f);
+}
+
+TEST(test_batch, test_interpolation)
+{
+  quaternions q0(10), q1(11), n, s;
+
+  for (float t : {0.0f, 0.3f, 0.5f, 1.0f})
+  {
+    esl::batch::nlerp< float >(q0.view(), q1.view(), t, n.view());
+    esl::batch::slerp< float >(q0.view(), q1.view(), t, s.view());
+
+    for (std::size_t i = 0; i < num_elements; ++i)
+    {
+      expect_same_rotation(esl::nlerp(q0.at(i), q1.at(i), t), n.at(i));
+      expect_same_rotation(esl::slerp(q0.at(i), q1.at(i), t), s.at(i));
+    }
+  }
+}
+
+TEST(test_batch, test_rotation_matrix)
+{
+  quaternions q(12), out;
+
+  // Half turns around each axis and a diagonal, all Shepperd cases
+  const float h = std::sqrt(0.5f);
+  q.set(0, {1, 0, 0, 0});
+  q.set(1, {0, 1, 0, 0});
+  q.set(2, {0, 0, 1, 0});
+  q.set(3, {0, 0, 0, 1});
+  q.set(4, {0, h, -h, 0});
+
+  std::vector< std::vector< float > > m(9, std::vector< float >(num_elements));
+  esl::batch::soa_view< float, 9 > mv{
+      {{m[0].data(), m[1].data(), m[2].data(), m[3].data(), m[4].data(),
+        m[5].data(), m[6].data(), m[7].data(), m[8].data()}},
+      num_elements};
+
+  esl::batch::rotation_matrix< float >(q.view(), mv);
+  esl::batch::to_quaternion< float >(mv, out.view());
+
+  for (std::size_t i = 0; i < num_elements; ++i)
+  {
+    const auto ref = esl::rotation_matrix(q.at(i));
+
+    for (std::size_t j = 0; j < 9; ++j)
+      ASSERT_NEAR(ref(j / 3, j % 3), m[j][i], 1e-6f);
+
+    expect_same_rotation(q.at(i), out.at(i));
+    expect_same_rotation(esl::to_quaternion(ref), out.at(i));
+  }
+}
+
+TEST(test_batch, test_euler)
+{
+  quaternions q(13), out;
+  points angles;
+
+  esl::batch::to_euler< float >(q.view(), angles.view());
+  esl::batch::from_euler< float >(angles.view(), out.view());
+
+  for (std::size_t i = 0; i < num_elements; ++i)
+  {
+    expect_near(q.at(i).to_euler(), angles.at(i));
+    expect_same_rotation(q.at(i), out.at(i), 1e-4f);
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
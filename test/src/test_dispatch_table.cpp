@@ -0,0 +1,108 @@
+//          Copyright Emil Fresk 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <gtest/gtest.h>
+#include <esl/callable/dispatch_table.hpp>
+
+enum class message
+{
+  ping,
+  data,
+  reset,
+  unused,
+  count
+};
+
+int on_ping(int i)
+{
+  return i + 1;
+}
+
+int on_data(int i)
+{
+  return i * i;
+}
+
+int on_reset(int)
+{
+  return 0;
+}
+
+int on_unknown(int)
+{
+  return -1;
+}
+
+using table =
+    esl::dispatch_table< message, int(int),
+                         static_cast< std::size_t >(message::count) >;
+
+// Built at compile-time
+constexpr auto handlers =
+    table::make< on_unknown, table::handler< message::ping, on_ping >,
+                 table::handler< message::reset, on_reset >,
+                 table::handler< message::data, on_data > >();
+
+static_assert(handlers.get(message::ping) == on_ping, "");
+static_assert(handlers.get(message::unused) == on_unknown, "");
+
+TEST(test_dispatch_table, dispatch_test)
+{
+  ASSERT_EQ(6, handlers(message::ping, 5));
+  ASSERT_EQ(25, handlers(message::data, 5));
+  ASSERT_EQ(0, handlers(message::reset, 5));
+  ASSERT_EQ(-1, handlers(message::unused, 5));
+  ASSERT_EQ(4, handlers.size());
+}
+
+TEST(test_dispatch_table, out_of_range_test)
+{
+  ASSERT_EQ(-1, handlers(message::count, 5));
+  ASSERT_EQ(-1, handlers(static_cast< message >(100), 5));
+}
+
+TEST(test_dispatch_table, function_view_test)
+{
+  auto d = handlers[message::data];
+
+  ASSERT_EQ(true, d == esl::function_view< int(int) >::from(on_data));
+  ASSERT_EQ(9, d(3));
+}
+
+TEST(test_dispatch_table, subscript_test)
+{
+  using view = esl::function_view< int(int) >;
+
+  ASSERT_EQ(6, handlers[message::ping](5));
+  ASSERT_EQ(0, handlers[message::reset](5));
+
+  // Unmapped and out of range IDs give a view of the default handler
+  const auto unmapped = handlers[message::unused];
+  const auto out_of_range = handlers[static_cast< message >(100)];
+
+  ASSERT_EQ(true, unmapped == view::from(on_unknown));
+  ASSERT_EQ(true, out_of_range == view::from(on_unknown));
+  ASSERT_EQ(-1, unmapped(5));
+  ASSERT_EQ(-1, out_of_range(5));
+  ASSERT_EQ(-1, handlers[message::count](5));
+}
+
+TEST(test_dispatch_table, integer_key_test)
+{
+  using int_table = esl::dispatch_table< int, int(int), 8 >;
+
+  constexpr auto t =
+      int_table::make< on_unknown, int_table::handler< 7, on_data > >();
+
+  ASSERT_EQ(16, t(7, 4));
+  ASSERT_EQ(-1, t(0, 4));
+  ASSERT_EQ(-1, t(-1, 4));
+}
+
+int main(int argc, char *argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,262 @@
+//          Copyright Emil Fresk 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <cmath>
+#include <limits>
+#include <random>
+#include <gtest/gtest.h>
+#include <esl/math/fixed.hpp>
+#include <esl/math/matrix.hpp>
+#include <esl/math/quaternion.hpp>
+#include <esl/math/vector.hpp>
+
+using esl::q15;
+using esl::q16_16;
+
+// Value of the least significant bit
+constexpr double lsb = 1.0 / 65536.0;
+
+static double to_double(q16_16 x)
+{
+  return static_cast< double >(x);
+}
+
+TEST(test_fixed, test_conversions)
+{
+  static_assert(std::is_same< q16_16::storage_type, std::int32_t >::value,
+                "");
+  static_assert(std::is_same< q15::storage_type, std::int16_t >::value, "");
+  static_assert(std::is_same< esl::fixed< 4, 4 >::storage_type,
+                              std::int8_t >::value,
+                "");
+
+  ASSERT_EQ(0x18000, q16_16(1.5).raw());
+  ASSERT_EQ(-0x4000, q16_16(-0.25f).raw());
+  ASSERT_EQ(3 * 0x10000, q16_16(3).raw());
+  ASSERT_EQ(0, q16_16().raw());
+
+  ASSERT_EQ(1.5, static_cast< double >(q16_16(1.5)));
+  ASSERT_EQ(-0.25f, static_cast< float >(q16_16(-0.25)));
+  ASSERT_EQ(2, static_cast< int >(q16_16(2.75)));
+  ASSERT_EQ(-2, static_cast< int >(q16_16(-2.75)));
+
+  // Rounded to nearest
+  ASSERT_EQ(1, q16_16(0.6 * lsb).raw());
+  ASSERT_EQ(0, q16_16(0.4 * lsb).raw());
+  ASSERT_EQ(-1, q16_16(-0.6 * lsb).raw());
+
+  // Saturated
+  ASSERT_EQ(q16_16::max(), q16_16(40000));
+  ASSERT_EQ(q16_16::min(), q16_16(-40000));
+  ASSERT_EQ(q16_16::max(), q16_16(1e10));
+  ASSERT_EQ(q16_16::min(), q16_16(-1e10));
+  ASSERT_EQ(q16_16::max(), q16_16(std::uint64_t(1) << 40));
+  ASSERT_EQ(q15::max(), q15(1.0));
+  ASSERT_EQ(q15::min(), q15(-1.0));
+  ASSERT_EQ(q15::min(), q15(-1));
+  ASSERT_EQ(0, q16_16(std::numeric_limits< double >::quiet_NaN()).raw());
+}
+
+TEST(test_fixed, test_saturation)
+{
+  const auto eps = q16_16::epsilon();
+
+  ASSERT_EQ(q16_16::max(), q16_16::max() + eps);
+  ASSERT_EQ(q16_16::min(), q16_16::min() - eps);
+  ASSERT_EQ(q16_16::max(), -q16_16::min());
+  ASSERT_EQ(q16_16::max(), q16_16(300) * q16_16(300));
+  ASSERT_EQ(q16_16::min(), q16_16(-300) * q16_16(300));
+  ASSERT_EQ(q16_16::max(), q16_16(30000) / q16_16(0.5));
+
+  // Division by zero
+  ASSERT_EQ(q16_16::max(), q16_16(1) / q16_16(0));
+  ASSERT_EQ(q16_16::min(), q16_16(-1) / q16_16(0));
+  ASSERT_EQ(q16_16(0), q16_16(0) / q16_16(0));
+
+  ASSERT_EQ(q15::max(), esl::abs(q15::min()));
+}
+
+TEST(test_fixed, test_arithmetic)
+{
+  std::mt19937 gen(1234);
+  std::uniform_real_distribution< double > dist(-100.0, 100.0);
+
+  for (int i = 0; i < 10000; ++i)
+  {
+    const q16_16 a = dist(gen);
+    const q16_16 b = dist(gen);
+    const double da = to_double(a);
+    const double db = to_double(b);
+
+    ASSERT_EQ(da + db, to_double(a + b));
+    ASSERT_EQ(da - db, to_double(a - b));
+    ASSERT_LE(std::abs(da * db - to_double(a * b)), 0.5 * lsb);
+    ASSERT_LE(std::abs(da / db - to_double(a / b)), 0.5 * lsb);
+
+    ASSERT_EQ(da < db, a < b);
+    ASSERT_EQ(da <= db, a <= b);
+    ASSERT_EQ(da > db, a > b);
+    ASSERT_EQ(da >= db, a >= b);
+    ASSERT_EQ(da == db, a == b);
+    ASSERT_EQ(da != db, a != b);
+  }
+
+  // Mixed with integers and floating point through the implicit conversion
+  q16_16 x = 1.5;
+  x *= 2;
+  x += 0.25;
+  ASSERT_EQ(q16_16(3.25), x);
+  ASSERT_TRUE(x > 3);
+  ASSERT_EQ(q16_16(-3.25), -x);
+  ASSERT_EQ(q16_16(3.25), esl::abs(-x));
+}
+
+TEST(test_fixed, test_sqrt)
+{
+  ASSERT_EQ(0u, esl::details::isqrt(0));
+  ASSERT_EQ(1u, esl::details::isqrt(1));
+  ASSERT_EQ(1u, esl::details::isqrt(2));
+  ASSERT_EQ(2u, esl::details::isqrt(3));
+  ASSERT_EQ(12u, esl::details::isqrt(144));
+  ASSERT_EQ(0xffffffffu, esl::details::isqrt(0xfffffffe00000001u));
+  ASSERT_EQ(0x100000000u, esl::details::isqrt(0xffffffffffffffffu));
+
+  std::mt19937 gen(1234);
+  std::uniform_int_distribution< std::int32_t > dist(
+      1, std::numeric_limits< std::int32_t >::max());
+
+  for (int i = 0; i < 10000; ++i)
+  {
+    const auto x = q16_16::from_raw(dist(gen));
+    const double ref = std::sqrt(to_double(x));
+
+    ASSERT_LE(std::abs(ref - to_double(esl::sqrt(x))), 0.5 * lsb);
+  }
+
+  ASSERT_EQ(q16_16(4), esl::sqrt(q16_16(16)));
+  ASSERT_EQ(q16_16(0), esl::sqrt(q16_16(-4)));
+
+  // Rounds up to 1.0, which Q1.15 can not hold
+  ASSERT_EQ(q15::max(), esl::sqrt(q15::max()));
+}
+
+TEST(test_fixed, test_vector)
+{
+  using vector3q = esl::vector< q16_16, 3 >;
+
+  const vector3q v{3, 4, 12};
+  ASSERT_EQ(q16_16(169), v.norm_squared());
+  ASSERT_EQ(q16_16(13), v.norm());
+
+  std::mt19937 gen(1234);
+  std::uniform_real_distribution< float > dist(-10.0f, 10.0f);
+
+  for (int i = 0; i < 1000; ++i)
+  {
+    const esl::vector3f f{dist(gen), dist(gen), dist(gen)};
+    vector3q q{f[0], f[1], f[2]};
+
+    auto fn = f;
+    fn.normalize();
+    q.normalize();
+
+    for (std::size_t j = 0; j < 3; ++j)
+      EXPECT_NEAR(fn[j], static_cast< float >(q[j]), 1e-3f);
+
+    const auto c = (q + vector3q{1, 2, 3}).cross(vector3q{0, 0, 1});
+    const auto cf = (fn + esl::vector3f{1, 2, 3}).cross({0, 0, 1});
+
+    EXPECT_NEAR(cf[0], static_cast< float >(c[0]), 1e-3f);
+    EXPECT_NEAR(cf[1], static_cast< float >(c[1]), 1e-3f);
+  }
+}
+
+TEST(test_fixed, test_quaternion)
+{
+  std::mt19937 gen(1234);
+  std::uniform_real_distribution< double > dist(-1.0, 1.0);
+
+  for (int i = 0; i < 1000; ++i)
+  {
+    esl::quaterniond qd{dist(gen), dist(gen), dist(gen), dist(gen)};
+    qd.normalize();
+
+    esl::quaternion< q16_16 > qf{qd.w(), qd.x(), qd.y(), qd.z()};
+    qf.renormalize();
+
+    const esl::vector3d vd{10 * dist(gen), 10 * dist(gen), 10 * dist(gen)};
+    const esl::vector< q16_16, 3 > vf{vd[0], vd[1], vd[2]};
+
+    const auto rd = qd.rotate(vd);
+    const auto rf = qf.rotate(vf);
+
+    for (std::size_t j = 0; j < 3; ++j)
+      EXPECT_NEAR(rd[j], to_double(rf[j]), 2e-3);
+
+    const auto pd = qd * qd.conj();
+    const auto pf = qf * qf.conj();
+
+    EXPECT_NEAR(pd.w(), to_double(pf.w()), 1e-3);
+  }
+}
+
+TEST(test_fixed, test_matrix)
+{
+  using matrix3q = esl::matrix< q16_16, 3, 3 >;
+
+  const matrix3q a{4, 1, 0, 1, 3, 1, 0, 1, 2};
+  matrix3q inv, inv_spd;
+
+  ASSERT_TRUE(esl::inverse(a, inv));
+  ASSERT_TRUE(esl::inverse_spd(a, inv_spd));
+
+  const auto id = a * inv;
+  const auto id_spd = a * inv_spd;
+
+  for (std::size_t i = 0; i < 3; ++i)
+    for (std::size_t j = 0; j < 3; ++j)
+    {
+      EXPECT_NEAR(i == j ? 1.0 : 0.0, to_double(id(i, j)), 4 * lsb);
+      EXPECT_NEAR(i == j ? 1.0 : 0.0, to_double(id_spd(i, j)), 4 * lsb);
+    }
+
+  const auto v = a * esl::vector< q16_16, 3 >{1, -1, 0.5};
+  ASSERT_EQ(q16_16(3), v[0]);
+  ASSERT_EQ(q16_16(-1.5), v[1]);
+  ASSERT_EQ(q16_16(0), v[2]);
+}
+
+TEST(test_fixed, test_limits)
+{
+  using limits = std::numeric_limits< q16_16 >;
+
+  static_assert(limits::is_specialized, "");
+  static_assert(limits::is_signed, "");
+  static_assert(!limits::is_integer, "");
+  static_assert(limits::digits == 31, "");
+
+  ASSERT_EQ(q16_16::max(), limits::max());
+  ASSERT_EQ(q16_16::min(), limits::lowest());
+  ASSERT_EQ(1, limits::epsilon().raw());
+}
+
+TEST(test_fixed, test_constexpr)
+{
+  constexpr q16_16 a = 1.5;
+  constexpr q16_16 b = 2;
+
+  static_assert(a * b == q16_16(3), "");
+  static_assert(a / b == q16_16(0.75), "");
+  static_assert(a - b == q16_16(-0.5), "");
+  static_assert(esl::sqrt(q16_16(16)) == q16_16(4), "");
+  static_assert(esl::abs(q16_16(-2)) == b, "");
+  static_assert(static_cast< int >(a + b) == 3, "");
+}
+
+int main(int argc, char* argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -3,6 +3,8 @@
 //    (See accompanying file LICENSE.md or copy at
 //          http://www.boost.org/LICENSE_1_0.txt)
 
+#include <cstdint>
+#include <vector>
 #include <gtest/gtest.h>
 #include <esl/helpers/flag_enum.hpp>
 
@@ -14,6 +16,42 @@ enum class test_flags
   D
 };
 
+// Sized from the largest enumerator
+enum class sized_flags
+{
+  A,
+  B,
+  C,
+  D,
+  E
+};
+
+namespace esl
+{
+template <>
+struct flag_enum_max< sized_flags >
+    : std::integral_constant< sized_flags, sized_flags::E >
+{
+};
+}  // namespace esl
+
+enum class wide_flags : std::uint8_t
+{
+  A,
+  B = 10,
+  C = 70,
+  last = 99
+};
+
+namespace esl
+{
+template <>
+struct flag_enum_max< wide_flags >
+    : std::integral_constant< wide_flags, wide_flags::last >
+{
+};
+}  // namespace esl
+
 TEST(test_enum_flags, constructor_and_access_test)
 {
 #if defined(__GNUG__) && (__GNUC__ == 5)
@@ -108,6 +146,78 @@ TEST(test_enum_flags, all_test)
   ASSERT_EQ(false, f.all(test_flags::D));
 }
 
+TEST(test_enum_flags, storage_size_test)
+{
+  static_assert(sizeof(esl::flag_enum< test_flags >) == 4, "");
+  static_assert(sizeof(esl::flag_enum< sized_flags >) == 1, "");
+  static_assert(sizeof(esl::flag_enum< wide_flags >) == 16, "");
+}
+
+TEST(test_enum_flags, count_test)
+{
+  esl::flag_enum< sized_flags > f;
+
+  ASSERT_EQ(0u, f.count());
+
+  f.set(sized_flags::A, sized_flags::E);
+
+  ASSERT_EQ(2u, f.count());
+  ASSERT_TRUE(f.all(sized_flags::A, sized_flags::E));
+  ASSERT_FALSE(f.all(sized_flags::A, sized_flags::D));
+  ASSERT_TRUE(f.any(sized_flags::D, sized_flags::E));
+  ASSERT_FALSE(f.any(sized_flags::B, sized_flags::C, sized_flags::D));
+}
+
+TEST(test_enum_flags, iterator_test)
+{
+  esl::flag_enum< sized_flags > f;
+
+  ASSERT_TRUE(f.begin() == f.end());
+
+  f.set(sized_flags::E, sized_flags::B, sized_flags::C);
+
+  std::vector< sized_flags > v(f.begin(), f.end());
+
+  ASSERT_EQ((std::vector< sized_flags >{sized_flags::B, sized_flags::C,
+                                        sized_flags::E}),
+            v);
+}
+
+TEST(test_enum_flags, multi_word_test)
+{
+  esl::flag_enum< wide_flags > f;
+
+  f.set(wide_flags::A, wide_flags::C, wide_flags::last);
+
+  ASSERT_TRUE(f.all(wide_flags::A, wide_flags::C, wide_flags::last));
+  ASSERT_FALSE(f.any(wide_flags::B));
+
+  f.clear(wide_flags::C);
+
+  std::vector< wide_flags > v;
+
+  for (auto flag : f)
+    v.push_back(flag);
+
+  ASSERT_EQ((std::vector< wide_flags >{wide_flags::A, wide_flags::last}), v);
+}
+
+static constexpr esl::flag_enum< sized_flags > make_flags()
+{
+  esl::flag_enum< sized_flags > f;
+  f.set(sized_flags::A, sized_flags::C, sized_flags::D);
+  f.clear(sized_flags::C);
+  return f;
+}
+
+TEST(test_enum_flags, constexpr_test)
+{
+  static_assert(make_flags().all(sized_flags::A, sized_flags::D), "");
+  static_assert(!make_flags().any(sized_flags::B, sized_flags::C), "");
+  static_assert(make_flags().count() == 2, "");
+  static_assert(*make_flags().begin() == sized_flags::A, "");
+}
+
 int main(int argc, char *argv[])
 {
   ::testing::InitGoogleTest(&argc, argv);
@@ -3,8 +3,13 @@
 //    (See accompanying file LICENSE.md or copy at
 //          http://www.boost.org/LICENSE_1_0.txt)
 
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
 #include <gtest/gtest.h>
 #include <esl/callable/function.hpp>
+#include <esl/containers/allocate.hpp>
+#include <esl/containers/static_vector.hpp>
 
 struct bar
 {
@@ -150,6 +155,265 @@ TEST(test_function, copy_test)
   ASSERT_EQ(25, d2(5));
 }
 
+struct counted
+{
+  static int alive;
+  int value;
+
+  counted(int v) : value(v)
+  {
+    ++alive;
+  }
+
+  counted(const counted& other) : value(other.value)
+  {
+    ++alive;
+  }
+
+  counted(counted&& other) noexcept : value(other.value)
+  {
+    ++alive;
+  }
+
+  ~counted()
+  {
+    --alive;
+  }
+};
+
+int counted::alive = 0;
+
+TEST(test_function, non_trivial_copy_test)
+{
+  {
+    counted c{3};
+    auto d = callback([c](int i) { return i + c.value; });
+    auto d2 = callback(d);
+    auto d3 = callback(std::move(d2));
+
+    ASSERT_EQ(4, counted::alive);
+    ASSERT_EQ(8, d(5));
+    ASSERT_EQ(8, d3(5));
+
+    d = d3;
+
+    ASSERT_EQ(4, counted::alive);
+    ASSERT_EQ(8, d(5));
+  }
+
+  ASSERT_EQ(0, counted::alive);
+}
+
+using move_only_callback =
+    esl::move_only_function< int(int), 3 * sizeof(void*) >;
+
+TEST(test_function, move_only_test)
+{
+  static_assert(std::is_copy_constructible< callback >::value, "");
+  static_assert(std::is_copy_assignable< callback >::value, "");
+  static_assert(!std::is_copy_constructible< move_only_callback >::value, "");
+  static_assert(!std::is_copy_assignable< move_only_callback >::value, "");
+  static_assert(std::is_nothrow_move_constructible< move_only_callback >::value,
+                "");
+
+  auto p = std::make_unique< int >(10);
+  auto d = move_only_callback([p = std::move(p)](int i) { return i + *p; });
+
+  ASSERT_EQ(15, d(5));
+
+  auto d2 = move_only_callback(std::move(d));
+
+  ASSERT_EQ(15, d2(5));
+
+  auto d3 = move_only_callback([](int i) { return i; });
+  d3 = std::move(d2);
+
+  ASSERT_EQ(15, d3(5));
+
+  d3 = nullptr;
+
+  ASSERT_EQ(false, static_cast< bool >(d3));
+}
+
+TEST(test_function, static_vector_test)
+{
+  {
+    esl::allocate< esl::static_vector< callback >, 4 > vec;
+
+    counted c{1};
+    vec.emplace_back([c](int i) { return i + c.value; });
+    vec.emplace_back([](int i) { return i * 2; });
+    vec.emplace_back([c](int i) { return i - c.value; });
+
+    ASSERT_EQ(6, vec[0](5));
+    ASSERT_EQ(10, vec[1](5));
+    ASSERT_EQ(4, vec[2](5));
+
+    vec.erase(vec.begin());
+
+    ASSERT_EQ(2, vec.size());
+    ASSERT_EQ(10, vec[0](5));
+    ASSERT_EQ(4, vec[1](5));
+    ASSERT_EQ(2, counted::alive);
+  }
+
+  ASSERT_EQ(0, counted::alive);
+}
+
+// Not trivially copyable, but can be moved with a memcpy
+struct relocated
+{
+  static int moves;
+  counted c;
+
+  relocated(int v) : c(v)
+  {
+  }
+
+  relocated(const relocated&) = default;
+
+  relocated(relocated&& other) noexcept : c(std::move(other.c))
+  {
+    ++moves;
+  }
+
+  int operator()(int i) const
+  {
+    return i * c.value;
+  }
+};
+
+int relocated::moves = 0;
+
+namespace esl
+{
+template <>
+struct is_trivially_relocatable< relocated > : std::true_type
+{
+};
+}  // namespace esl
+
+TEST(test_function, relocatable_test)
+{
+  counted c{1};
+
+  ASSERT_EQ(true, is_relocatable(callback()));
+  ASSERT_EQ(true, is_relocatable(callback([](int i) { return i; })));
+  ASSERT_EQ(true, is_relocatable(callback(relocated{2})));
+  ASSERT_EQ(false,
+            is_relocatable(callback([c](int i) { return i + c.value; })));
+}
+
+TEST(test_function, static_vector_relocate_test)
+{
+  {
+    esl::allocate< esl::static_vector< callback >, 4 > vec;
+
+    counted c{1};
+    vec.emplace_back([](int i) { return i * 2; });
+    vec.emplace_back(relocated{3});
+    vec.emplace_back([c](int i) { return i - c.value; });
+    vec.emplace_back(relocated{4});
+
+    relocated::moves = 0;
+    vec.erase(vec.begin());
+
+    // The relocatable callables are moved down with a memcpy
+    ASSERT_EQ(0, relocated::moves);
+    ASSERT_EQ(3, vec.size());
+    ASSERT_EQ(15, vec[0](5));
+    ASSERT_EQ(4, vec[1](5));
+    ASSERT_EQ(20, vec[2](5));
+    ASSERT_EQ(4, counted::alive);
+  }
+
+  ASSERT_EQ(0, counted::alive);
+}
+
+struct throwing_copy
+{
+  int value;
+
+  throwing_copy(int v) : value(v)
+  {
+  }
+
+  throwing_copy(const throwing_copy&)
+  {
+    throw std::runtime_error("copy");
+  }
+
+  throwing_copy(throwing_copy&& other) noexcept : value(other.value)
+  {
+  }
+
+  int operator()(int i) const
+  {
+    return i + value;
+  }
+};
+
+TEST(test_function, throwing_copy_test)
+{
+  auto d = callback(throwing_copy{1});
+  auto d2 = callback([](int i) { return i * 2; });
+
+  EXPECT_ANY_THROW(d2 = d;);
+
+  // Left empty, not with the vtable of the callable that failed to copy
+  ASSERT_EQ(false, static_cast< bool >(d2));
+  ASSERT_EQ(0, d2(5));
+  ASSERT_EQ(6, d(5));
+}
+
+TEST(test_function, empty_test)
+{
+  callback d;
+  callback d2 = nullptr;
+
+  ASSERT_EQ(false, static_cast< bool >(d));
+  ASSERT_EQ(false, static_cast< bool >(d2));
+  ASSERT_EQ(0, d(5));
+  ASSERT_EQ(true, d == d2);
+
+  d = callback([](int i) { return i + 10; });
+
+  ASSERT_EQ(true, static_cast< bool >(d));
+  ASSERT_EQ(15, d(5));
+
+  d = nullptr;
+
+  ASSERT_EQ(false, static_cast< bool >(d));
+  ASSERT_EQ(0, d(5));
+
+  auto v = esl::function< void(int) >{};
+  v(1);
+}
+
+TEST(test_function, callback_table_test)
+{
+  esl::allocate< esl::static_vector< callback >, 4 > table;
+
+  table.resize(4);
+  table[2] = callback([](int i) { return i * 3; });
+
+  ASSERT_EQ(false, static_cast< bool >(table[0]));
+  ASSERT_EQ(true, static_cast< bool >(table[2]));
+
+  int sum = 0;
+  for (const auto& cb : table)
+    sum += cb(5);
+
+  ASSERT_EQ(15, sum);
+}
+
+TEST(test_function, size_test)
+{
+  // A single vtable pointer next to the storage
+  ASSERT_EQ(sizeof(void*) + 3 * sizeof(void*), sizeof(callback));
+  ASSERT_EQ(2 * sizeof(void*), sizeof(esl::function< void() >));
+}
+
 int main(int argc, char *argv[])
 {
   ::testing::InitGoogleTest(&argc, argv);
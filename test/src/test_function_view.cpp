@@ -24,6 +24,11 @@ int foo(int i)
   return i * i;
 }
 
+int cube(int i)
+{
+  return i * i * i;
+}
+
 using callback = esl::function_view< int(int) >;
 
 TEST(test_function_view, function_test)
@@ -125,8 +130,11 @@ TEST(test_function_view, comparison_test)
   ASSERT_EQ(false, d2 == d4);
   ASSERT_EQ(true, d2 != d4);
 
-  ASSERT_EQ(true, d3 == d4);
-  ASSERT_EQ(false, d3 != d4);
+  // A function bound as a template parameter is part of the caller, it does
+  // not compare equal to the same function bound at run time
+  ASSERT_EQ(false, d3 == d4);
+  ASSERT_EQ(true, d3 != d4);
+  ASSERT_EQ(true, d4 == callback::from(foo));
 
 }
 
@@ -183,6 +191,88 @@ TEST(test_function_view, assignment_test)
   test_assign(d1);
 }
 
+TEST(test_function_view, empty_test)
+{
+  callback d;
+  callback d2 = nullptr;
+
+  ASSERT_EQ(false, static_cast< bool >(d));
+  ASSERT_EQ(false, static_cast< bool >(d2));
+  ASSERT_EQ(0, d(5));
+  ASSERT_EQ(true, d == d2);
+
+  d = callback::from< foo >();
+
+  ASSERT_EQ(true, static_cast< bool >(d));
+  ASSERT_EQ(25, d(5));
+  ASSERT_EQ(false, d == d2);
+
+  auto v = esl::function_view< void(int) >{};
+  v(1);
+}
+
+TEST(test_function_view, deduction_macro_test)
+{
+  bar a;
+
+  auto d1 = ESL_FUNCTION_VIEW_FUNCTION(foo);
+  auto d2 = ESL_FUNCTION_VIEW_FUNCTION(&foo);
+  auto d3 = ESL_FUNCTION_VIEW_METHOD(&bar::foo, a);
+  auto d4 = ESL_FUNCTION_VIEW_METHOD(&bar::const_foo, a);
+
+  static_assert(std::is_same< decltype(d1), callback >::value, "");
+  static_assert(std::is_same< decltype(d3), callback >::value, "");
+
+  ASSERT_EQ(true, d1 == callback::from< foo >());
+  ASSERT_EQ(true, d2 == callback::from< foo >());
+  ASSERT_EQ(true, d3 == (callback::from< bar, &bar::foo >(a)));
+  ASSERT_EQ(true, d4 == (callback::from< bar, &bar::const_foo >(a)));
+
+  ASSERT_EQ(25, d1(5));
+  ASSERT_EQ(25, d2(5));
+  ASSERT_EQ(25, d3(5));
+  ASSERT_EQ(25, d4(5));
+}
+
+TEST(test_function_view, static_function_test)
+{
+  // The function is part of the caller, different functions do not compare
+  // equal and the same function does
+  auto d1 = callback::from< foo >();
+  auto d2 = callback::from< cube >();
+  auto d3 = ESL_FUNCTION_VIEW_FUNCTION(cube);
+
+  ASSERT_EQ(true, bool(d1));
+  ASSERT_EQ(false, d1 == d2);
+  ASSERT_EQ(true, d2 == d3);
+
+  ASSERT_EQ(25, d1(5));
+  ASSERT_EQ(125, d2(5));
+  ASSERT_EQ(8, d3(2));
+}
+
+#ifdef ESL_TEMPLATE_AUTO_AVAILABLE
+TEST(test_function_view, deduction_auto_test)
+{
+  bar a;
+
+  auto d1 = esl::make_function_view< foo >();
+  auto d2 = esl::make_function_view< &bar::foo >(a);
+  auto d3 = esl::make_function_view< &bar::const_foo >(a);
+
+  static_assert(std::is_same< decltype(d1), callback >::value, "");
+  static_assert(std::is_same< decltype(d2), callback >::value, "");
+
+  ASSERT_EQ(true, d1 == callback::from< foo >());
+  ASSERT_EQ(true, d2 == (callback::from< bar, &bar::foo >(a)));
+  ASSERT_EQ(true, d3 == (callback::from< bar, &bar::const_foo >(a)));
+
+  ASSERT_EQ(25, d1(5));
+  ASSERT_EQ(25, d2(5));
+  ASSERT_EQ(25, d3(5));
+}
+#endif
+
 int main(int argc, char *argv[])
 {
   ::testing::InitGoogleTest(&argc, argv);
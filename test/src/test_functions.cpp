@@ -0,0 +1,162 @@
+//          Copyright Emil Fresk 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <cmath>
+#include <limits>
+#include <random>
+#include <gtest/gtest.h>
+#include <esl/math/functions.hpp>
+#include <esl/math/matrix.hpp>
+
+// The constant evaluation path must give the same result as std::sqrt
+template < typename T >
+static void check_newton(T lo, T hi)
+{
+  std::mt19937 gen(1234);
+  std::uniform_real_distribution< T > mantissa(T(1), T(2));
+  std::uniform_int_distribution< int > exponent(
+      int(std::log2(lo)), int(std::log2(hi)));
+
+  for (int i = 0; i < 100000; ++i)
+  {
+    const T x = std::ldexp(mantissa(gen), exponent(gen));
+    ASSERT_EQ(std::sqrt(x), esl::details::sqrt_newton(x)) << x;
+  }
+}
+
+TEST(test_functions, test_sqrt_newton)
+{
+  check_newton< float >(std::numeric_limits< float >::min(),
+                        std::numeric_limits< float >::max() / 2);
+  check_newton< double >(std::numeric_limits< double >::min(),
+                         std::numeric_limits< double >::max() / 2);
+
+  ASSERT_EQ(std::sqrt(std::numeric_limits< float >::denorm_min()),
+            esl::details::sqrt_newton(
+                std::numeric_limits< float >::denorm_min()));
+  ASSERT_EQ(std::sqrt(std::numeric_limits< double >::max()),
+            esl::details::sqrt_newton(std::numeric_limits< double >::max()));
+}
+
+TEST(test_functions, test_runtime)
+{
+  ASSERT_EQ(std::sqrt(2.0), esl::sqrt(2.0));
+  ASSERT_EQ(std::sqrt(2.0f), esl::sqrt(2.0f));
+  ASSERT_EQ(std::sqrt(2), esl::sqrt(2));
+  ASSERT_TRUE(std::isnan(esl::sqrt(-1.0)));
+
+  ASSERT_EQ(1.5, esl::abs(-1.5));
+  ASSERT_EQ(1.5f, esl::abs(1.5f));
+  ASSERT_EQ(3, esl::abs(-3));
+  ASSERT_FALSE(std::signbit(esl::abs(-0.0)));
+}
+
+#if defined(ESL_IS_CONSTANT_EVALUATED_AVAILABLE)
+TEST(test_functions, test_constexpr)
+{
+  static_assert(esl::sqrt(4.0) == 2.0, "");
+  static_assert(esl::sqrt(2.0f) == 1.41421353816986083984375f, "");
+  static_assert(esl::sqrt(0.0) == 0.0, "");
+  static_assert(esl::sqrt(1e-300) == 1e-150, "");
+  static_assert(esl::sqrt(16) == 4.0, "");
+  static_assert(esl::sqrt(-1.0) != esl::sqrt(-1.0), "");  // NaN
+  static_assert(esl::sqrt(std::numeric_limits< double >::infinity()) ==
+                    std::numeric_limits< double >::infinity(),
+                "");
+
+  static_assert(esl::abs(-1.5) == 1.5, "");
+  static_assert(esl::abs(2.5f) == 2.5f, "");
+  static_assert(esl::abs(-3) == 3, "");
+
+  constexpr double s2 = esl::sqrt(2.0);
+  ASSERT_EQ(std::sqrt(2.0), s2);
+}
+
+#if !defined(ESL_CONSTEXPR_LAMBDA_AVAILABLE)
+TEST(test_functions, test_constexpr_vector)
+{
+  constexpr esl::vector3d v{3, 4, 12};
+  static_assert(v.norm() == 13.0, "");
+  static_assert(esl::vector3d{-1, 4, -9}.abs().sqrt()[2] == 3.0, "");
+
+  constexpr auto n = [] {
+    esl::vector3d u{3, 4, 12};
+    u.normalize();
+    return u;
+  }();
+
+  static_assert(n[1] == 4.0 / 13.0, "");
+}
+
+TEST(test_functions, test_constexpr_rotation)
+{
+  // A fixed mounting rotation, 90 degrees around z, baked in at compile time
+  constexpr auto q = [] {
+    esl::quaterniond r{1, 0, 0, 1};
+    r.normalize();
+    return r;
+  }();
+
+  constexpr auto m = esl::rotation_matrix(q);
+  constexpr auto p = esl::to_quaternion(m);
+  constexpr auto v = p.vec();
+
+  static_assert(p.w() == q.w(), "");
+  static_assert(v.z() == q.z(), "");
+  static_assert(v.x() == 0.0, "");
+
+  constexpr auto s = [] {
+    esl::quaterniond r;
+    r.set_vec({1, 2, 3});
+    return r;
+  }();
+
+  static_assert(s.vec().y() == 2.0, "");
+  static_assert(s.w() == 1.0, "");
+
+  constexpr auto r = m * esl::vector3d{1, 0, 0};
+  ASSERT_NEAR(0.0, r[0], 1e-15);
+  ASSERT_NEAR(1.0, r[1], 1e-15);
+
+  const auto rq = q.rotate(esl::vector3d{1, 0, 0});
+  ASSERT_EQ(rq[0], r[0]);
+  ASSERT_EQ(rq[1], r[1]);
+}
+
+TEST(test_functions, test_constexpr_inverse)
+{
+  // Calibration matrix and its inverse as constants
+  constexpr esl::matrix3d a{4, 1, 0, 1, 3, 1, 0, 1, 2};
+
+  constexpr auto inv = [](const esl::matrix3d& m) {
+    esl::matrix3d i;
+    esl::inverse(m, i);
+    return i;
+  }(a);
+
+  constexpr auto inv_spd = [](const esl::matrix3d& m) {
+    esl::matrix3d i;
+    esl::inverse_spd(m, i);
+    return i;
+  }(a);
+
+  const auto id = a * inv;
+  const auto id_spd = a * inv_spd;
+
+  for (std::size_t i = 0; i < 3; ++i)
+    for (std::size_t j = 0; j < 3; ++j)
+    {
+      EXPECT_NEAR(i == j ? 1.0 : 0.0, id(i, j), 1e-15);
+      EXPECT_NEAR(i == j ? 1.0 : 0.0, id_spd(i, j), 1e-15);
+    }
+}
+#endif
+#endif
+
+int main(int argc, char* argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,286 @@
+//          Copyright Emil Fresk 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <gtest/gtest.h>
+#include <esl/math/matrix.hpp>
+#include <cmath>
+
+template < typename T, std::size_t R, std::size_t C >
+static void expect_near(const esl::matrix< T, R, C >& a,
+                        const esl::matrix< T, R, C >& b, T tol)
+{
+  for (std::size_t i = 0; i < R; ++i)
+    for (std::size_t j = 0; j < C; ++j)
+      EXPECT_NEAR(a(i, j), b(i, j), tol) << "(" << i << ", " << j << ")";
+}
+
+// Symmetric positive definite test matrix, A = B B^T + N I
+template < std::size_t N >
+static esl::matrix< double, N, N > make_spd()
+{
+  esl::matrix< double, N, N > b;
+
+  for (std::size_t i = 0; i < N; ++i)
+    for (std::size_t j = 0; j < N; ++j)
+      b(i, j) = std::sin(double(i * N + j + 1));
+
+  return b * b.transpose() +
+         double(N) * esl::matrix< double, N, N >::identity();
+}
+
+TEST(test_matrix, test_make)
+{
+  esl::matrix< int, 2, 3 > m{1, 2, 3, 4, 5, 6};
+
+  ASSERT_EQ(2, m.rows());
+  ASSERT_EQ(3, m.cols());
+
+  ASSERT_EQ(1, m(0, 0));
+  ASSERT_EQ(3, m(0, 2));
+  ASSERT_EQ(4, m(1, 0));
+  ASSERT_EQ(6, m(1, 2));
+  ASSERT_EQ(6, m.data()[5]);
+
+  esl::matrix< int, 2, 3 > z;
+
+  for (std::size_t i = 0; i < 6; ++i)
+    ASSERT_EQ(0, z.data()[i]);
+
+  const auto id = esl::matrix3d::identity();
+
+  for (std::size_t i = 0; i < 3; ++i)
+    for (std::size_t j = 0; j < 3; ++j)
+      ASSERT_EQ(i == j ? 1.0 : 0.0, id(i, j));
+}
+
+TEST(test_matrix, test_rows_and_cols)
+{
+  esl::matrix< int, 2, 3 > m{1, 2, 3, 4, 5, 6};
+
+  const auto r = m.row(1);
+  ASSERT_EQ(4, r[0]);
+  ASSERT_EQ(5, r[1]);
+  ASSERT_EQ(6, r[2]);
+
+  const auto c = m.col(2);
+  ASSERT_EQ(3, c[0]);
+  ASSERT_EQ(6, c[1]);
+
+  const auto t = m.transpose();
+  ASSERT_EQ(3, t.rows());
+  ASSERT_EQ(2, t.cols());
+
+  for (std::size_t i = 0; i < 2; ++i)
+    for (std::size_t j = 0; j < 3; ++j)
+      ASSERT_EQ(m(i, j), t(j, i));
+
+  esl::matrix< int, 3, 3 > s{1, 2, 3, 4, 5, 6, 7, 8, 9};
+  ASSERT_EQ(15, s.trace());
+}
+
+TEST(test_matrix, test_arithmetic)
+{
+  esl::matrix< int, 2, 2 > a{1, 2, 3, 4};
+  esl::matrix< int, 2, 2 > b{5, 6, 7, 8};
+
+  const auto sum = a + b;
+  ASSERT_EQ(6, sum(0, 0));
+  ASSERT_EQ(12, sum(1, 1));
+
+  const auto diff = b - a;
+  ASSERT_EQ(4, diff(0, 1));
+  ASSERT_EQ(4, diff(1, 0));
+
+  const auto neg = -a;
+  ASSERT_EQ(-3, neg(1, 0));
+
+  const auto scaled = 2 * a * 3;
+  ASSERT_EQ(6, scaled(0, 0));
+  ASSERT_EQ(24, scaled(1, 1));
+
+  const auto div = scaled / 6;
+  ASSERT_EQ(4, div(1, 1));
+}
+
+TEST(test_matrix, test_multiply)
+{
+  esl::matrix< int, 2, 3 > a{1, 2, 3, 4, 5, 6};
+  esl::matrix< int, 3, 2 > b{7, 8, 9, 10, 11, 12};
+
+  const auto c = a * b;
+  ASSERT_EQ(2, c.rows());
+  ASSERT_EQ(2, c.cols());
+
+  ASSERT_EQ(58, c(0, 0));
+  ASSERT_EQ(64, c(0, 1));
+  ASSERT_EQ(139, c(1, 0));
+  ASSERT_EQ(154, c(1, 1));
+
+  const auto d = b * a;
+  ASSERT_EQ(3, d.rows());
+  ASSERT_EQ(3, d.cols());
+  ASSERT_EQ(39, d(0, 0));
+  ASSERT_EQ(105, d(2, 2));
+
+  const auto v = a * esl::vector< int, 3 >{1, 0, -1};
+  ASSERT_EQ(-2, v[0]);
+  ASSERT_EQ(-2, v[1]);
+
+  const auto id = esl::matrix< int, 3, 3 >::identity();
+  const auto e = a * id;
+
+  for (std::size_t i = 0; i < 2; ++i)
+    for (std::size_t j = 0; j < 3; ++j)
+      ASSERT_EQ(a(i, j), e(i, j));
+}
+
+TEST(test_matrix, test_cholesky)
+{
+  const auto a = make_spd< 6 >();
+  esl::matrix6d l;
+
+  ASSERT_TRUE(esl::cholesky(a, l));
+
+  for (std::size_t i = 0; i < 6; ++i)
+    for (std::size_t j = i + 1; j < 6; ++j)
+      ASSERT_EQ(0.0, l(i, j));
+
+  expect_near(a, l * l.transpose(), 1e-12);
+
+  // Not positive definite
+  esl::matrix2d b{1, 2, 2, 1};
+  esl::matrix2d lb;
+
+  ASSERT_FALSE(esl::cholesky(b, lb));
+}
+
+TEST(test_matrix, test_inverse_spd)
+{
+  const auto a = make_spd< 6 >();
+  esl::matrix6d inv;
+
+  ASSERT_TRUE(esl::inverse_spd(a, inv));
+  expect_near(esl::matrix6d::identity(), a * inv, 1e-12);
+  expect_near(inv, inv.transpose(), 0.0);
+
+  const auto a3 = make_spd< 3 >();
+  esl::matrix3d inv3;
+
+  ASSERT_TRUE(esl::inverse_spd(a3, inv3));
+  expect_near(esl::matrix3d::identity(), inv3 * a3, 1e-12);
+
+  esl::matrix2d b{-1, 0, 0, 1};
+  esl::matrix2d invb;
+
+  ASSERT_FALSE(esl::inverse_spd(b, invb));
+}
+
+TEST(test_matrix, test_inverse)
+{
+  // Needs pivoting, the first diagonal element is zero
+  esl::matrix3d a{0, 2, 1, 1, 1, 0, 3, 0, 1};
+  esl::matrix3d inv;
+
+  ASSERT_TRUE(esl::inverse(a, inv));
+  expect_near(esl::matrix3d::identity(), a * inv, 1e-12);
+  expect_near(esl::matrix3d::identity(), inv * a, 1e-12);
+
+  const auto a6 = make_spd< 6 >();
+  esl::matrix6d inv6, inv6_spd;
+
+  ASSERT_TRUE(esl::inverse(a6, inv6));
+  ASSERT_TRUE(esl::inverse_spd(a6, inv6_spd));
+  expect_near(inv6_spd, inv6, 1e-12);
+
+  esl::matrix2f f{4, 7, 2, 6};
+  esl::matrix2f invf;
+
+  ASSERT_TRUE(esl::inverse(f, invf));
+  expect_near(esl::matrix2f{0.6f, -0.7f, -0.2f, 0.4f}, invf, 1e-6f);
+
+  // Singular
+  esl::matrix3d s{1, 2, 3, 2, 4, 6, 1, 0, 1};
+  esl::matrix3d invs;
+
+  ASSERT_FALSE(esl::inverse(s, invs));
+}
+
+TEST(test_matrix, test_rotation_matrix)
+{
+  const auto s = std::sqrt(0.5);
+  const esl::quaterniond qs[] = {{1, 0, 0, 0},
+                                 {s, s, 0, 0},
+                                 {s, 0, s, 0},
+                                 {s, 0, 0, s},
+                                 {0.5, 0.5, -0.5, 0.5}};
+
+  const esl::vector3d vs[] = {{1, 0, 0}, {0, 1, 0}, {0, 0, 1}, {1, -2, 3}};
+
+  for (const auto& q : qs)
+  {
+    const auto m = esl::rotation_matrix(q);
+
+    for (const auto& v : vs)
+    {
+      const auto a = m * v;
+      const auto b = q.rotate(v);
+
+      EXPECT_NEAR(b[0], a[0], 1e-12);
+      EXPECT_NEAR(b[1], a[1], 1e-12);
+      EXPECT_NEAR(b[2], a[2], 1e-12);
+    }
+
+    // Orthonormal
+    expect_near(esl::matrix3d::identity(), m * m.transpose(), 1e-12);
+  }
+}
+
+TEST(test_matrix, test_to_quaternion)
+{
+  const double pi = std::acos(-1.0);
+  const double h = pi / std::sqrt(2.0);
+
+  // Including half turns, where each of the Shepperd cases is taken
+  const esl::vector3d rotations[] = {{0, 0, 0},
+                                     {0.1, -0.2, 0.3},
+                                     {pi, 0, 0},
+                                     {0, pi, 0},
+                                     {0, 0, pi},
+                                     {h, -h, 0},
+                                     {2, 1, -1.5},
+                                     {-0.5, 2.5, 0.1}};
+
+  for (const auto& r : rotations)
+  {
+    const auto q = esl::quaterniond::from_rotation_vector(r);
+    const auto p = esl::to_quaternion(esl::rotation_matrix(q));
+
+    // q and -q are the same rotation
+    const double sign = (q.dot(p).sum() < 0) ? -1 : 1;
+
+    EXPECT_NEAR(q.w(), sign * p.w(), 1e-12);
+    EXPECT_NEAR(q.x(), sign * p.x(), 1e-12);
+    EXPECT_NEAR(q.y(), sign * p.y(), 1e-12);
+    EXPECT_NEAR(q.z(), sign * p.z(), 1e-12);
+  }
+}
+
+#if !defined(ESL_CONSTEXPR_LAMBDA_AVAILABLE)
+TEST(test_matrix, test_constexpr)
+{
+  constexpr esl::matrix< int, 2, 2 > a{1, 2, 3, 4};
+  constexpr auto b = a * a.transpose() + esl::matrix< int, 2, 2 >::identity();
+
+  static_assert(b(0, 0) == 6, "");
+  static_assert(b(0, 1) == 11, "");
+  static_assert(b(1, 1) == 26, "");
+}
+#endif
+
+int main(int argc, char* argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
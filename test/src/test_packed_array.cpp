@@ -0,0 +1,156 @@
+//          Copyright Emil Fresk 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+#include <gtest/gtest.h>
+#include <esl/containers/packed_array.hpp>
+
+struct count_errors
+{
+  static int errors;
+
+  void operator()(const char*) const noexcept
+  {
+    ++errors;
+  }
+};
+
+int count_errors::errors = 0;
+
+// Random values against a plain array, every value is written twice so
+// neighbours are overwritten in both directions
+template < std::size_t Bits, std::size_t N >
+static void check_random()
+{
+  using array = esl::packed_array< Bits, N >;
+
+  auto a = std::make_unique< array >();
+  std::vector< std::uint64_t > ref(N);
+  std::mt19937_64 gen(Bits);
+
+  for (int pass = 0; pass < 2; ++pass)
+    for (std::size_t i = 0; i < N; ++i)
+    {
+      ref[i] = gen() & array::max_value;
+      a->set(i, ref[i]);
+    }
+
+  for (std::size_t i = 0; i < N; ++i)
+    ASSERT_EQ(ref[i], a->get(i)) << "Bits " << Bits << ", index " << i;
+
+  // Unpacking from every offset in a block, across whole blocks
+  std::vector< std::uint64_t > out(N);
+
+  for (std::size_t first = 0; first < 70 && first < N; ++first)
+  {
+    const auto count = N - first;
+
+    a->unpack(first, count, out.data());
+
+    for (std::size_t i = 0; i < count; ++i)
+      ASSERT_EQ(ref[first + i], out[i])
+          << "Bits " << Bits << ", first " << first << ", index " << i;
+  }
+}
+
+TEST(test_packed_array, random_test)
+{
+  check_random< 1, 300 >();
+  check_random< 3, 300 >();
+  check_random< 7, 129 >();
+  check_random< 10, 1000 >();
+  check_random< 13, 500 >();
+  check_random< 16, 200 >();
+  check_random< 31, 200 >();
+  check_random< 33, 200 >();
+  check_random< 63, 130 >();
+  check_random< 64, 130 >();
+}
+
+TEST(test_packed_array, size_test)
+{
+  using ids = esl::packed_array< 10, 1000 >;
+
+  static_assert(std::is_same< ids::value_type, std::uint16_t >::value, "");
+  static_assert(ids::max_value == 1023, "");
+  static_assert(ids::size() == 1000, "");
+
+  // 10000 bits and one word of padding
+  static_assert(ids::storage_size() == 1264, "");
+  static_assert(sizeof(ids) == ids::storage_size(), "");
+
+  static_assert(
+      std::is_same< esl::packed_array< 3, 5 >::value_type, std::uint8_t >::value,
+      "");
+  static_assert(std::is_same< esl::packed_array< 64, 5 >::value_type,
+                              std::uint64_t >::value,
+                "");
+}
+
+TEST(test_packed_array, unpack_convert_test)
+{
+  esl::packed_array< 5, 200 > a;
+
+  for (std::size_t i = 0; i < a.size(); ++i)
+    a.set(i, i % 32);
+
+  float out[130];
+  a.unpack(60, 130, out);
+
+  for (std::size_t i = 0; i < 130; ++i)
+    ASSERT_EQ(float((60 + i) % 32), out[i]);
+
+  a.clear();
+
+  for (std::size_t i = 0; i < a.size(); ++i)
+    ASSERT_EQ(0u, a[i]);
+}
+
+TEST(test_packed_array, error_test)
+{
+  esl::packed_array< 4, 10, count_errors > a;
+  int out[10];
+
+  count_errors::errors = 0;
+
+  a.set(10, 1);
+  a.set(3, 16);
+  a.set(3, 15);
+  ASSERT_EQ(0u, a.get(10));
+  a.unpack(5, 6, out);
+  a.unpack(11, 0, out);
+  a.unpack(10, 0, out);
+
+  ASSERT_EQ(5, count_errors::errors);
+  ASSERT_EQ(15u, a.get(3));
+  ASSERT_EQ(0u, a.get(2));
+  ASSERT_EQ(0u, a.get(4));
+}
+
+static constexpr esl::packed_array< 12, 20 > make_array()
+{
+  esl::packed_array< 12, 20 > r;
+
+  for (std::size_t i = 0; i < r.size(); ++i)
+    r.set(i, 4095 - i);
+
+  return r;
+}
+
+TEST(test_packed_array, constexpr_test)
+{
+  static_assert(make_array().get(0) == 4095, "");
+  static_assert(make_array().get(5) == 4090, "");
+  static_assert(make_array()[19] == 4076, "");
+}
+
+int main(int argc, char* argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,321 @@
+//          Copyright Emil Fresk 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+#include <gtest/gtest.h>
+#include <esl/math/batch.hpp>
+#include <esl/math/precision.hpp>
+#include <esl/math/vector.hpp>
+
+using esl::precision::compensated;
+using esl::precision::exact;
+using esl::precision::fast;
+using esl::precision::fast_fma;
+using esl::precision::wide;
+
+template < typename T >
+static T rel_error(T approx, T ref)
+{
+  return std::abs(approx - ref) / std::abs(ref);
+}
+
+// Arguments spread over most of the normal range, including both mantissa
+// halves around each power of two
+template < typename T >
+static std::vector< T > make_arguments()
+{
+  std::vector< T > args;
+
+  for (int e = -100; e <= 100; ++e)
+    for (T m : {T(1), T(1.0001), T(1.5), T(1.9999), T(2.5), T(3.9999)})
+      args.push_back(std::ldexp(m, e));
+
+  return args;
+}
+
+template < typename T, typename P >
+static void check_scalar_accuracy(T tol)
+{
+  for (const T x : make_arguments< T >())
+  {
+    const double ref = double(x);
+
+    EXPECT_LT(rel_error(double(P::rsqrt(x)), 1.0 / std::sqrt(ref)), tol) << x;
+    EXPECT_LT(rel_error(double(P::sqrt(x)), std::sqrt(ref)), tol) << x;
+    EXPECT_LT(rel_error(double(P::recip(x)), 1.0 / ref), tol) << x;
+  }
+
+  EXPECT_EQ(T(0), P::sqrt(T(0)));
+  EXPECT_EQ(T(7), P::fma(T(2), T(3), T(1)));
+}
+
+TEST(test_precision, test_exact)
+{
+  for (const float x : make_arguments< float >())
+  {
+    ASSERT_EQ(std::sqrt(x), exact::sqrt(x));
+    ASSERT_EQ(1.0f / std::sqrt(x), exact::rsqrt(x));
+    ASSERT_EQ(1.0f / x, exact::recip(x));
+  }
+}
+
+TEST(test_precision, test_scalar_float)
+{
+  check_scalar_accuracy< float, exact >(1e-6f);
+  check_scalar_accuracy< float, fast >(1e-6f);
+  check_scalar_accuracy< float, fast_fma >(1e-6f);
+}
+
+TEST(test_precision, test_scalar_double)
+{
+  check_scalar_accuracy< double, exact >(1e-15);
+  check_scalar_accuracy< double, fast >(1e-6);
+  check_scalar_accuracy< double, fast_fma >(1e-6);
+}
+
+// The bit level estimate used on targets without an estimate instruction
+TEST(test_precision, test_bit_estimate)
+{
+  using esl::simd::details::rsqrt_bits;
+
+  for (const float x : make_arguments< float >())
+  {
+    const auto y = rsqrt_bits< float, std::uint32_t, 0x5f375a86u, 3 >(x);
+    EXPECT_LT(rel_error(double(y), 1.0 / std::sqrt(double(x))), 1e-6) << x;
+  }
+
+  for (const double x : make_arguments< double >())
+  {
+    const auto y =
+        rsqrt_bits< double, std::uint64_t, 0x5fe6eb50c7b537a9u, 3 >(x);
+    EXPECT_LT(rel_error(y, 1.0 / std::sqrt(x)), 1e-6) << x;
+  }
+}
+
+template < typename T, typename R >
+static void check_register_rsqrt()
+{
+  for (const T x : make_arguments< T >())
+  {
+    T out[R::width];
+    R::store(out, fast::rsqrt(R{}, R::set1(x)));
+
+    for (std::size_t i = 0; i < R::width; ++i)
+      EXPECT_LT(rel_error(out[i], T(1) / std::sqrt(x)), T(1e-6)) << x;
+
+    R::store(out, exact::rsqrt(R{}, R::set1(x)));
+
+    for (std::size_t i = 0; i < R::width; ++i)
+      EXPECT_EQ(T(1) / std::sqrt(x), out[i]) << x;
+  }
+}
+
+TEST(test_precision, test_register_rsqrt)
+{
+  check_register_rsqrt< float, esl::simd::native< float > >();
+  check_register_rsqrt< double, esl::simd::native< double > >();
+  check_register_rsqrt< float, esl::simd::scalar< float > >();
+  check_register_rsqrt< double, esl::simd::scalar< double > >();
+}
+
+TEST(test_precision, test_vector_norm)
+{
+  std::mt19937 gen(1234);
+  std::uniform_real_distribution< float > dist(-100.0f, 100.0f);
+
+  for (int i = 0; i < 1000; ++i)
+  {
+    const esl::vector4f v{dist(gen), dist(gen), dist(gen), dist(gen)};
+    const float ref = v.norm();
+
+    EXPECT_EQ(ref, v.norm< exact >());
+    EXPECT_LT(rel_error(v.norm< fast >(), ref), 1e-6f);
+    EXPECT_LT(rel_error(v.norm< fast_fma >(), ref), 1e-6f);
+
+    auto a = v;
+    auto b = v;
+    a.normalize();
+    b.normalize< fast >();
+
+    EXPECT_LT(std::abs(b.norm() - 1.0f), 1e-6f);
+
+    for (std::size_t j = 0; j < 4; ++j)
+      EXPECT_NEAR(a[j], b[j], 1e-6f);
+  }
+
+  const esl::vector3d d{3, 4, 12};
+  EXPECT_NEAR(13.0, d.norm< fast >(), 13.0 * 1e-6);
+
+  // Expressions forward the policy
+  EXPECT_NEAR(13.0, (d + esl::vector3d{}).norm< fast >(), 13.0 * 1e-6);
+}
+
+TEST(test_precision, test_vector_zero)
+{
+  esl::vector3f z{0, 0, 0};
+
+  EXPECT_EQ(0.0f, z.norm< fast >());
+
+  z.normalize< fast >();
+
+  for (std::size_t i = 0; i < 3; ++i)
+    EXPECT_EQ(0.0f, z[i]);
+}
+
+TEST(test_precision, test_batch_normalize)
+{
+  // Odd size to exercise the scalar remainder
+  constexpr std::size_t n = 1003;
+  std::mt19937 gen(1234);
+  std::uniform_real_distribution< float > dist(-10.0f, 10.0f);
+  std::vector< float > x(n), y(n), z(n);
+
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    x[i] = dist(gen);
+    y[i] = dist(gen);
+    z[i] = dist(gen);
+  }
+
+  // The last element stays zero
+  x[n - 1] = y[n - 1] = z[n - 1] = 0.0f;
+
+  const auto ref_x = x, ref_y = y, ref_z = z;
+  esl::batch::soa_view< float, 3 > v{{{x.data(), y.data(), z.data()}}, n};
+
+  esl::batch::normalize< fast >(v);
+
+  for (std::size_t i = 0; i + 1 < n; ++i)
+  {
+    esl::vector3f r{ref_x[i], ref_y[i], ref_z[i]};
+    r.normalize();
+
+    EXPECT_NEAR(r[0], x[i], 1e-6f);
+    EXPECT_NEAR(r[1], y[i], 1e-6f);
+    EXPECT_NEAR(r[2], z[i], 1e-6f);
+  }
+
+  EXPECT_EQ(0.0f, x[n - 1]);
+  EXPECT_EQ(0.0f, y[n - 1]);
+  EXPECT_EQ(0.0f, z[n - 1]);
+}
+
+// A large term, small ones that are lost next to it in a plain sum, and the
+// large term again with the other sign
+template < typename T, std::size_t N >
+static esl::vector< T, N > make_cancellation(T large)
+{
+  esl::vector< T, N > v;
+
+  for (std::size_t i = 1; i + 1 < N; ++i)
+    v[i] = T(1);
+
+  v[0] = large;
+  v[N - 1] = -large;
+
+  return v;
+}
+
+TEST(test_precision, test_sum_accumulation)
+{
+  const auto f = make_cancellation< float, 64 >(1e8f);
+
+  EXPECT_EQ(0.0f, f.sum());
+  EXPECT_EQ(0.0f, f.sum< fast >());
+  EXPECT_EQ(62.0f, f.sum< wide<> >());
+  EXPECT_EQ(62.0f, f.sum< compensated<> >());
+  EXPECT_EQ(62.0f, f.sum< compensated< fast > >());
+
+  const auto d = make_cancellation< double, 64 >(1e17);
+
+  EXPECT_EQ(0.0, d.sum());
+  EXPECT_EQ(62.0, d.sum< compensated<> >());
+
+  // Only wider where long double has more digits than double
+  if (std::numeric_limits< long double >::digits >
+      std::numeric_limits< double >::digits)
+  {
+    EXPECT_EQ(62.0, d.sum< wide<> >());
+  }
+
+  // Expressions forward the policy
+  EXPECT_EQ(62.0f, (f + esl::vector< float, 64 >{}).sum< compensated<> >());
+
+  // Integers are not changed
+  EXPECT_EQ(6, (esl::vector< int, 3 >{1, 2, 3}.sum< compensated<> >()));
+}
+
+TEST(test_precision, test_norm_accumulation)
+{
+  std::mt19937 gen(1234);
+  std::uniform_real_distribution< float > dist(-1.0f, 1.0f);
+  std::uniform_int_distribution< int > exponent(-10, 10);
+
+  constexpr std::size_t n = 64;
+  float max_plain = 0, max_wide = 0, max_compensated = 0;
+
+  for (int i = 0; i < 1000; ++i)
+  {
+    esl::vector< float, n > v;
+    long double ref = 0;
+
+    for (std::size_t j = 0; j < n; ++j)
+    {
+      v[j] = std::ldexp(dist(gen), exponent(gen));
+      ref += static_cast< long double >(v[j]) * v[j];
+    }
+
+    const auto r = static_cast< float >(ref);
+
+    max_plain = std::max(max_plain, rel_error(v.norm_squared(), r));
+    max_wide =
+        std::max(max_wide, rel_error(v.norm_squared< wide<> >(), r));
+    max_compensated = std::max(
+        max_compensated, rel_error(v.norm_squared< compensated<> >(), r));
+
+    EXPECT_LT(rel_error(v.norm< compensated<> >(), std::sqrt(r)), 1e-7f);
+    EXPECT_LT(rel_error(v.norm< compensated< fast > >(), std::sqrt(r)),
+              1e-6f);
+  }
+
+  // The sum of squares has no cancellation, the wide and compensated sums
+  // are within rounding of the result
+  EXPECT_LE(max_wide, std::numeric_limits< float >::epsilon());
+  EXPECT_LE(max_compensated, std::numeric_limits< float >::epsilon());
+  EXPECT_LE(max_compensated, max_plain);
+}
+
+#if defined(ESL_IS_CONSTANT_EVALUATED_AVAILABLE)
+TEST(test_precision, test_constexpr)
+{
+  // Constant evaluation falls back to the exact results
+  constexpr float r = fast::recip(4.0f);
+  constexpr float f = fast_fma::fma(2.0f, 3.0f, 1.0f);
+
+  static_assert(r == 0.25f, "");
+  static_assert(f == 7.0f, "");
+
+#if !defined(ESL_CONSTEXPR_LAMBDA_AVAILABLE)
+  constexpr esl::vector4f v{1e8f, 1, 1, -1e8f};
+
+  static_assert(v.sum() == 0.0f, "");
+  static_assert(v.sum< compensated<> >() == 2.0f, "");
+  static_assert(v.sum< wide<> >() == 2.0f, "");
+  static_assert(
+      esl::vector4f{3, 4, 12, 0}.norm_squared< compensated<> >() == 169.0f,
+      "");
+#endif
+}
+#endif
+
+int main(int argc, char* argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
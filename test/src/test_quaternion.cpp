@@ -6,6 +6,9 @@
 #include <gtest/gtest.h>
 #include <esl/math/quaternion.hpp>
 #include <array>
+#include <cmath>
+#include <type_traits>
+#include <utility>
 
 TEST(test_quaternion, test_make)
 {
@@ -45,6 +48,47 @@ TEST(test_quaternion, test_access)
   ASSERT_EQ(0, v.z());
 }
 
+template < typename Q, typename = void >
+struct vec_assignable : std::false_type
+{
+};
+
+template < typename Q >
+struct vec_assignable<
+    Q, decltype(void(std::declval< Q& >().vec() = esl::vector3d{})) >
+    : std::true_type
+{
+};
+
+template < typename Q, typename = void >
+struct vec_add_assignable : std::false_type
+{
+};
+
+template < typename Q >
+struct vec_add_assignable<
+    Q, decltype(void(std::declval< Q& >().vec() += esl::vector3d{})) >
+    : std::true_type
+{
+};
+
+TEST(test_quaternion, test_vec_is_read_only)
+{
+  // vec() is a copy, writing to it would silently do nothing
+  static_assert(!vec_assignable< esl::quaterniond >::value,
+                "vec() must not be assignable, use set_vec()");
+  static_assert(!vec_add_assignable< esl::quaterniond >::value,
+                "vec() must not be assignable, use set_vec()");
+
+  esl::quaterniond q(1, 2, 3, 4);
+  q.set_vec(q.vec() + esl::vector3d{1, 1, 1});
+
+  ASSERT_EQ(1, q.w());
+  ASSERT_EQ(3, q.x());
+  ASSERT_EQ(4, q.y());
+  ASSERT_EQ(5, q.z());
+}
+
 TEST(test_quaternion, test_access_and_modify)
 {
   esl::quaterniond q;
@@ -169,6 +213,152 @@ void testconst(const esl::quaterniond& v)
   (void)v.vec();
 }
 
+static void expect_same_rotation(const esl::quaterniond& a,
+                                 const esl::quaterniond& b, double tol)
+{
+  // q and -q are the same rotation
+  const double sign = (a.dot(b).sum() < 0) ? -1 : 1;
+
+  EXPECT_NEAR(a.w(), sign * b.w(), tol);
+  EXPECT_NEAR(a.x(), sign * b.x(), tol);
+  EXPECT_NEAR(a.y(), sign * b.y(), tol);
+  EXPECT_NEAR(a.z(), sign * b.z(), tol);
+}
+
+static esl::quaterniond unit(double w, double x, double y, double z)
+{
+  esl::quaterniond q(w, x, y, z);
+  q.normalize();
+  return q;
+}
+
+TEST(test_quaternion, test_rotation_vector)
+{
+  const double pi = std::acos(-1.0);
+
+  // Quarter turn around z
+  const auto q = esl::quaterniond::from_rotation_vector({0, 0, pi / 2});
+  const auto v = q.rotate(esl::vector3d(1, 0, 0));
+
+  EXPECT_NEAR(0, v.x(), 1e-12);
+  EXPECT_NEAR(1, v.y(), 1e-12);
+  EXPECT_NEAR(0, v.z(), 1e-12);
+
+  // Zero and tiny rotations
+  expect_same_rotation(esl::quaterniond(),
+                       esl::quaterniond::from_rotation_vector({0, 0, 0}), 0);
+
+  const auto t = esl::quaterniond::from_rotation_vector({1e-6, -2e-6, 3e-6});
+  EXPECT_NEAR(1.0, t.norm(), 1e-15);
+  EXPECT_NEAR(0.5e-6, t.x(), 1e-18);
+  EXPECT_NEAR(1.5e-6, t.z(), 1e-18);
+}
+
+TEST(test_quaternion, test_integrate)
+{
+  const double pi = std::acos(-1.0);
+
+  // Constant rate around a fixed axis, one full turn in 1000 steps
+  const esl::vector3d axis(1 / std::sqrt(3.0), 1 / std::sqrt(3.0),
+                           -1 / std::sqrt(3.0));
+  const esl::vector3d omega = axis * (2 * pi);
+  esl::quaterniond q = unit(0.5, 0.1, -0.3, 0.8);
+  const auto q0 = q;
+
+  for (int i = 0; i < 1000; ++i)
+    q.integrate(omega, 1e-3);
+
+  EXPECT_NEAR(1.0, q.norm(), 1e-12);
+  expect_same_rotation(q0, q, 1e-9);
+
+  // Half the rate for one second is half a turn, body frame: q * exp(w t)
+  q = q0;
+
+  for (int i = 0; i < 1000; ++i)
+    q.integrate(omega * 0.5, 1e-3);
+
+  expect_same_rotation(q0 * esl::quaterniond::from_rotation_vector(axis * pi),
+                       q, 1e-9);
+}
+
+TEST(test_quaternion, test_renormalize)
+{
+  auto q = unit(1, 2, 3, 4);
+  q *= 1.001;
+
+  q.renormalize();
+  EXPECT_NEAR(1.0, q.norm(), 1e-5);
+
+  q.renormalize();
+  EXPECT_NEAR(1.0, q.norm(), 1e-11);
+
+  expect_same_rotation(unit(1, 2, 3, 4), q, 1e-11);
+}
+
+TEST(test_quaternion, test_euler)
+{
+  const double angles[][3] = {{0.1, 0.2, 0.3},
+                              {-1.0, 0.5, 2.5},
+                              {3.0, -1.2, -3.0},
+                              {0, 0, 0}};
+
+  for (const auto& a : angles)
+  {
+    const auto q = esl::quaterniond::from_euler(a[0], a[1], a[2]);
+
+    // R = Rz Ry Rx
+    const auto ref = esl::quaterniond::from_rotation_vector({0, 0, a[2]}) *
+                     esl::quaterniond::from_rotation_vector({0, a[1], 0}) *
+                     esl::quaterniond::from_rotation_vector({a[0], 0, 0});
+
+    expect_same_rotation(ref, q, 1e-12);
+
+    const auto e = q.to_euler();
+    EXPECT_NEAR(a[0], e[0], 1e-12);
+    EXPECT_NEAR(a[1], e[1], 1e-12);
+    EXPECT_NEAR(a[2], e[2], 1e-12);
+  }
+
+  // Gimbal lock, pitch is clamped to +-pi/2
+  const double pi = std::acos(-1.0);
+  const auto e = esl::quaterniond::from_euler(0, pi / 2, 0).to_euler();
+  EXPECT_NEAR(pi / 2, e[1], 1e-7);
+}
+
+TEST(test_quaternion, test_interpolation)
+{
+  const auto q0 = unit(1, 0.2, -0.1, 0.3);
+  const esl::vector3d axis(0, 0.6, 0.8);
+  const auto q1 = q0 * esl::quaterniond::from_rotation_vector(axis * 2.0);
+  const esl::quaterniond q1_neg(-q1.w(), -q1.x(), -q1.y(), -q1.z());
+
+  for (double t : {0.0, 0.25, 0.5, 0.9, 1.0})
+  {
+    const auto ref =
+        q0 * esl::quaterniond::from_rotation_vector(axis * 2.0 * t);
+
+    expect_same_rotation(ref, esl::slerp(q0, q1, t), 1e-12);
+
+    // Shortest path with the sign flipped representation
+    expect_same_rotation(ref, esl::slerp(q0, q1_neg, t), 1e-12);
+
+    const auto n = esl::nlerp(q0, q1, t);
+    EXPECT_NEAR(1.0, n.norm(), 1e-12);
+  }
+
+  // nlerp is exact at the ends and the middle
+  expect_same_rotation(q0, esl::nlerp(q0, q1, 0.0), 1e-12);
+  expect_same_rotation(q1, esl::nlerp(q0, q1, 1.0), 1e-12);
+  expect_same_rotation(
+      q0 * esl::quaterniond::from_rotation_vector(axis * 1.0),
+      esl::nlerp(q0, q1, 0.5), 1e-12);
+
+  // Nearly identical rotations
+  const auto q2 = q0 * esl::quaterniond::from_rotation_vector({1e-9, 0, 0});
+  const auto s = esl::slerp(q0, q2, 0.5);
+  EXPECT_NEAR(1.0, s.norm(), 1e-12);
+}
+
 TEST(test_vector, test_const)
 {
   esl::quaterniond q1(1, 2, 3, 4);
@@ -52,6 +52,34 @@ TEST(test_ring_buffer, test_push_back)
   EXPECT_ANY_THROW(buf.push_back(a););
 }
 
+// An array that ends exactly at the end of the storage wraps the head
+TEST(test_ring_buffer, test_push_back_array_wrap)
+{
+  esl::allocate< esl::ring_buffer< int, test_throw >, 8 > buf;
+  const int arr[] = {1, 2, 3, 4, 5};
+
+  buf.push_back(0);
+  buf.push_back(0);
+  buf.push_back(0);
+  buf.pop();
+  buf.pop();
+  buf.pop();
+
+  buf.push_back(arr);
+  buf.push_back(6);
+
+  ASSERT_EQ(6U, buf.size());
+  ASSERT_EQ(1, buf.front());
+
+  for (int i = 1; i <= 6; ++i)
+  {
+    ASSERT_EQ(i, buf.front());
+    buf.pop();
+  }
+
+  ASSERT_TRUE(buf.empty());
+}
+
 TEST(test_ring_buffer, test_emplace_back)
 {
   int i = 100;
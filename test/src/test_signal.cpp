@@ -0,0 +1,237 @@
+//          Copyright Emil Fresk 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <stdexcept>
+#include <gtest/gtest.h>
+#include <esl/containers/allocate.hpp>
+#include <esl/callable/signal.hpp>
+
+using test_signal = esl::signal< void(int) >;
+using slot = test_signal::function_type;
+
+int sum = 0;
+
+void add(int i)
+{
+  sum += i;
+}
+
+void add_twice(int i)
+{
+  sum += 2 * i;
+}
+
+struct bar
+{
+  int last = 0;
+
+  void foo(int i)
+  {
+    last = i;
+  }
+};
+
+TEST(test_signal, connect_test)
+{
+  esl::allocate< test_signal, 4 > sig;
+  bar b;
+
+  ASSERT_EQ(true, sig.empty());
+
+  auto c1 = sig.connect(slot::from< add >());
+  auto c2 = sig.connect(slot::from< bar, &bar::foo >(b));
+
+  ASSERT_EQ(true, static_cast< bool >(c1));
+  ASSERT_EQ(true, static_cast< bool >(c2));
+  ASSERT_EQ(true, c1 != c2);
+  ASSERT_EQ(2, sig.size());
+
+  sum = 0;
+  sig.emit(5);
+
+  ASSERT_EQ(5, sum);
+  ASSERT_EQ(5, b.last);
+
+  sig(7);
+
+  ASSERT_EQ(12, sum);
+  ASSERT_EQ(7, b.last);
+}
+
+TEST(test_signal, full_test)
+{
+  esl::allocate< test_signal, 2 > sig;
+
+  ASSERT_EQ(true, static_cast< bool >(sig.connect(slot::from< add >())));
+  ASSERT_EQ(true, static_cast< bool >(sig.connect(slot::from< add >())));
+  ASSERT_EQ(true, sig.full());
+  ASSERT_EQ(false, static_cast< bool >(sig.connect(slot::from< add >())));
+}
+
+TEST(test_signal, disconnect_test)
+{
+  esl::allocate< test_signal, 4 > sig;
+
+  auto c1 = sig.connect(slot::from< add >());
+  sig.connect(slot::from< add_twice >());
+
+  sum = 0;
+  sig.emit(1);
+
+  ASSERT_EQ(3, sum);
+
+  ASSERT_EQ(true, sig.disconnect(c1));
+  ASSERT_EQ(false, sig.disconnect(c1));
+  ASSERT_EQ(false, sig.disconnect(test_signal::connection{}));
+  ASSERT_EQ(1, sig.size());
+
+  sig.emit(1);
+
+  ASSERT_EQ(5, sum);
+
+  ASSERT_EQ(true, sig.disconnect(slot::from< add_twice >()));
+  ASSERT_EQ(true, sig.empty());
+
+  sig.emit(1);
+
+  ASSERT_EQ(5, sum);
+}
+
+TEST(test_signal, disconnect_form_test)
+{
+  esl::allocate< test_signal, 4 > sig;
+
+  sig.connect(slot::from< add >());
+  sig.connect(slot::from(add_twice));
+
+  // A function is only matched in the form it was connected with
+  ASSERT_EQ(false, sig.disconnect(slot::from(add)));
+  ASSERT_EQ(false, sig.disconnect(slot::from< add_twice >()));
+  ASSERT_EQ(2, sig.size());
+
+  ASSERT_EQ(true, sig.disconnect(slot::from< add >()));
+  ASSERT_EQ(true, sig.disconnect(slot::from(add_twice)));
+  ASSERT_EQ(true, sig.empty());
+}
+
+esl::allocate< test_signal, 4 > reentrant_sig;
+test_signal::connection self_con;
+
+void disconnect_self(int i)
+{
+  sum += i;
+  reentrant_sig.disconnect(self_con);
+  reentrant_sig.connect(slot::from< add_twice >());
+}
+
+TEST(test_signal, reentrancy_test)
+{
+  reentrant_sig.clear();
+
+  reentrant_sig.connect(slot::from< add >());
+  self_con = reentrant_sig.connect(slot::from< disconnect_self >());
+  reentrant_sig.connect(slot::from< add >());
+
+  sum = 0;
+  reentrant_sig.emit(1);
+
+  // The newly connected slot is not called in the same emission
+  ASSERT_EQ(3, sum);
+  ASSERT_EQ(3, reentrant_sig.size());
+
+  reentrant_sig.emit(1);
+
+  ASSERT_EQ(7, sum);
+}
+
+int times_three(int i)
+{
+  return 3 * i;
+}
+
+int times_four(int i)
+{
+  return 4 * i;
+}
+
+TEST(test_signal, collect_test)
+{
+  using ret_signal = esl::signal< int(int) >;
+  esl::allocate< ret_signal, 4 > sig;
+
+  sig.connect(ret_signal::function_type::from< times_three >());
+  sig.connect(ret_signal::function_type::from< times_four >());
+
+  int total = 0;
+  sig.emit_collect([&](int r) { total += r; }, 2);
+
+  ASSERT_EQ(14, total);
+}
+
+// Not default constructible, calling an empty slot would halt
+struct result
+{
+  int value;
+
+  explicit result(int v) : value(v)
+  {
+  }
+};
+
+using result_signal = esl::signal< result(int) >;
+
+esl::allocate< result_signal, 4 > result_sig;
+result_signal::connection later_con;
+int later_calls = 0;
+
+result disconnect_later(int i)
+{
+  result_sig.disconnect(later_con);
+  return result{i};
+}
+
+result later(int i)
+{
+  ++later_calls;
+  return result{i};
+}
+
+TEST(test_signal, disconnect_later_test)
+{
+  result_sig.connect(result_signal::function_type::from< disconnect_later >());
+  later_con = result_sig.connect(result_signal::function_type::from< later >());
+
+  // The disconnected slot is skipped in the same emission
+  result_sig.emit(1);
+
+  ASSERT_EQ(0, later_calls);
+  ASSERT_EQ(1, result_sig.size());
+}
+
+void throwing(int)
+{
+  throw std::runtime_error("slot");
+}
+
+TEST(test_signal, throwing_slot_test)
+{
+  esl::allocate< test_signal, 4 > sig;
+
+  sig.connect(slot::from< throwing >());
+  auto con = sig.connect(slot::from< add >());
+
+  EXPECT_ANY_THROW(sig.emit(1););
+
+  // The emission has ended, disconnecting removes the slot right away
+  sig.disconnect(con);
+
+  ASSERT_EQ(1, sig.size());
+}
+
+int main(int argc, char *argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -3,9 +3,69 @@
 //    (See accompanying file LICENSE.md or copy at
 //          http://www.boost.org/LICENSE_1_0.txt)
 
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
 #include <gtest/gtest.h>
 #include <esl/helpers/singleton.hpp>
 
+struct count_errors
+{
+  static int errors;
+
+  void operator()(const char*) const noexcept
+  {
+    ++errors;
+  }
+};
+
+int count_errors::errors = 0;
+
+// Counts constructions and destructions
+struct tracked
+{
+  static int alive;
+  static int constructed;
+
+  std::string name;
+
+  explicit tracked(std::string n) : name(std::move(n))
+  {
+    ++alive;
+    ++constructed;
+  }
+
+  ~tracked()
+  {
+    --alive;
+  }
+};
+
+int tracked::alive = 0;
+int tracked::constructed = 0;
+
+struct log_a
+{
+  std::vector< int >* log;
+
+  ~log_a()
+  {
+    log->push_back(1);
+  }
+};
+
+struct log_b
+{
+  std::vector< int >* log;
+
+  ~log_b()
+  {
+    log->push_back(2);
+  }
+};
+
 struct foo
 {
   int i;
@@ -35,6 +95,274 @@ TEST(test_singleton, access_test)
   ASSERT_EQ(101, s.i);
 }
 
+TEST(test_singleton, static_lifecycle_test)
+{
+  using s = esl::static_singleton< tracked >;
+
+  ASSERT_FALSE(s::initialized());
+
+  auto& t = s::init("first");
+
+  ASSERT_TRUE(s::initialized());
+  ASSERT_EQ(&t, &s::get());
+  ASSERT_EQ("first", s::get().name);
+  ASSERT_EQ(1, tracked::alive);
+
+  s::destroy();
+
+  ASSERT_FALSE(s::initialized());
+  ASSERT_EQ(0, tracked::alive);
+
+  // A new instance after destroy
+  s::init("second");
+
+  ASSERT_EQ("second", s::get().name);
+
+  s::destroy();
+
+  ASSERT_EQ(0, tracked::alive);
+}
+
+TEST(test_singleton, error_test)
+{
+  using s = esl::static_singleton< int, count_errors >;
+  using t = esl::thread_singleton< int, count_errors >;
+
+  count_errors::errors = 0;
+
+  s::get();
+  s::destroy();
+  s::init(1);
+  s::init(2);
+  t::get();
+  t::destroy();
+  t::init(1);
+  t::init(2);
+
+  ASSERT_EQ(6, count_errors::errors);
+
+  // The first init is kept
+  ASSERT_EQ(1, s::get());
+  ASSERT_EQ(1, t::get());
+
+  s::destroy();
+  t::destroy();
+
+  ASSERT_EQ(6, count_errors::errors);
+}
+
+// Threads racing to init, the instance is constructed once
+TEST(test_singleton, concurrent_init_test)
+{
+  using s = esl::static_singleton< tracked >;
+
+  tracked::constructed = 0;
+
+  std::atomic< int > wrong{0};
+  std::vector< std::thread > threads;
+
+  for (int i = 0; i < 4; ++i)
+    threads.emplace_back([&] {
+      if (s::init("shared").name != "shared")
+        ++wrong;
+    });
+
+  for (auto& th : threads)
+    th.join();
+
+  ASSERT_EQ(0, wrong.load());
+  ASSERT_EQ(1, tracked::constructed);
+
+  s::destroy();
+}
+
+// The construction waits for release
+struct gated
+{
+  static std::atomic< bool > started;
+  static std::atomic< bool > release;
+
+  gated()
+  {
+    started = true;
+
+    while (!release)
+      std::this_thread::yield();
+  }
+};
+
+std::atomic< bool > gated::started{false};
+std::atomic< bool > gated::release{false};
+
+// A caller waiting on a construction in progress is not an error, a caller
+// after the construction is
+TEST(test_singleton, concurrent_init_error_test)
+{
+  using s = esl::static_singleton< gated, count_errors >;
+
+  count_errors::errors = 0;
+
+  std::thread first([] { s::init(); });
+
+  while (!gated::started)
+    std::this_thread::yield();
+
+  std::atomic< bool > calling{false};
+
+  std::thread second([&] {
+    calling = true;
+    s::init();
+  });
+
+  // The second caller is about to call init() while the construction is
+  // held, whether it gets to wait on it or arrives after it completed can
+  // not be observed from here
+  while (!calling)
+    std::this_thread::yield();
+
+  gated::release = true;
+
+  first.join();
+  second.join();
+
+  ASSERT_LE(count_errors::errors, 1);
+
+  count_errors::errors = 0;
+
+  s::init();
+
+  ASSERT_EQ(1, count_errors::errors);
+
+  s::destroy();
+}
+
+// The first construction waits for release and throws
+struct flaky
+{
+  static std::atomic< int > attempts;
+  static std::atomic< bool > release;
+
+  flaky()
+  {
+    if (attempts++ == 0)
+    {
+      while (!release)
+        std::this_thread::yield();
+
+      throw std::runtime_error("flaky");
+    }
+  }
+};
+
+std::atomic< int > flaky::attempts{0};
+std::atomic< bool > flaky::release{false};
+
+struct may_throw
+{
+  int value;
+
+  explicit may_throw(int v) : value(v)
+  {
+    if (v < 0)
+      throw std::runtime_error("may_throw");
+  }
+};
+
+TEST(test_singleton, throwing_init_test)
+{
+  using s = esl::static_singleton< may_throw >;
+
+  // A throwing constructor leaves the singleton uninitialized
+  EXPECT_ANY_THROW(s::init(-1););
+  ASSERT_FALSE(s::initialized());
+
+  s::init(1);
+
+  ASSERT_EQ(1, s::get().value);
+
+  s::destroy();
+}
+
+// A thread waiting on a construction that throws constructs it instead
+TEST(test_singleton, concurrent_throwing_init_test)
+{
+  using s = esl::static_singleton< flaky >;
+
+  std::thread first([] { EXPECT_ANY_THROW(s::init();); });
+
+  while (flaky::attempts == 0)
+    std::this_thread::yield();
+
+  std::atomic< bool > calling{false};
+
+  std::thread second([&] {
+    calling = true;
+    s::init();
+  });
+
+  // Whether the second caller waits on the throwing construction or
+  // arrives after it, it ends up constructing the instance
+  while (!calling)
+    std::this_thread::yield();
+
+  flaky::release = true;
+
+  first.join();
+  second.join();
+
+  ASSERT_TRUE(s::initialized());
+  ASSERT_EQ(2, flaky::attempts.load());
+
+  s::destroy();
+}
+
+TEST(test_singleton, thread_instance_test)
+{
+  using s = esl::thread_singleton< int >;
+
+  s::init(1);
+
+  int other = 0;
+  bool other_initialized = true;
+
+  std::thread th([&] {
+    other_initialized = s::initialized();
+
+    s::init(2);
+    ++s::get();
+    other = s::get();
+    s::destroy();
+  });
+
+  th.join();
+
+  ASSERT_FALSE(other_initialized);
+  ASSERT_EQ(3, other);
+  ASSERT_EQ(1, s::get());
+
+  s::destroy();
+}
+
+TEST(test_singleton, scope_test)
+{
+  std::vector< int > log;
+
+  {
+    esl::singleton_scope< esl::static_singleton< log_a > > a(log_a{&log});
+    esl::singleton_scope< esl::static_singleton< log_b > > b(log_b{&log});
+
+    ASSERT_TRUE(esl::static_singleton< log_a >::initialized());
+    ASSERT_TRUE(esl::static_singleton< log_b >::initialized());
+
+    // The temporaries given to the constructors
+    log.clear();
+  }
+
+  // Reverse order of construction
+  ASSERT_EQ((std::vector< int >{2, 1}), log);
+  ASSERT_FALSE(esl::static_singleton< log_a >::initialized());
+}
+
 int main(int argc, char *argv[])
 {
   ::testing::InitGoogleTest(&argc, argv);
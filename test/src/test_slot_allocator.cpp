@@ -0,0 +1,233 @@
+//          Copyright Emil Fresk 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include <esl/containers/slot_allocator.hpp>
+
+struct count_errors
+{
+  static int errors;
+
+  void operator()(const char*) const noexcept
+  {
+    ++errors;
+  }
+};
+
+int count_errors::errors = 0;
+
+// All slots are handed out lowest first, then the pool is full
+template < typename Allocator >
+static void check_fill(Allocator& a)
+{
+  const auto n = a.capacity();
+
+  for (std::size_t i = 0; i < n; ++i)
+    ASSERT_EQ(i, a.allocate());
+
+  ASSERT_EQ(n, a.allocate());
+
+  // Freed slots are reused
+  a.free(n / 2);
+  a.free(n - 1);
+  a.free(0);
+
+  ASSERT_EQ(0u, a.allocate());
+  ASSERT_EQ(n / 2, a.allocate());
+  ASSERT_EQ(n - 1, a.allocate());
+  ASSERT_EQ(n, a.allocate());
+}
+
+TEST(test_slot_allocator, fill_test)
+{
+  // One level, at the word boundary, two levels and three levels
+  esl::slot_allocator< 5 > a5;
+  esl::slot_allocator< 64 > a64;
+  esl::slot_allocator< 65 > a65;
+  esl::slot_allocator< 4096 > a4096;
+  auto a5000 = std::make_unique< esl::slot_allocator< 5000 > >();
+
+  check_fill(a5);
+  check_fill(a64);
+  check_fill(a65);
+  check_fill(a4096);
+  check_fill(*a5000);
+
+  ASSERT_TRUE(a5000->full());
+  ASSERT_EQ(5000u, a5000->size());
+
+  a5000->reset();
+
+  ASSERT_TRUE(a5000->empty());
+  ASSERT_EQ(0u, a5000->allocate());
+}
+
+TEST(test_slot_allocator, atomic_fill_test)
+{
+  esl::atomic_slot_allocator< 5 > a5;
+  esl::atomic_slot_allocator< 64 > a64;
+  esl::atomic_slot_allocator< 65 > a65;
+  auto a5000 = std::make_unique< esl::atomic_slot_allocator< 5000 > >();
+
+  check_fill(a5);
+  check_fill(a64);
+  check_fill(a65);
+  check_fill(*a5000);
+}
+
+// Random allocations and frees against a plain list of the used slots
+TEST(test_slot_allocator, random_test)
+{
+  constexpr std::size_t n = 5000;
+  auto a = std::make_unique< esl::slot_allocator< n > >();
+  std::vector< bool > used(n);
+  std::vector< std::size_t > slots;
+  std::mt19937 gen(1234);
+
+  for (int i = 0; i < 20000; ++i)
+  {
+    if (slots.empty() || (gen() % 3 != 0 && slots.size() < n))
+    {
+      const auto s = a->allocate();
+
+      ASSERT_LT(s, n);
+      ASSERT_FALSE(used[s]);
+
+      // Always the lowest free slot
+      if (i % 16 == 0)
+      {
+        const auto lowest = std::find(used.begin(), used.end(), false);
+        ASSERT_EQ(std::size_t(lowest - used.begin()), s);
+      }
+
+      used[s] = true;
+      slots.push_back(s);
+    }
+    else
+    {
+      const auto k = gen() % slots.size();
+
+      a->free(slots[k]);
+      used[slots[k]] = false;
+      slots[k] = slots.back();
+      slots.pop_back();
+    }
+
+    ASSERT_EQ(slots.size(), a->size());
+  }
+
+  for (std::size_t i = 0; i < n; ++i)
+    ASSERT_EQ(bool(used[i]), a->is_allocated(i));
+}
+
+TEST(test_slot_allocator, error_test)
+{
+  esl::slot_allocator< 100, count_errors > a;
+  esl::atomic_slot_allocator< 100, count_errors > b;
+
+  count_errors::errors = 0;
+
+  a.free(3);
+  a.free(100);
+  b.free(3);
+  b.free(100);
+
+  ASSERT_EQ(4, count_errors::errors);
+  ASSERT_TRUE(a.empty());
+}
+
+static constexpr esl::slot_allocator< 200 > make_allocator()
+{
+  esl::slot_allocator< 200 > r;
+  r.allocate();
+  r.allocate();
+  r.free(0);
+  return r;
+}
+
+TEST(test_slot_allocator, constexpr_test)
+{
+  static_assert(make_allocator().size() == 1, "");
+  static_assert(make_allocator().is_allocated(1), "");
+  static_assert(!make_allocator().is_allocated(0), "");
+}
+
+// Threads allocate and free concurrently, no slot may be handed out twice
+TEST(test_slot_allocator, concurrent_test)
+{
+  constexpr std::size_t n = 1000;
+  constexpr int num_threads = 4;
+
+  auto a = std::make_unique< esl::atomic_slot_allocator< n > >();
+  std::unique_ptr< std::atomic< int >[] > owner(new std::atomic< int >[n]);
+  std::atomic< bool > failed{false};
+  std::vector< std::thread > threads;
+
+  for (std::size_t i = 0; i < n; ++i)
+    owner[i].store(-1);
+
+  for (int t = 0; t < num_threads; ++t)
+    threads.emplace_back([&, t] {
+      std::vector< std::size_t > mine;
+      std::mt19937 gen(t);
+
+      for (int i = 0; i < 20000; ++i)
+      {
+        if (mine.size() < 300 && (mine.empty() || gen() % 2 == 0))
+        {
+          const auto s = a->allocate();
+
+          if (s == n)
+            continue;
+
+          int expected = -1;
+
+          if (!owner[s].compare_exchange_strong(expected, t))
+            failed = true;
+
+          mine.push_back(s);
+        }
+        else
+        {
+          const auto k = gen() % mine.size();
+          const auto s = mine[k];
+
+          owner[s].store(-1);
+          a->free(s);
+          mine[k] = mine.back();
+          mine.pop_back();
+        }
+      }
+
+      for (auto s : mine)
+      {
+        owner[s].store(-1);
+        a->free(s);
+      }
+    });
+
+  for (auto& t : threads)
+    t.join();
+
+  ASSERT_FALSE(failed);
+
+  // Everything was returned, the pool fills completely again
+  for (std::size_t i = 0; i < n; ++i)
+    ASSERT_EQ(i, a->allocate());
+
+  ASSERT_EQ(n, a->allocate());
+}
+
+int main(int argc, char* argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,205 @@
+//          Copyright Emil Fresk 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+#include <gtest/gtest.h>
+#include <esl/math/span.hpp>
+#include <esl/parallel/thread_pool.hpp>
+
+using esl::precision::compensated;
+using esl::precision::fast;
+
+// Sizes around the register widths and the unrolled loop, and a long one
+static const std::size_t sizes[] = {0, 1, 3, 4, 7, 8, 15, 16, 31, 32, 33,
+                                    1003, 100000};
+
+template < typename T >
+static std::vector< T > make_data(std::size_t n, unsigned seed)
+{
+  std::mt19937 gen(seed);
+  std::uniform_real_distribution< double > dist(-1.0, 1.0);
+  std::vector< T > v(n);
+
+  for (auto& e : v)
+    e = static_cast< T >(dist(gen));
+
+  return v;
+}
+
+// Reference in long double, the error bound of a sum of n terms in T is
+// about n * epsilon times the sum of the magnitudes of the terms
+template < typename T >
+static void check_reductions()
+{
+  for (const auto n : sizes)
+  {
+    const auto a = make_data< T >(n, 1);
+    const auto b = make_data< T >(n, 2);
+
+    long double ref_sum = 0, ref_dot = 0, ref_sq = 0;
+
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      ref_sum += a[i];
+      ref_dot += static_cast< long double >(a[i]) * b[i];
+      ref_sq += static_cast< long double >(a[i]) * a[i];
+    }
+
+    // The sum of squares bounds the magnitudes of all three sums
+    const T tol = T(n + 1) * std::numeric_limits< T >::epsilon() *
+                  std::max(T(1), T(ref_sq));
+
+    EXPECT_NEAR(T(ref_sum), esl::span::sum(a.data(), n), tol) << n;
+    EXPECT_NEAR(T(ref_dot), esl::span::dot(a.data(), b.data(), n), tol) << n;
+    EXPECT_NEAR(T(ref_sq), esl::span::norm_squared(a.data(), n), tol) << n;
+    EXPECT_NEAR(std::sqrt(T(ref_sq)), esl::span::norm(a.data(), n), tol)
+        << n;
+
+    // Compensated accumulation is within rounding of the reference
+    const T eps = std::numeric_limits< T >::epsilon();
+
+    EXPECT_NEAR(T(ref_sum), esl::span::sum< compensated<> >(a.data(), n),
+                eps * std::abs(T(ref_sum)))
+        << n;
+    EXPECT_NEAR(T(ref_dot),
+                esl::span::dot< compensated<> >(a.data(), b.data(), n),
+                eps * std::abs(T(ref_dot)))
+        << n;
+  }
+}
+
+TEST(test_span, test_reductions)
+{
+  check_reductions< float >();
+  check_reductions< double >();
+}
+
+TEST(test_span, test_integers)
+{
+  std::vector< int > a(1003), b(1003);
+  int ref_sum = 0, ref_dot = 0;
+
+  for (int i = 0; i < 1003; ++i)
+  {
+    a[i] = i % 17 - 8;
+    b[i] = i % 5;
+    ref_sum += a[i];
+    ref_dot += a[i] * b[i];
+  }
+
+  EXPECT_EQ(ref_sum, esl::span::sum(a.data(), a.size()));
+  EXPECT_EQ(ref_dot, esl::span::dot(a.data(), b.data(), a.size()));
+
+  esl::span::axpy(2, b.data(), a.data(), a.size());
+  esl::span::scale(3, b.data(), b.size());
+
+  for (int i = 0; i < 1003; ++i)
+  {
+    ASSERT_EQ(i % 17 - 8 + 2 * (i % 5), a[i]);
+    ASSERT_EQ(3 * (i % 5), b[i]);
+  }
+}
+
+// Elementwise kernels give the same result as the plain loop
+TEST(test_span, test_axpy_scale)
+{
+  for (const auto n : sizes)
+  {
+    const auto x = make_data< float >(n, 1);
+    auto y = make_data< float >(n, 2);
+    auto ref = y;
+
+    esl::span::axpy(0.5f, x.data(), y.data(), n);
+
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      ref[i] += 0.5f * x[i];
+      ASSERT_EQ(ref[i], y[i]) << n << " " << i;
+    }
+
+    esl::span::scale(-3, y.data(), n);
+
+    for (std::size_t i = 0; i < n; ++i)
+      ASSERT_EQ(-3.0f * ref[i], y[i]) << n << " " << i;
+  }
+}
+
+// The same results as the fixed size vector
+TEST(test_span, test_vector)
+{
+  const esl::vector3d v{3, 4, 12};
+
+  EXPECT_EQ(v.sum(), esl::span::sum(v.data(), 3));
+  EXPECT_EQ(v.norm_squared(), esl::span::norm_squared(v.data(), 3));
+  EXPECT_EQ(v.norm(), esl::span::norm(v.data(), 3));
+  EXPECT_NEAR(v.norm< fast >(), esl::span::norm< fast >(v.data(), 3),
+              13.0 * 1e-6);
+
+  // The large terms cancel, plain sums lose the small ones
+  const esl::vector< float, 6 > c{1e8f, 1, 1, 1, 1, -1e8f};
+
+  EXPECT_EQ(c.sum< compensated<> >(),
+            esl::span::sum< compensated<> >(c.data(), 6));
+  EXPECT_EQ(4.0f, esl::span::sum< compensated<> >(c.data(), 6));
+}
+
+TEST(test_span, test_parallel)
+{
+  esl::thread_pool<> pool(4);
+  constexpr std::size_t n = 100003;
+
+  const auto a = make_data< double >(n, 1);
+  const auto b = make_data< double >(n, 2);
+
+  // Small chunks to get many tasks
+  const auto s = esl::span::sum(pool, a.data(), n, 1000);
+  const auto d = esl::span::dot(pool, a.data(), b.data(), n, 1000);
+
+  EXPECT_NEAR(esl::span::sum(a.data(), n), s, 1e-11);
+  EXPECT_NEAR(esl::span::dot(a.data(), b.data(), n), d, 1e-11);
+  EXPECT_NEAR(esl::span::norm(a.data(), n),
+              esl::span::norm(pool, a.data(), n, 1000), 1e-11);
+
+  // The chunk sums are added in chunk order, also past the partial sums
+  // kept per round (101 chunks)
+  double chunked = 0;
+
+  for (std::size_t offset = 0; offset < n; offset += 1000)
+    chunked += esl::span::sum(a.data() + offset, std::min< std::size_t >(
+                                                     1000, n - offset));
+
+  ASSERT_EQ(chunked, s);
+
+  // Independent of the scheduling
+  for (int i = 0; i < 10; ++i)
+  {
+    ASSERT_EQ(s, esl::span::sum(pool, a.data(), n, 1000));
+    ASSERT_EQ(d, esl::span::dot(pool, a.data(), b.data(), n, 1000));
+  }
+
+  auto y = b;
+  auto ref = b;
+
+  esl::span::axpy(pool, 2.0, a.data(), y.data(), n, 1000);
+  esl::span::scale(pool, 0.5, y.data(), n, 1000);
+
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    ref[i] = (ref[i] + 2.0 * a[i]) * 0.5;
+    ASSERT_EQ(ref[i], y[i]) << i;
+  }
+
+  EXPECT_EQ(0.0, esl::span::sum(pool, a.data(), 0));
+}
+
+int main(int argc, char* argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
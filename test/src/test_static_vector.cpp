@@ -170,6 +170,25 @@ TEST(test_static_vector, test_access)
   ASSERT_EQ(7, vec[4]);
 }
 
+TEST(test_static_vector, test_resize)
+{
+  esl::allocate< esl::static_vector< int, test_throw >, 5 > vec;
+
+  vec.push_back(3);
+  vec.resize(4);
+
+  ASSERT_EQ(4, vec.size());
+  ASSERT_EQ(3, vec[0]);
+  ASSERT_EQ(0, vec[3]);
+
+  vec.resize(1);
+
+  ASSERT_EQ(1, vec.size());
+  ASSERT_EQ(3, vec[0]);
+
+  EXPECT_ANY_THROW(vec.resize(6););
+}
+
 TEST(test_static_vector, test_access_and_modify)
 {
   esl::allocate< esl::static_vector< int, test_throw >, 5 > vec;
@@ -0,0 +1,62 @@
+//          Copyright Emil Fresk 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <memory>
+#include <type_traits>
+#include <gtest/gtest.h>
+#include <esl/callable/task.hpp>
+
+using test_task = esl::task<>;
+
+static_assert(!std::is_copy_constructible< test_task >::value, "");
+static_assert(std::is_nothrow_move_constructible< test_task >::value, "");
+
+TEST(test_task, run_test)
+{
+  int i = 0;
+  auto t = test_task([&i] { i += 10; });
+
+  ASSERT_EQ(true, static_cast< bool >(t));
+
+  t();
+  t();
+
+  ASSERT_EQ(20, i);
+}
+
+TEST(test_task, empty_test)
+{
+  test_task t;
+  test_task t2 = nullptr;
+
+  ASSERT_EQ(false, static_cast< bool >(t));
+  ASSERT_EQ(false, static_cast< bool >(t2));
+
+  t();
+}
+
+TEST(test_task, move_only_test)
+{
+  int i = 0;
+  auto p = std::make_unique< int >(5);
+  auto t = test_task([&i, p = std::move(p)] { i += *p; });
+
+  auto t2 = std::move(t);
+  t2();
+
+  ASSERT_EQ(5, i);
+
+  test_task t3;
+  t3 = std::move(t2);
+  t3();
+
+  ASSERT_EQ(10, i);
+}
+
+int main(int argc, char *argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,241 @@
+//          Copyright Emil Fresk 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <memory>
+#include <stdexcept>
+#include <gtest/gtest.h>
+#include <esl/callable/task.hpp>
+#include <esl/containers/allocate.hpp>
+#include <esl/containers/task_queue.hpp>
+
+struct test_throw
+{
+  void operator()(const char *msg) const
+  {
+    throw std::runtime_error(msg);
+  }
+};
+
+using test_task = esl::task<>;
+using queue = esl::task_queue< test_task, test_throw >;
+
+TEST(test_task_queue, test_construction_errors)
+{
+  EXPECT_ANY_THROW(queue q(nullptr, 8));
+
+  esl::allocate< esl::task_queue< test_task >, 4 > q;
+  (void)q;
+}
+
+TEST(test_task_queue, test_push_and_size)
+{
+  esl::allocate< queue, 4 > q;
+
+  ASSERT_EQ(true, q.empty());
+  ASSERT_EQ(3, q.capacity());
+
+  q.emplace_back([] {});
+  q.push_back(test_task([] {}));
+  q.emplace_back([] {});
+
+  ASSERT_EQ(3, q.size());
+  ASSERT_EQ(0, q.free());
+  ASSERT_EQ(true, q.full());
+
+  EXPECT_ANY_THROW(q.emplace_back([] {}););
+}
+
+TEST(test_task_queue, test_run_one)
+{
+  esl::allocate< queue, 4 > q;
+  int i = 0;
+
+  q.emplace_back([&i] { i = i * 10 + 1; });
+  q.emplace_back([&i] { i = i * 10 + 2; });
+
+  ASSERT_EQ(true, q.run_one());
+  ASSERT_EQ(1, i);
+  ASSERT_EQ(true, q.run_one());
+  ASSERT_EQ(12, i);
+  ASSERT_EQ(false, q.run_one());
+}
+
+TEST(test_task_queue, test_front_pop)
+{
+  esl::allocate< queue, 4 > q;
+  int i = 0;
+
+  EXPECT_ANY_THROW(q.front(););
+  EXPECT_ANY_THROW(q.pop(););
+
+  q.emplace_back([&i] { i += 1; });
+  q.emplace_back([&i] { i += 2; });
+
+  auto t = std::move(q.front());
+  q.pop();
+  t();
+
+  ASSERT_EQ(1, i);
+  ASSERT_EQ(1, q.size());
+
+  q.pop();
+
+  ASSERT_EQ(1, i);
+  ASSERT_EQ(true, q.empty());
+}
+
+TEST(test_task_queue, test_drain)
+{
+  esl::allocate< queue, 8 > q;
+  int i = 0;
+
+  // Wrap around the end of the buffer a few times
+  for (int round = 0; round < 5; ++round)
+  {
+    for (int j = 0; j < 5; ++j)
+      q.emplace_back([&i] { ++i; });
+
+    ASSERT_EQ(2, q.drain(2));
+    ASSERT_EQ(3, q.drain());
+    ASSERT_EQ(true, q.empty());
+  }
+
+  ASSERT_EQ(25, i);
+}
+
+esl::allocate< esl::task_queue< test_task >, 8 > reentrant_queue;
+
+TEST(test_task_queue, test_push_while_draining)
+{
+  int i = 0;
+
+  reentrant_queue.emplace_back([&i] {
+    ++i;
+    reentrant_queue.emplace_back([&i] { i += 10; });
+  });
+
+  ASSERT_EQ(1, reentrant_queue.drain());
+  ASSERT_EQ(1, i);
+  ASSERT_EQ(1, reentrant_queue.size());
+
+  ASSERT_EQ(1, reentrant_queue.drain());
+  ASSERT_EQ(11, i);
+}
+
+TEST(test_task_queue, test_nested_drain)
+{
+  int runs = 0;
+  int second = 0;
+  auto p = std::make_shared< int >(1);
+
+  // The task is popped before it runs, the nested drain runs the rest
+  reentrant_queue.emplace_back([&runs, p] {
+    ++runs;
+    reentrant_queue.drain();
+  });
+  reentrant_queue.emplace_back([&second] { ++second; });
+
+  ASSERT_EQ(1, reentrant_queue.drain());
+  ASSERT_EQ(1, runs);
+  ASSERT_EQ(1, second);
+  ASSERT_EQ(0, reentrant_queue.size());
+  ASSERT_EQ(1, p.use_count());
+
+  // A task running the queue itself
+  reentrant_queue.emplace_back([&runs] {
+    ++runs;
+    reentrant_queue.run_one();
+  });
+
+  ASSERT_EQ(true, reentrant_queue.run_one());
+  ASSERT_EQ(2, runs);
+  ASSERT_EQ(true, reentrant_queue.empty());
+}
+
+TEST(test_task_queue, test_throwing_task)
+{
+  auto p = std::make_shared< int >(1);
+  int i = 0;
+
+  esl::allocate< queue, 4 > q;
+
+  q.emplace_back([p] { throw std::runtime_error("task"); });
+  q.emplace_back([&i] { ++i; });
+
+  // The throwing task is popped and destroyed, the next one is left
+  EXPECT_ANY_THROW(q.run_one(););
+  ASSERT_EQ(1, q.size());
+  ASSERT_EQ(1, p.use_count());
+
+  ASSERT_EQ(true, q.run_one());
+  ASSERT_EQ(1, i);
+  ASSERT_EQ(true, q.empty());
+}
+
+// Copying the callable into the task throws
+struct throwing_copy
+{
+  throwing_copy() = default;
+  throwing_copy(throwing_copy&&) noexcept = default;
+
+  throwing_copy(const throwing_copy&)
+  {
+    throw std::runtime_error("copy");
+  }
+
+  void operator()() const
+  {
+  }
+};
+
+TEST(test_task_queue, test_throwing_construction)
+{
+  using noop_queue = esl::task_queue< test_task >;
+
+  esl::allocate< noop_queue, 4 > q;
+  const throwing_copy c{};
+
+  static_assert(noexcept(q.push_back(test_task{})), "");
+  static_assert(!noexcept(q.emplace_back(c)), "");
+
+  // Propagates instead of terminating, nothing is added
+  EXPECT_ANY_THROW(q.emplace_back(c););
+  ASSERT_EQ(true, q.empty());
+}
+
+TEST(test_task_queue, test_lifetime)
+{
+  auto p = std::make_shared< int >(1);
+
+  {
+    esl::allocate< queue, 4 > q;
+
+    q.emplace_back([p] {});
+    q.emplace_back([p] {});
+
+    ASSERT_EQ(3, p.use_count());
+
+    q.run_one();
+
+    ASSERT_EQ(2, p.use_count());
+  }
+
+  ASSERT_EQ(1, p.use_count());
+
+  {
+    esl::allocate< queue, 4 > q;
+
+    q.emplace_back([p] {});
+    q.clear();
+
+    ASSERT_EQ(1, p.use_count());
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,301 @@
+//          Copyright Emil Fresk 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include <esl/parallel/thread_pool.hpp>
+
+using pool = esl::thread_pool<>;
+
+TEST(test_thread_pool, test_submit)
+{
+  pool p(4);
+  std::atomic< int > count{0};
+
+  ASSERT_EQ(4, p.size());
+
+  for (int i = 0; i < 1000; ++i)
+    p.submit([&count] { ++count; });
+
+  p.wait_idle();
+
+  ASSERT_EQ(1000, count.load());
+}
+
+TEST(test_thread_pool, test_move_only_task)
+{
+  pool p(2);
+  std::atomic< int > count{0};
+  auto value = std::make_unique< int >(5);
+
+  p.submit([&count, v = std::move(value)] { count += *v; });
+  p.wait_idle();
+
+  ASSERT_EQ(5, count.load());
+}
+
+TEST(test_thread_pool, test_nested_submit)
+{
+  pool p(4);
+  std::atomic< int > count{0};
+
+  for (int i = 0; i < 100; ++i)
+  {
+    p.submit([&p, &count] {
+      for (int j = 0; j < 100; ++j)
+        p.submit([&count] { ++count; });
+    });
+  }
+
+  p.wait_idle();
+
+  ASSERT_EQ(10000, count.load());
+}
+
+TEST(test_thread_pool, test_small_capacity)
+{
+  // Full queues fall back to running the task inline
+  esl::thread_pool< esl::task<>, 4 > p(2);
+  std::atomic< int > count{0};
+
+  for (int i = 0; i < 1000; ++i)
+  {
+    p.submit([&p, &count] {
+      for (int j = 0; j < 10; ++j)
+        p.submit([&count] { ++count; });
+    });
+  }
+
+  p.wait_idle();
+
+  ASSERT_EQ(10000, count.load());
+}
+
+TEST(test_thread_pool, test_parallel_for)
+{
+  pool p(4, true);
+  std::vector< int > v(100000, 0);
+
+  p.parallel_for(0, v.size(), 64, [&v](std::size_t i) { v[i] = int(i) * 2; });
+
+  for (std::size_t i = 0; i < v.size(); ++i)
+    ASSERT_EQ(int(i) * 2, v[i]);
+
+  // Empty range
+  p.parallel_for(10, 10, 1, [&v](std::size_t i) { v[i] = -1; });
+  ASSERT_EQ(20, v[10]);
+}
+
+TEST(test_thread_pool, test_nested_parallel_for)
+{
+  pool p(4);
+  std::atomic< long > sum{0};
+
+  p.parallel_for(0, 16, 1, [&](std::size_t i) {
+    p.parallel_for(0, 100, 8, [&](std::size_t j) { sum += long(i * j); });
+  });
+
+  ASSERT_EQ(long(120 * 4950), sum.load());
+}
+
+TEST(test_thread_pool, test_destructor_runs_tasks)
+{
+  std::atomic< int > count{0};
+
+  {
+    pool p(2);
+
+    for (int i = 0; i < 100; ++i)
+      p.submit([&count] { ++count; });
+  }
+
+  ASSERT_EQ(100, count.load());
+}
+
+struct count_errors
+{
+  static std::atomic< int > errors;
+
+  void operator()(const char*) const noexcept
+  {
+    ++errors;
+  }
+};
+
+std::atomic< int > count_errors::errors{0};
+
+TEST(test_thread_pool, test_wait_idle_from_task)
+{
+  using checked_pool = esl::thread_pool< esl::task<>, 1024, count_errors >;
+
+  checked_pool p(2);
+  std::atomic< bool > done{false};
+
+  // Would wait for itself, reported and returns right away
+  p.submit([&p, &done] {
+    p.wait_idle();
+    done = true;
+  });
+
+  p.wait_idle();
+
+  ASSERT_EQ(true, done.load());
+  ASSERT_EQ(1, count_errors::errors.load());
+}
+
+TEST(test_thread_pool, test_nested_pool_in_task)
+{
+  pool p(2);
+  std::atomic< int > count{0};
+
+  p.submit([&count] {
+    pool nested(2);
+
+    for (int i = 0; i < 10; ++i)
+      nested.submit([&count] { ++count; });
+  });
+
+  p.wait_idle();
+
+  ASSERT_EQ(10, count.load());
+}
+
+TEST(test_thread_pool, test_throwing_task)
+{
+  pool p(2);
+  std::atomic< int > count{0};
+
+  p.submit([] { throw std::runtime_error("task"); });
+
+  for (int i = 0; i < 100; ++i)
+    p.submit([&count] { ++count; });
+
+  // Rethrown after all tasks are done, the thrown task is counted as done
+  EXPECT_THROW(p.wait_idle(), std::runtime_error);
+  ASSERT_EQ(100, count.load());
+
+  // Only rethrown once
+  p.wait_idle();
+}
+
+TEST(test_thread_pool, test_throwing_task_on_worker)
+{
+  pool p(2);
+  std::atomic< int > count{0};
+
+  // Thrown on a worker thread, kept for wait_idle instead of terminating
+  p.submit([&p, &count] {
+    for (int i = 0; i < 10; ++i)
+      p.submit([&count] {
+        ++count;
+        throw std::runtime_error("worker");
+      });
+  });
+
+  EXPECT_THROW(p.wait_idle(), std::runtime_error);
+  ASSERT_EQ(10, count.load());
+}
+
+TEST(test_thread_pool, test_throwing_inline_task_on_worker)
+{
+  esl::thread_pool< esl::task<>, 4 > p(1);
+
+  struct
+  {
+    std::atomic< int > count{0};
+    std::atomic< bool > escaped{false};
+    std::atomic< bool > done{false};
+  } state;
+
+  // The only worker fills its slots, the rest run inline in submit
+  p.submit([&p, &state] {
+    try
+    {
+      for (int i = 0; i < 16; ++i)
+        p.submit([&state] {
+          ++state.count;
+          throw std::runtime_error("inline");
+        });
+    }
+    catch (...)
+    {
+      state.escaped = true;
+    }
+
+    state.done = true;
+  });
+
+  while (!state.done)
+    std::this_thread::yield();
+
+  ASSERT_EQ(false, state.escaped.load());
+  EXPECT_THROW(p.wait_idle(), std::runtime_error);
+  ASSERT_EQ(16, state.count.load());
+}
+
+TEST(test_thread_pool, test_throwing_inline_task_injected)
+{
+  esl::thread_pool< esl::task<>, 4 > p(1);
+  std::atomic< int > count{0};
+  std::atomic< bool > started{false};
+  std::atomic< bool > release{false};
+
+  // Keep the only worker busy so the injection queue fills up
+  p.submit([&] {
+    started = true;
+
+    while (!release)
+      std::this_thread::yield();
+  });
+
+  while (!started)
+    std::this_thread::yield();
+
+  for (int i = 0; i < 16; ++i)
+    EXPECT_NO_THROW(p.submit([&count] {
+      ++count;
+      throw std::runtime_error("inline");
+    }));
+
+  release = true;
+
+  EXPECT_THROW(p.wait_idle(), std::runtime_error);
+  ASSERT_EQ(16, count.load());
+}
+
+TEST(test_thread_pool, test_parallel_for_throws)
+{
+  pool p(4);
+  std::atomic< long > sum{0};
+
+  // Throws in the caller's part and in stolen subranges, parallel_for must
+  // wait for all handed out subranges before rethrowing
+  EXPECT_THROW(p.parallel_for(0, 10000, 16,
+                              [&](std::size_t i) {
+                                if (i % 1000 == 0)
+                                  throw std::runtime_error("range");
+
+                                sum += 1;
+                              }),
+               std::runtime_error);
+
+  p.wait_idle();
+
+  // The pool is still usable
+  sum = 0;
+  p.parallel_for(0, 1000, 16, [&](std::size_t) { sum += 1; });
+
+  ASSERT_EQ(1000, sum.load());
+}
+
+int main(int argc, char *argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -100,6 +100,141 @@ TEST(test_unsafe_flag, none_test)
   ASSERT_EQ(false, f.none());
 }
 
+// Sizes at and around the word boundaries
+template < std::size_t N >
+static void check_set_all()
+{
+  esl::unsafe_flag< N > f;
+
+  f.set();
+
+  ASSERT_TRUE(f.all());
+  ASSERT_EQ(N, f.count());
+
+  f.reset(N - 1);
+
+  ASSERT_FALSE(f.all());
+  ASSERT_EQ(N - 1, f.count());
+
+  f.flip();
+
+  ASSERT_EQ(1u, f.count());
+  ASSERT_EQ(N - 1, f.find_first());
+}
+
+TEST(test_unsafe_flag, word_boundaries)
+{
+  check_set_all< 1 >();
+  check_set_all< 32 >();
+  check_set_all< 63 >();
+  check_set_all< 64 >();
+  check_set_all< 65 >();
+  check_set_all< 128 >();
+  check_set_all< 4000 >();
+}
+
+TEST(test_unsafe_flag, count_test)
+{
+  esl::unsafe_flag< 200 > f;
+
+  ASSERT_EQ(0u, f.count());
+  ASSERT_FALSE(f.any());
+
+  f.set(0);
+  f.set(63);
+  f.set(64);
+  f.set(199);
+
+  ASSERT_EQ(4u, f.count());
+  ASSERT_TRUE(f.any());
+  ASSERT_EQ(200u, f.size());
+}
+
+TEST(test_unsafe_flag, find_test)
+{
+  esl::unsafe_flag< 300 > f;
+
+  ASSERT_EQ(300u, f.find_first());
+  ASSERT_EQ(300u, f.find_next(0));
+
+  const std::size_t idx[] = {3, 63, 64, 130, 299};
+
+  for (auto i : idx)
+    f.set(i);
+
+  ASSERT_EQ(3u, f.find_first());
+
+  // Iterates over the set flags
+  std::size_t n = 0;
+
+  for (auto i = f.find_first(); i < f.size(); i = f.find_next(i))
+    ASSERT_EQ(idx[n++], i);
+
+  ASSERT_EQ(5u, n);
+  ASSERT_EQ(63u, f.find_next(3));
+  ASSERT_EQ(130u, f.find_next(64));
+  ASSERT_EQ(130u, f.find_next(100));
+  ASSERT_EQ(300u, f.find_next(299));
+  ASSERT_EQ(300u, f.find_next(1000));
+}
+
+TEST(test_unsafe_flag, bitwise_test)
+{
+  esl::unsafe_flag< 100 > a, b;
+
+  a.set(1);
+  a.set(70);
+  b.set(70);
+  b.set(99);
+
+  const auto o = a | b;
+  const auto x = a ^ b;
+  const auto n = a & b;
+
+  ASSERT_EQ(3u, o.count());
+  ASSERT_TRUE(o[1] && o[70] && o[99]);
+  ASSERT_EQ(2u, x.count());
+  ASSERT_TRUE(x[1] && x[99]);
+  ASSERT_EQ(1u, n.count());
+  ASSERT_TRUE(n[70]);
+
+  // The complement does not set the bits past the size
+  const auto c = ~a;
+
+  ASSERT_EQ(98u, c.count());
+  ASSERT_FALSE(c[1]);
+  ASSERT_TRUE(c[0]);
+  ASSERT_TRUE((c | a).all());
+  ASSERT_TRUE((c & a).none());
+
+  ASSERT_TRUE(a == a);
+  ASSERT_TRUE(a != b);
+  ASSERT_TRUE((a ^ a) == (esl::unsafe_flag< 100 >{}));
+
+  a &= b;
+  ASSERT_TRUE(a == n);
+  a |= x;
+  ASSERT_TRUE(a == o);
+  a ^= b;
+  ASSERT_EQ(1u, a.count());
+}
+
+static constexpr esl::unsafe_flag< 130 > make_flags()
+{
+  esl::unsafe_flag< 130 > r;
+  r.set(5);
+  r.set(129);
+  return r;
+}
+
+TEST(test_unsafe_flag, constexpr_test)
+{
+  static_assert(make_flags().count() == 2, "");
+  static_assert(make_flags().find_first() == 5, "");
+  static_assert(make_flags().find_next(5) == 129, "");
+  static_assert((~make_flags()).count() == 128, "");
+  static_assert(make_flags() != esl::unsafe_flag< 130 >{}, "");
+}
 
 int main(int argc, char *argv[])
 {
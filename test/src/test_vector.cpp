@@ -328,6 +328,77 @@ TEST(test_vector, test_vector_math_operators)
   ASSERT_EQ(0, v5[2]);
 }
 
+esl::vector3i make_vector(int i)
+{
+  return {i, 2 * i, 3 * i};
+}
+
+TEST(test_vector, test_expression)
+{
+  using vector12d = esl::vector< double, 12 >;
+
+  vector12d a, b, c;
+
+  for (int i = 0; i < 12; ++i)
+  {
+    a[i] = i;
+    b[i] = 2 * i + 1;
+    c[i] = 0.5 * i;
+  }
+
+  auto e = a + b * 2.0 - c / 2.0 + (-a);
+
+  // Lazy until assigned
+  static_assert(!std::is_same< decltype(e), vector12d >::value, "");
+
+  vector12d r = e;
+
+  for (int i = 0; i < 12; ++i)
+  {
+    const double expected = a[i] + b[i] * 2.0 - c[i] / 2.0 - a[i];
+    ASSERT_DOUBLE_EQ(expected, r[i]);
+    ASSERT_DOUBLE_EQ(expected, e[i]);
+  }
+
+  ASSERT_DOUBLE_EQ(r.norm(), e.norm());
+  ASSERT_DOUBLE_EQ(r.sum(), e.eval().sum());
+}
+
+TEST(test_vector, test_expression_aliasing)
+{
+  esl::vector3i a{1, 2, 3};
+  esl::vector3i b{4, 5, 6};
+
+  a = a + b * 2;
+
+  ASSERT_EQ(9, a[0]);
+  ASSERT_EQ(12, a[1]);
+  ASSERT_EQ(15, a[2]);
+
+  a -= b - a;
+
+  ASSERT_EQ(14, a[0]);
+  ASSERT_EQ(19, a[1]);
+  ASSERT_EQ(24, a[2]);
+}
+
+TEST(test_vector, test_expression_temporaries)
+{
+  esl::vector3i a{1, 1, 1};
+
+  // Temporaries are held by value, so the expression outlives them
+  auto e = make_vector(1) + a * 2 + make_vector(2);
+  esl::vector3i r = e;
+
+  ASSERT_EQ(5, r[0]);
+  ASSERT_EQ(8, r[1]);
+  ASSERT_EQ(11, r[2]);
+
+  // Expressions convert where a vector is expected
+  ASSERT_EQ(-21, (a - e).dot(a).sum());
+  ASSERT_EQ(0, (a + a).cross(a * 2).norm_squared());
+}
+
 void testfun(const esl::vector3i& v)
 {
   (void)v.data();
@@ -0,0 +1,250 @@
+//          Copyright Emil Fresk 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#define ESL_ENABLE_SIMD
+
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <gtest/gtest.h>
+#include <esl/math/vector.hpp>
+
+template < typename T, std::size_t N >
+esl::vector< T, N > make(T offset)
+{
+  esl::vector< T, N > v;
+
+  for (std::size_t i = 0; i < N; ++i)
+    v[int(i)] = offset + T(i) * T(0.5);
+
+  return v;
+}
+
+// The references are computed with plain scalar loops, never with the kernels
+template < typename T, std::size_t N >
+void check_ops()
+{
+  const auto a = make< T, N >(T(1));
+  const auto b = make< T, N >(T(-2));
+
+  T ref_sum[N], ref_diff[N], ref_prod[N], ref_scaled[N], ref_nested[N];
+  T ref_dot = 0, ref_norm2 = 0;
+
+  for (int i = 0; i < int(N); ++i)
+  {
+    ref_sum[i] = a[i] + b[i];
+    ref_diff[i] = a[i] - b[i];
+    ref_prod[i] = a[i] * b[i];
+    ref_scaled[i] = a[i] * T(3);
+    ref_nested[i] = (a[i] + b[i]) * T(3);
+    ref_dot += a[i] * b[i];
+    ref_norm2 += a[i] * a[i];
+  }
+
+  // The kernels directly
+  T out[N];
+
+  esl::simd::ops< T, N >::add(out, a.data(), b.data());
+  for (int i = 0; i < int(N); ++i)
+    ASSERT_EQ(ref_sum[i], out[i]);
+
+  esl::simd::ops< T, N >::sub(out, a.data(), b.data());
+  for (int i = 0; i < int(N); ++i)
+    ASSERT_EQ(ref_diff[i], out[i]);
+
+  esl::simd::ops< T, N >::mul(out, a.data(), b.data());
+  for (int i = 0; i < int(N); ++i)
+    ASSERT_EQ(ref_prod[i], out[i]);
+
+  esl::simd::ops< T, N >::scale(out, a.data(), T(3));
+  for (int i = 0; i < int(N); ++i)
+    ASSERT_EQ(ref_scaled[i], out[i]);
+
+  ASSERT_NEAR(ref_dot, (esl::simd::ops< T, N >::dot(a.data(), b.data())),
+              std::abs(ref_dot) * T(1e-6));
+
+  // Plain add, sub and scale expressions are evaluated by the kernels
+  const esl::vector< T, N > sum = a + b;
+  const esl::vector< T, N > diff = a - b;
+  const esl::vector< T, N > scaled = a * T(3);
+  const esl::vector< T, N > scaled_first = T(3) * a;
+  const auto prod = a.dot(b);
+
+  // Nested expressions are evaluated element by element
+  const esl::vector< T, N > nested = (a + b) * T(3);
+
+  // The compound assignments
+  auto inc = a;
+  inc += b;
+  auto dec = a;
+  dec -= b;
+  auto mul = a;
+  mul *= T(3);
+
+  for (int i = 0; i < int(N); ++i)
+  {
+    ASSERT_EQ(ref_sum[i], sum[i]);
+    ASSERT_EQ(ref_diff[i], diff[i]);
+    ASSERT_EQ(ref_scaled[i], scaled[i]);
+    ASSERT_EQ(ref_scaled[i], scaled_first[i]);
+    ASSERT_EQ(ref_nested[i], nested[i]);
+    ASSERT_EQ(ref_prod[i], prod[i]);
+    ASSERT_EQ(ref_sum[i], inc[i]);
+    ASSERT_EQ(ref_diff[i], dec[i]);
+    ASSERT_EQ(ref_scaled[i], mul[i]);
+  }
+
+  ASSERT_NEAR(ref_norm2, a.norm_squared(), ref_norm2 * T(1e-6));
+  ASSERT_NEAR(std::sqrt(ref_norm2), a.norm(), std::sqrt(ref_norm2) * T(1e-6));
+
+  auto n = a;
+  n.normalize();
+
+  for (int i = 0; i < int(N); ++i)
+    ASSERT_NEAR(a[i] / std::sqrt(ref_norm2), n[i], T(1e-6));
+}
+
+TEST(test_vector_simd, test_available)
+{
+#if defined(__SSE2__) || defined(_M_X64)
+  ASSERT_EQ(true, bool(esl::simd::ops< float, 3 >::available));
+  ASSERT_EQ(true, bool(esl::simd::ops< double, 8 >::available));
+#endif
+
+#if defined(__AVX__)
+  // Built for AVX, the 8 float and 4 double registers are used
+  ASSERT_EQ(true, bool(esl::simd::reg< float, 8 >::available));
+  ASSERT_EQ(true, bool(esl::simd::reg< double, 4 >::available));
+  static_assert(esl::simd::details::select_width< float, 8 >::value == 8, "");
+  static_assert(esl::simd::details::select_width< double, 7 >::value == 4, "");
+#endif
+
+  // No backend for integers or large vectors
+  ASSERT_EQ(false, bool(esl::simd::ops< int, 4 >::available));
+  ASSERT_EQ(false, bool(esl::simd::ops< float, 9 >::available));
+}
+
+TEST(test_vector_simd, test_float)
+{
+  check_ops< float, 2 >();
+  check_ops< float, 3 >();
+  check_ops< float, 4 >();
+  check_ops< float, 5 >();
+  check_ops< float, 6 >();
+  check_ops< float, 7 >();
+  check_ops< float, 8 >();
+}
+
+TEST(test_vector_simd, test_double)
+{
+  check_ops< double, 2 >();
+  check_ops< double, 3 >();
+  check_ops< double, 4 >();
+  check_ops< double, 5 >();
+  check_ops< double, 6 >();
+  check_ops< double, 7 >();
+  check_ops< double, 8 >();
+}
+
+// A 3 element vector followed by live memory
+template < typename T >
+struct guarded
+{
+  esl::vector< T, 3 > v;
+  T guard;
+};
+
+template < typename T >
+void check_padded_lanes()
+{
+  static_assert(offsetof(guarded< T >, guard) == 3 * sizeof(T),
+                "The guard must follow the vector");
+
+  guarded< T > g{{T(1), T(2), T(3)}, T(-7)};
+  const esl::vector< T, 3 > b{T(10), T(20), T(30)};
+
+  g.v += b;
+  g.v *= T(2);
+  g.v -= b;
+  g.v = g.v + b;
+
+  ASSERT_EQ(T(22), g.v[0]);
+  ASSERT_EQ(T(44), g.v[1]);
+  ASSERT_EQ(T(66), g.v[2]);
+  ASSERT_EQ(T(-7), g.guard);
+}
+
+TEST(test_vector_simd, test_padded_lanes)
+{
+  // The stores of a 3 element vector must not write past it
+  check_padded_lanes< float >();
+  check_padded_lanes< double >();
+}
+
+TEST(test_vector_simd, test_partial_aliasing)
+{
+  // Partial loads and stores of float vectors must not go through double*,
+  // with strict aliasing optimizations the element-wise reads below could
+  // otherwise see the values from before normalize
+  esl::vector3f v{-9.25f, -0.0625f, 3.5f};
+  esl::vector2f w{3.0f, 4.0f};
+
+  v.normalize();
+  w.normalize();
+
+  // A plain add of two vectors, evaluated by the add kernel
+  const esl::vector3f e = v + esl::vector3f{1, 2, 3};
+  const float n = v.norm();
+
+  ASSERT_NEAR(1.0f, n, 1e-6f);
+  ASSERT_FLOAT_EQ(v[0] + 1.0f, e[0]);
+  ASSERT_FLOAT_EQ(v[1] + 2.0f, e[1]);
+  ASSERT_FLOAT_EQ(0.6f, w[0]);
+  ASSERT_FLOAT_EQ(0.8f, w[1]);
+  ASSERT_LT(e[0], 1.0f);
+}
+
+TEST(test_vector_simd, test_scalar_fallback)
+{
+  esl::vector4i a(1, 2, 3, 4);
+  esl::vector4i b(4, 3, 2, 1);
+
+  a += b;
+
+  ASSERT_EQ(5, a[0]);
+  ASSERT_EQ(5, a[3]);
+  ASSERT_EQ(100, a.norm_squared());
+}
+
+#if !defined(ESL_CONSTEXPR_LAMBDA_AVAILABLE)
+constexpr float constexpr_norm()
+{
+  auto v = esl::vector3f(1, 2, 3);
+  v += esl::vector3f(1, 1, 1);
+
+  return v.norm_squared();
+}
+
+TEST(test_vector_simd, test_constexpr)
+{
+  // Constant evaluation uses the scalar path
+  static_assert(constexpr_norm() == 29.0f, "");
+}
+#endif
+
+int main(int argc, char *argv[])
+{
+#if defined(__AVX2__) && defined(__GNUC__)
+  // The AVX2 build of the test on a CPU without it
+  if (!__builtin_cpu_supports("avx2"))
+  {
+    std::printf("AVX2 not supported by this CPU, skipping\n");
+    return 0;
+  }
+#endif
+
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,131 @@
+//          Copyright Emil Fresk 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include <esl/parallel/work_stealing_deque.hpp>
+
+using deque = esl::work_stealing_deque< int, 8 >;
+
+TEST(test_work_stealing_deque, test_push_pop)
+{
+  deque d;
+  int v = 0;
+
+  ASSERT_EQ(true, d.empty());
+  ASSERT_EQ(false, d.pop(v));
+
+  ASSERT_EQ(true, d.push(1));
+  ASSERT_EQ(true, d.push(2));
+  ASSERT_EQ(true, d.push(3));
+  ASSERT_EQ(3, d.size());
+
+  // Owner pops LIFO
+  ASSERT_EQ(true, d.pop(v));
+  ASSERT_EQ(3, v);
+  ASSERT_EQ(true, d.pop(v));
+  ASSERT_EQ(2, v);
+  ASSERT_EQ(true, d.pop(v));
+  ASSERT_EQ(1, v);
+  ASSERT_EQ(false, d.pop(v));
+  ASSERT_EQ(true, d.empty());
+}
+
+TEST(test_work_stealing_deque, test_steal)
+{
+  deque d;
+  int v = 0;
+
+  ASSERT_EQ(false, d.steal(v));
+
+  d.push(1);
+  d.push(2);
+  d.push(3);
+
+  // Thieves steal FIFO
+  ASSERT_EQ(true, d.steal(v));
+  ASSERT_EQ(1, v);
+  ASSERT_EQ(true, d.pop(v));
+  ASSERT_EQ(3, v);
+  ASSERT_EQ(true, d.steal(v));
+  ASSERT_EQ(2, v);
+  ASSERT_EQ(false, d.steal(v));
+}
+
+TEST(test_work_stealing_deque, test_full)
+{
+  deque d;
+  int v = 0;
+
+  for (int i = 0; i < 8; ++i)
+    ASSERT_EQ(true, d.push(i));
+
+  ASSERT_EQ(false, d.push(8));
+
+  ASSERT_EQ(true, d.steal(v));
+  ASSERT_EQ(true, d.push(8));
+}
+
+TEST(test_work_stealing_deque, test_concurrent_steal)
+{
+  constexpr int num_items = 100000;
+  constexpr int num_thieves = 3;
+
+  esl::work_stealing_deque< int, 256 > d;
+  std::atomic< long > sum{0};
+  std::atomic< int > taken{0};
+  std::vector< std::thread > thieves;
+
+  for (int t = 0; t < num_thieves; ++t)
+  {
+    thieves.emplace_back([&] {
+      int v;
+
+      while (taken.load() < num_items)
+      {
+        if (d.steal(v))
+        {
+          sum += v;
+          ++taken;
+        }
+      }
+    });
+  }
+
+  int v;
+
+  for (int i = 1; i <= num_items; ++i)
+  {
+    while (!d.push(i))
+    {
+      if (d.pop(v))
+      {
+        sum += v;
+        ++taken;
+      }
+    }
+  }
+
+  while (d.pop(v))
+  {
+    sum += v;
+    ++taken;
+  }
+
+  for (auto& t : thieves)
+    t.join();
+
+  // Every item is taken exactly once
+  ASSERT_EQ(num_items, taken.load());
+  ASSERT_EQ(static_cast< long >(num_items) * (num_items + 1) / 2, sum.load());
+}
+
+int main(int argc, char *argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}